@@ -34,6 +34,11 @@
 #include <kdl/overload.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
 
 #include "BenchmarkUtils.h"
 #include "../../test/src/Catch2.h"
@@ -42,8 +47,8 @@ namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
     using BOX = AABB::Box;
 
-    TEST_CASE("AABBTreeBenchmark.benchBuildTree", "[AABBTreeBenchmark]") {
-        const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+    static std::unique_ptr<Model::WorldNode> loadMap(const IO::Path& path) {
+        const auto mapPath = IO::Disk::getCurrentWorkingDir() + path;
         const auto file = IO::Disk::openFile(mapPath);
         auto fileReader = file->reader().buffer();
 
@@ -51,19 +56,107 @@ namespace TrenchBroom {
         IO::WorldReader worldReader(fileReader.stringView(), Model::MapFormat::Standard);
 
         const vm::bbox3 worldBounds(8192.0);
-        auto world = worldReader.read(worldBounds, status);
+        return worldReader.read(worldBounds, status);
+    }
+
+    static void buildTree(Model::WorldNode& world, AABB& tree) {
+        world.accept(kdl::overload(
+            [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+            [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); tree.insert(entity->physicalBounds(), entity); },
+            [&](Model::BrushNode* brush)                      { tree.insert(brush->physicalBounds(), brush); }
+        ));
+    }
+
+    TEST_CASE("AABBTreeBenchmark.benchBuildTree", "[AABBTreeBenchmark]") {
+        auto world = loadMap(IO::Path("fixture/benchmark/AABBTree/ne_ruins.map"));
 
         std::vector<AABB> trees(100);
         timeLambda([&world, &trees]() {
             for (auto& tree : trees) {
-                world->accept(kdl::overload(
-                    [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); tree.insert(entity->physicalBounds(), entity); },
-                    [&](Model::BrushNode* brush)                      { tree.insert(brush->physicalBounds(), brush); }
-                ));
+                buildTree(*world, tree);
             }
         }, "Add objects to AABB tree");
+
+        const auto nodes = trees.front().findIntersectors(trees.front().bounds());
+        const auto getBounds = [](const Model::Node* node) { return node->physicalBounds(); };
+        timeLambda([&]() {
+            for (auto& tree : trees) {
+                tree.clearAndBuild(nodes, getBounds);
+            }
+        }, "Bulk build AABB tree");
+
+        timeLambda([&]() {
+            for (auto& tree : trees) {
+                tree.refit(nodes, getBounds);
+            }
+        }, "Refit AABB tree");
+    }
+
+    TEST_CASE("AABBTreeBenchmark.benchQueryTree", "[AABBTreeBenchmark]") {
+        auto world = loadMap(IO::Path("fixture/benchmark/AABBTree/ne_ruins.map"));
+
+        AABB tree;
+        buildTree(*world, tree);
+
+        // use the centers of the leaf bounds as query points, and cast rays from them in all axis directions
+        auto points = std::vector<vm::vec3>{};
+        for (auto* node : tree.findIntersectors(tree.bounds())) {
+            points.push_back(node->physicalBounds().center());
+        }
+
+        const auto directions = std::vector<vm::vec3>{
+            vm::vec3::pos_x(), vm::vec3::neg_x(),
+            vm::vec3::pos_y(), vm::vec3::neg_y(),
+            vm::vec3::pos_z(), vm::vec3::neg_z()
+        };
+
+        tree.insert(BOX(vm::vec3::fill(-1.0), vm::vec3::fill(1.0)), world.get());
+        timeLambda([&]() {
+            tree.findContainers(vm::vec3::zero());
+        }, "Rebuild compact AABB tree after insertion");
+
+        auto count = size_t(0);
+        timeLambda([&]() {
+            for (size_t i = 0u; i < 10u; ++i) {
+                for (const auto& point : points) {
+                    for (const auto& direction : directions) {
+                        count += tree.findIntersectors(vm::ray3(point, direction)).size();
+                    }
+                }
+            }
+        }, "Find ray intersectors in AABB tree");
+
+        timeLambda([&]() {
+            for (size_t i = 0u; i < 10u; ++i) {
+                for (const auto& point : points) {
+                    for (const auto& direction : directions) {
+                        tree.findIntersectorsByDistance(vm::ray3(point, direction), [&](const auto*, const auto) {
+                            ++count;
+                            return true;
+                        });
+                    }
+                }
+            }
+        }, "Find ray intersectors in AABB tree ordered by distance");
+
+        timeLambda([&]() {
+            for (size_t i = 0u; i < 100u; ++i) {
+                for (const auto& point : points) {
+                    count += tree.findContainers(point).size();
+                }
+            }
+        }, "Find containers in AABB tree");
+
+        timeLambda([&]() {
+            for (size_t i = 0u; i < 10u; ++i) {
+                for (const auto& point : points) {
+                    count += tree.findIntersectors(BOX(point - vm::vec3::fill(64.0), point + vm::vec3::fill(64.0))).size();
+                }
+            }
+        }, "Find box intersectors in AABB tree");
+
+        CHECK(count > 0u);
     }
 }
@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/Reader.h"
+#include "Renderer/GL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        // roughly the size of a large Quake WAD file
+        static constexpr size_t NumTextures = 2048;
+        static constexpr size_t TextureSize = 128;
+        static constexpr size_t MipLevels = 4;
+
+        static std::vector<unsigned char> makeRandomBytes(const size_t count) {
+            auto rng = std::mt19937(42);
+            auto dist = std::uniform_int_distribution<int>(0, 255);
+
+            auto result = std::vector<unsigned char>(count);
+            for (auto& byte : result) {
+                byte = static_cast<unsigned char>(dist(rng));
+            }
+            return result;
+        }
+
+        TEST_CASE("TextureConversionBenchmark.indexedToRgba", "[TextureConversionBenchmark]") {
+            const auto palette = Palette(makeRandomBytes(768));
+
+            auto mipSizes = std::vector<size_t>{};
+            auto texturePixelCount = size_t(0);
+            for (size_t level = 0; level < MipLevels; ++level) {
+                const auto mipSize = sizeAtMipLevel(TextureSize, TextureSize, level);
+                mipSizes.push_back(mipSize.x() * mipSize.y());
+                texturePixelCount += mipSizes.back();
+            }
+
+            const auto indices = makeRandomBytes(NumTextures * texturePixelCount);
+            const auto* begin = reinterpret_cast<const char*>(indices.data());
+            auto reader = IO::Reader::from(begin, begin + indices.size()).buffer();
+
+            auto transparentCount = size_t(0);
+            const auto start = std::chrono::high_resolution_clock::now();
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumTextures; ++i) {
+                    for (const auto pixelCount : mipSizes) {
+                        auto rgbaImage = TextureBuffer(4 * pixelCount);
+                        auto averageColor = Color();
+                        if (palette.indexedToRgba(reader, pixelCount, rgbaImage, PaletteTransparency::Index255Transparent, averageColor)) {
+                            ++transparentCount;
+                        }
+                    }
+                }
+            }, "Convert indexed textures");
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto megapixels = static_cast<double>(indices.size()) / (1000.0 * 1000.0);
+            printf("Convert indexed textures throughput: %fMP/s\n", megapixels / std::chrono::duration<double>(end - start).count());
+
+            CHECK(transparentCount > 0u);
+        }
+
+        TEST_CASE("TextureConversionBenchmark.generateMips", "[TextureConversionBenchmark]") {
+            const auto pixels = makeRandomBytes(4 * TextureSize * TextureSize);
+
+            auto mipCount = size_t(0);
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumTextures; ++i) {
+                    auto buffer = TextureBuffer(pixels.size());
+                    std::copy(std::begin(pixels), std::end(pixels), buffer.data());
+
+                    const auto texture = Texture("texture", TextureSize, TextureSize, Color(), std::move(buffer), GL_RGBA, TextureType::Opaque);
+                    mipCount += texture.buffersIfUnprepared().size();
+                }
+            }, "Generate mipmaps");
+
+            CHECK(mipCount == NumTextures * 8u);
+        }
+    }
+}
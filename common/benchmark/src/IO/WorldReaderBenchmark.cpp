@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST_CASE("WorldReaderBenchmark.benchReadMap", "[WorldReaderBenchmark]") {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+            const auto str = fileReader.stringView();
+
+            const vm::bbox3 worldBounds(8192.0);
+            const auto iterations = size_t(10);
+
+            auto nodeCount = size_t(0);
+            const auto start = std::chrono::high_resolution_clock::now();
+            timeLambda([&]() {
+                for (size_t i = 0u; i < iterations; ++i) {
+                    TestParserStatus status;
+                    WorldReader worldReader(str, Model::MapFormat::Standard);
+
+                    auto world = worldReader.read(worldBounds, status);
+                    nodeCount += world->descendantCount();
+                }
+            }, "Read map");
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto megabytes = static_cast<double>(str.size() * iterations) / (1024.0 * 1024.0);
+            printf("Read map throughput: %fMB/s\n", megabytes / std::chrono::duration<double>(end - start).count());
+
+            CHECK(nodeCount > 0u);
+        }
+    }
+}
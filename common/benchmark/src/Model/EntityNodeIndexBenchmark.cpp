@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityNodeIndex.h"
+#include "Model/EntityProperties.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumEntities = 20'000;
+        static constexpr size_t ChainLength = 8;
+
+        static std::string targetname(const size_t i) {
+            return "relay_" + std::to_string(i);
+        }
+
+        /**
+         * Creates entities that are linked in chains of ChainLength entities each. Every entity targets the next one in
+         * its chain, and every other entity additionally kills the entity after the next one, as in the logic of a
+         * typical Quake map.
+         */
+        static std::vector<Node*> makeLinkedEntities() {
+            std::vector<Node*> result;
+            result.reserve(NumEntities);
+
+            for (size_t i = 0u; i < NumEntities; ++i) {
+                auto properties = std::vector<EntityProperty>{
+                    {PropertyKeys::Classname, "trigger_relay"},
+                    {PropertyKeys::Origin, std::to_string(i % 1024u) + " " + std::to_string(i / 1024u) + " 0"},
+                    {PropertyKeys::Targetname, targetname(i)}
+                };
+
+                if ((i + 1u) % ChainLength != 0u) {
+                    properties.emplace_back(PropertyKeys::Target, targetname(i + 1u));
+                }
+                if (i % 2u == 0u && (i + 2u) % ChainLength > 1u) {
+                    properties.emplace_back(PropertyKeys::Killtarget, targetname(i + 2u));
+                }
+
+                result.push_back(new EntityNode(Entity(std::move(properties))));
+            }
+
+            return result;
+        }
+
+        TEST_CASE("EntityNodeIndexBenchmark.addLinkedEntities", "[EntityNodeIndexBenchmark]") {
+            auto world = std::make_unique<WorldNode>(Entity(), MapFormat::Standard);
+            auto entities = makeLinkedEntities();
+            timeLambda([&]() {
+                world->defaultLayer()->addChildren(entities);
+            }, "Add linked entities to world");
+
+            auto batchedWorld = std::make_unique<WorldNode>(Entity(), MapFormat::Standard);
+            auto batchedEntities = makeLinkedEntities();
+            timeLambda([&]() {
+                batchedWorld->beginEntityNodeIndexBatch();
+                batchedWorld->defaultLayer()->addChildren(batchedEntities);
+                batchedWorld->endEntityNodeIndexBatch();
+            }, "Add linked entities to world in an index batch");
+
+            CHECK(world->entityNodeIndex().allKeys() == batchedWorld->entityNodeIndex().allKeys());
+        }
+
+        TEST_CASE("EntityNodeIndexBenchmark.findLinkedEntities", "[EntityNodeIndexBenchmark]") {
+            auto world = std::make_unique<WorldNode>(Entity(), MapFormat::Standard);
+            world->defaultLayer()->addChildren(makeLinkedEntities());
+
+            const auto& index = world->entityNodeIndex();
+            size_t count = 0u;
+
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumEntities; ++i) {
+                    count += index.findEntityNodes(EntityNodeIndexQuery::exact(PropertyKeys::Targetname), targetname(i)).size();
+                }
+            }, "Find link targets");
+
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumEntities; ++i) {
+                    count += index.findEntityNodes(EntityNodeIndexQuery::numbered(PropertyKeys::Target), targetname(i)).size();
+                    count += index.findEntityNodes(EntityNodeIndexQuery::exact(PropertyKeys::Killtarget), targetname(i)).size();
+                }
+            }, "Find link sources");
+
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumEntities; ++i) {
+                    count += index.findEntityNodes(EntityNodeIndexQuery::exact(PropertyKeys::Targetname), "missing_" + std::to_string(i)).size();
+                }
+            }, "Find missing link targets");
+
+            CHECK(count > NumEntities);
+        }
+    }
+}
@@ -26,6 +26,7 @@
 #include "Model/MapFormat.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
 
 #include <kdl/result.h>
 
@@ -129,6 +130,37 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+
+        TEST_CASE("BrushRendererBenchmark.benchRevalidateAll", "[BrushRendererBenchmark]") {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            BrushRenderer r;
+            r.addBrushes(brushes);
+            r.validate();
+
+            // this is what happens when hidden brushes are shown or the transparency changes
+            timeLambda([&](){ r.invalidate(); }, "invalidate " + std::to_string(brushes.size()) + " brushes");
+            timeLambda([&](){
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "validate " + std::to_string(brushes.size()) + " invalidated brushes");
+
+            // the vertex caches must be rebuilt when the brushes or their textures have changed
+            for (auto* brush : brushes) {
+                brush->brushRendererBrushCache().invalidateVertexCache();
+            }
+            r.invalidate();
+            timeLambda([&](){
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "validate " + std::to_string(brushes.size()) + " invalidated brushes without vertex caches");
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
-
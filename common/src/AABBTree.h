@@ -24,17 +24,32 @@
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <future>
 #include <iosfwd>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
 /**
- * An axis aligned bounding box tree that allows for quick ray intersection queries.
+ * An axis aligned bounding box tree that allows for quick ray, point, box and convex volume queries.
+ *
+ * The tree is maintained as a dynamic tree of individually allocated nodes, which makes insertions and removals cheap.
+ * Queries don't use the dynamic tree directly, but a compact copy of it where all nodes are stored contiguously in
+ * depth first order. This copy is created lazily by the first query after the tree was modified.
  *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
@@ -45,6 +60,7 @@ namespace TrenchBroom {
     public:
         using List = std::vector<U>;
         using Box = vm::bbox<T,S>;
+        using Plane = vm::plane<T,S>;
         using DataType = U;
         using FloatType = T;
         static constexpr size_t Components = S;
@@ -89,10 +105,15 @@ namespace TrenchBroom {
         public:
             Box m_bounds;
             InnerNode* m_parent;
+            /**
+             * The index of this node in the compact form of the tree, valid while the compact form is valid.
+             */
+            mutable std::uint32_t m_flatIndex;
         protected:
             explicit Node(const Box& bounds) :
                 m_bounds(bounds),
-                m_parent(nullptr) {}
+                m_parent(nullptr),
+                m_flatIndex(0u) {}
         public:
             virtual ~Node() = default;
 
@@ -263,6 +284,41 @@ namespace TrenchBroom {
                 return newTreeRoot;
             }
 
+        public:
+            /**
+             * Detaches the given child of this node so that it is not deleted along with this node.
+             *
+             * @param child the child to detach
+             */
+            void releaseChild(const Node* child) {
+                if (m_left == child) {
+                    m_left = nullptr;
+                } else if (m_right == child) {
+                    m_right = nullptr;
+                }
+            }
+
+            /**
+             * Recomputes the bounds of this node from the bounds of its children after the bounds of a leaf in its subtree
+             * were changed in place.
+             */
+            void refitBounds() {
+                updateBounds();
+            }
+
+            /**
+             * Returns the left child of this node.
+             */
+            const Node* left() const {
+                return m_left;
+            }
+
+            /**
+             * Returns the right child of this node.
+             */
+            const Node* right() const {
+                return m_right;
+            }
         public: // Node overrides
             ~InnerNode() override {
                 delete m_left;
@@ -395,6 +451,15 @@ namespace TrenchBroom {
         public:
             LeafNode(const Box& bounds, const U& data) : Node(bounds), m_data(data) {}
 
+            /**
+             * Changes the bounds of this leaf in place. The bounds of all ancestors must be refitted afterwards.
+             *
+             * @param bounds the new bounds
+             */
+            void refitBounds(const Box& bounds) {
+                this->setBounds(bounds);
+            }
+
             /**
              * Deletes this. Returns the new root of the tree.
              */
@@ -461,11 +526,67 @@ namespace TrenchBroom {
                 assert(this->m_parent == expectedParent);
             }
         };
+        /**
+         * A node of the compact, read only form of this tree. The nodes are stored in depth first order, so the left child
+         * of an inner node at index i is at index i + 1, and every node stores the index of the first node following its
+         * subtree. A query that rejects a node can therefore continue at that index without maintaining a stack.
+         *
+         * The bounds are stored in single precision and are rounded outwards, so they always contain the original bounds.
+         * Leafs additionally refer to a FlatLeaf which holds the exact bounds and the data.
+         */
+        struct FlatNode {
+            vm::bbox<float,S> bounds;
+            std::uint32_t skipIndex;
+            std::uint32_t leafIndex;
+        };
+
+        struct FlatLeaf {
+            Box bounds;
+            U data;
+        };
+
+        static constexpr auto NoLeaf = std::numeric_limits<std::uint32_t>::max();
     private:
         Node* m_root;
         std::unordered_map<U, LeafNode*> m_leafForData;
+
+        /**
+         * The SAH cost of this tree when it was last built, and the change of the cost caused by refitting since then.
+         * The actual cost is only computed again once the estimated cost exceeds m_nextCostCheck. See refit().
+         */
+        T m_referenceCost;
+        T m_refitCostDelta;
+        T m_nextCostCheck;
+        bool m_referenceCostValid;
+
+        /**
+         * The compact form of this tree. It is rebuilt lazily by the first query after the structure of the tree has
+         * changed, and patched in place when the tree is refitted.
+         */
+        mutable std::vector<FlatNode> m_flatNodes;
+        mutable std::vector<FlatLeaf> m_flatLeafs;
+        mutable std::atomic<bool> m_flatTreeValid;
+        mutable std::mutex m_flatTreeMutex;
     public:
-        AABBTree() : m_root(nullptr) {}
+        /**
+         * If refitting increases the SAH cost of this tree by more than this factor, the tree is rebuilt.
+         */
+        static constexpr T RebuildThreshold = T(1.5);
+
+        /**
+         * If the actual SAH cost of this tree was computed and found to be below the rebuild threshold, it is only
+         * computed again after refitting has changed the estimated cost by this fraction of the reference cost. This
+         * keeps repeated refits from computing the cost of the entire tree every time.
+         */
+        static constexpr T CostCheckInterval = T(0.1);
+
+        AABBTree() :
+        m_root(nullptr),
+        m_referenceCost(0),
+        m_refitCostDelta(0),
+        m_nextCostCheck(0),
+        m_referenceCostValid(false),
+        m_flatTreeValid(false) {}
 
         ~AABBTree() {
             clear();
@@ -483,17 +604,138 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * The tree is built top down by recursively splitting the objects such that the surface area heuristic (SAH) is
+         * minimized. This yields a much better tree than inserting the objects one by one. Large subtrees are built on
+         * separate threads.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates, or if the bounds of any object contains NaN;
+         * the tree is empty in that case
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
+
+            auto items = std::vector<BuildItem>{};
             for (const U& object : objects) {
-                insert(getBounds(object), object);
+                const Box bounds = getBounds(object);
+                items.push_back(BuildItem{ bounds, bounds.center(), nullptr });
+            }
+
+            auto it = std::begin(objects);
+            for (auto& item : items) {
+                const U& object = *it++;
+                if (vm::is_nan(item.bounds.min) || vm::is_nan(item.bounds.max) || m_leafForData.count(object) > 0u) {
+                    for (auto& createdItem : items) {
+                        delete createdItem.leaf;
+                    }
+                    m_leafForData.clear();
+
+                    check(item.bounds);
+                    throw NodeTreeException("Data already in tree");
+                }
+
+                item.leaf = new LeafNode(item.bounds, object);
+                m_leafForData[object] = item.leaf;
+            }
+
+            buildFromItems(items);
+        }
+
+        /**
+         * Updates the bounds of the given objects in place without restructuring the tree. The bounds of the leafs
+         * representing the given objects are replaced, and the bounds of their ancestors are recomputed. This is much
+         * cheaper than removing and reinserting every object, but it can degrade the quality of the tree if the objects
+         * move far.
+         *
+         * The quality of the tree is measured using the SAH cost of the tree, which is the sum of the surface areas of
+         * its inner nodes. If refitting increases this cost by more than RebuildThreshold compared to the cost after the
+         * last build, the entire tree is rebuilt using clearAndBuild.
+         *
+         * The change of the cost is tracked incrementally using the nodes whose bounds are refitted, so refitting only
+         * costs time proportional to the number of refitted nodes and their depth. The cost of the entire tree is only
+         * computed if the estimated cost exceeds the rebuild threshold, and since the estimate ignores inserts and
+         * removals, the actual cost is checked before the tree is rebuilt. Pass all objects that moved at once.
+         *
+         * @param objects the objects whose bounds changed, a list of DataType
+         * @param getBounds a function from DataType -> Box to compute the new bounds of each object
+         *
+         * @throws NodeTreeException if any of the given objects is not in this tree, or if any of the new bounds contains
+         * NaN
+         */
+        template <typename DataList, typename GetBounds>
+        void refit(const DataList& objects, GetBounds&& getBounds) {
+            if (!m_referenceCostValid) {
+                resetReferenceCost();
+            }
+
+            // the structure of the tree doesn't change, so the compact form can be patched in place if it is valid
+            const auto patchFlatTree = m_flatTreeValid.load(std::memory_order_acquire);
+
+            for (const U& object : objects) {
+                auto it = m_leafForData.find(object);
+                if (it == m_leafForData.end()) {
+                    throw NodeTreeException("AABB node not found");
+                }
+
+                const Box bounds = getBounds(object);
+                check(bounds);
+
+                LeafNode* leaf = it->second;
+                leaf->refitBounds(bounds);
+                if (patchFlatTree) {
+                    auto& flatNode = m_flatNodes[leaf->m_flatIndex];
+                    flatNode.bounds = toFlatBounds(bounds);
+                    m_flatLeafs[flatNode.leafIndex].bounds = bounds;
+                }
+
+                for (auto* node = leaf->m_parent; node != nullptr; node = node->m_parent) {
+                    const auto oldBounds = node->bounds();
+                    node->refitBounds();
+                    if (node->bounds() == oldBounds) {
+                        break;
+                    }
+                    if (patchFlatTree) {
+                        m_flatNodes[node->m_flatIndex].bounds = toFlatBounds(node->bounds());
+                    }
+                    m_refitCostDelta += halfSurfaceArea(node->bounds()) - halfSurfaceArea(oldBounds);
+                }
             }
+
+            if (m_referenceCost + m_refitCostDelta > m_nextCostCheck) {
+                // the accumulated delta is only an estimate if inserts or removals happened in between, so check the
+                // actual cost before rebuilding
+                const auto cost = sahCost();
+                if (cost > RebuildThreshold * m_referenceCost) {
+                    rebuild();
+                } else {
+                    m_refitCostDelta = cost - m_referenceCost;
+                    m_nextCostCheck = std::max(RebuildThreshold * m_referenceCost, cost + CostCheckInterval * m_referenceCost);
+                }
+            }
+        }
+
+        /**
+         * Returns the SAH cost of this tree, which is the sum of the (half) surface areas of its inner nodes. A lower cost
+         * indicates a tree that can be queried more efficiently.
+         */
+        T sahCost() const {
+            auto cost = T(0);
+            if (!empty()) {
+                LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        cost += halfSurfaceArea(innerNode->bounds());
+                        return true;
+                    },
+                    [](const LeafNode*) {}
+                );
+                m_root->accept(visitor);
+            }
+            return cost;
         }
 
         /**
@@ -512,6 +754,8 @@ namespace TrenchBroom {
                 throw NodeTreeException("Data already in tree");
             }
 
+            invalidateFlatTree();
+
             if (empty()) {
                 auto* insertedLeafNode = new LeafNode(bounds, data);
 
@@ -540,6 +784,7 @@ namespace TrenchBroom {
             LeafNode* leaf = it->second;
             assert(leaf->data() == data);
             m_leafForData.erase(it);
+            invalidateFlatTree();
 
             m_root = leaf->deleteThis();
 
@@ -563,6 +808,202 @@ namespace TrenchBroom {
             insert(newBounds, data);
         }
     private:
+        struct BuildItem {
+            Box bounds;
+            vm::vec<T,S> center;
+            LeafNode* leaf;
+        };
+
+        /**
+         * Subtrees with at least this many leafs are built on a separate thread.
+         */
+        static constexpr size_t ParallelBuildThreshold = 4096u;
+
+        /**
+         * The number of bins used to evaluate candidate split positions.
+         */
+        static constexpr size_t BinCount = 16u;
+
+        /**
+         * Rebuilds this tree from its current leafs.
+         */
+        void rebuild() {
+            auto items = std::vector<BuildItem>{};
+            items.reserve(m_leafForData.size());
+            for (const auto& [data, leaf] : m_leafForData) {
+                items.push_back(BuildItem{ leaf->bounds(), leaf->bounds().center(), leaf });
+            }
+
+            // detach the leafs so that deleting the inner nodes doesn't delete them
+            for (auto& item : items) {
+                if (item.leaf->m_parent != nullptr) {
+                    item.leaf->m_parent->releaseChild(item.leaf);
+                }
+            }
+            if (items.size() > 1u) {
+                delete m_root;
+            }
+            m_root = nullptr;
+
+            buildFromItems(items);
+        }
+
+        void buildFromItems(std::vector<BuildItem>& items) {
+            if (!items.empty()) {
+                auto threadCount = static_cast<size_t>(std::thread::hardware_concurrency());
+                auto parallelDepth = size_t(0);
+                while (threadCount > 1u) {
+                    threadCount /= 2u;
+                    ++parallelDepth;
+                }
+
+                m_root = buildSubtree(items.data(), items.data() + items.size(), parallelDepth);
+                m_root->m_parent = nullptr;
+            }
+
+            invalidateFlatTree();
+            resetReferenceCost();
+        }
+
+        void resetReferenceCost() {
+            m_referenceCost = sahCost();
+            m_refitCostDelta = T(0);
+            m_nextCostCheck = RebuildThreshold * m_referenceCost;
+            m_referenceCostValid = true;
+        }
+
+        /**
+         * Builds a subtree containing the leafs of the given items by recursively partitioning them using a binned SAH
+         * split along the axis in which the centers of the items vary the most.
+         *
+         * @param first the first item
+         * @param last the item after the last item
+         * @param parallelDepth the number of recursion levels on which subtrees can be built on separate threads
+         * @return the root of the subtree
+         */
+        static Node* buildSubtree(BuildItem* first, BuildItem* last, const size_t parallelDepth) {
+            const auto count = static_cast<size_t>(last - first);
+            assert(count > 0u);
+
+            if (count == 1u) {
+                return first->leaf;
+            }
+
+            auto* mid = partitionItems(first, last);
+
+            Node* left;
+            Node* right;
+            if (parallelDepth > 0u && count >= ParallelBuildThreshold) {
+                auto future = std::async(std::launch::async, [&]() { return buildSubtree(first, mid, parallelDepth - 1u); });
+                right = buildSubtree(mid, last, parallelDepth - 1u);
+                left = future.get();
+            } else {
+                left = buildSubtree(first, mid, 0u);
+                right = buildSubtree(mid, last, 0u);
+            }
+
+            return new InnerNode(left, right);
+        }
+
+        /**
+         * Partitions the given items into two non-empty ranges such that the SAH cost of the split is minimal among the
+         * evaluated candidates.
+         *
+         * @return the first item of the second range
+         */
+        static BuildItem* partitionItems(BuildItem* first, BuildItem* last) {
+            const auto count = static_cast<size_t>(last - first);
+
+            auto centerMin = first->center;
+            auto centerMax = first->center;
+            for (auto* item = first + 1; item != last; ++item) {
+                centerMin = vm::min(centerMin, item->center);
+                centerMax = vm::max(centerMax, item->center);
+            }
+
+            size_t axis = 0u;
+            for (size_t i = 1u; i < S; ++i) {
+                if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis]) {
+                    axis = i;
+                }
+            }
+
+            const auto extent = centerMax[axis] - centerMin[axis];
+            if (extent > T(0)) {
+                const auto binOf = [&](const BuildItem& item) {
+                    const auto bin = static_cast<size_t>((item.center[axis] - centerMin[axis]) / extent * static_cast<T>(BinCount));
+                    return std::min(bin, BinCount - 1u);
+                };
+
+                std::array<Box, BinCount> binBounds;
+                std::array<size_t, BinCount> binCounts{};
+                for (auto* item = first; item != last; ++item) {
+                    const auto bin = binOf(*item);
+                    binBounds[bin] = binCounts[bin] == 0u ? item->bounds : vm::merge(binBounds[bin], item->bounds);
+                    ++binCounts[bin];
+                }
+
+                // the cost of the right side of every split position, computed by sweeping from the right
+                std::array<T, BinCount> rightCosts{};
+                auto rightBounds = Box();
+                auto rightCount = size_t(0);
+                for (size_t i = BinCount - 1u; i > 0u; --i) {
+                    if (binCounts[i] > 0u) {
+                        rightBounds = rightCount == 0u ? binBounds[i] : vm::merge(rightBounds, binBounds[i]);
+                        rightCount += binCounts[i];
+                    }
+                    rightCosts[i] = rightCount == 0u ? T(0) : halfSurfaceArea(rightBounds) * static_cast<T>(rightCount);
+                }
+
+                auto bestSplit = size_t(0);
+                auto bestCost = std::numeric_limits<T>::max();
+                auto leftBounds = Box();
+                auto leftCount = size_t(0);
+                for (size_t i = 1u; i < BinCount; ++i) {
+                    if (binCounts[i - 1u] > 0u) {
+                        leftBounds = leftCount == 0u ? binBounds[i - 1u] : vm::merge(leftBounds, binBounds[i - 1u]);
+                        leftCount += binCounts[i - 1u];
+                    }
+                    if (leftCount > 0u && leftCount < count) {
+                        const auto cost = halfSurfaceArea(leftBounds) * static_cast<T>(leftCount) + rightCosts[i];
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestSplit = i;
+                        }
+                    }
+                }
+
+                if (bestSplit > 0u) {
+                    return std::partition(first, last, [&](const BuildItem& item) { return binOf(item) < bestSplit; });
+                }
+            }
+
+            // all centers are (nearly) identical, so just split the items in half
+            auto* mid = first + count / 2u;
+            std::nth_element(first, mid, last, [&](const BuildItem& lhs, const BuildItem& rhs) {
+                return lhs.center[axis] < rhs.center[axis];
+            });
+            return mid;
+        }
+
+        /**
+         * Returns half of the surface area of the given box, which is sufficient to compare SAH costs.
+         */
+        static T halfSurfaceArea(const Box& bounds) {
+            const auto size = bounds.size();
+            auto result = T(0);
+            for (size_t i = 0u; i < S; ++i) {
+                auto product = T(1);
+                for (size_t j = 0u; j < S; ++j) {
+                    if (j != i) {
+                        product *= size[j];
+                    }
+                }
+                result += product;
+            }
+            return result;
+        }
+
         void check(const Box& bounds) const {
             if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max)) {
                 throw NodeTreeException("Cannot add node to AABB tree with invalid bounds");
@@ -577,6 +1018,9 @@ namespace TrenchBroom {
                 delete m_root;
                 m_root = nullptr;
             }
+            m_leafForData.clear();
+            invalidateFlatTree();
+            m_referenceCostValid = false;
         }
 
         /**
@@ -635,23 +1079,83 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-            if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
-                            ++out;
-                        }
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+                },
+                [&](const FlatLeaf& leaf) {
+                    out = leaf.data;
+                    ++out;
+                }
+            );
+        }
+
+        /**
+         * Visits every data item in this tree whose bounding box intersects with the given ray in the order of increasing
+         * entry distance, that is, the distance from the ray origin to the point where the ray enters the bounding box.
+         * If the ray origin is contained in a bounding box, its entry distance is 0.
+         *
+         * The given visitor is called with each data item and its entry distance, and it must return a boolean value
+         * indicating whether the traversal should continue. This allows the caller to stop the traversal as soon as the
+         * entry distance exceeds the distance of the closest hit found so far.
+         *
+         * The traversal uses a priority queue ordered by entry distance, so only the subtrees whose bounds the ray enters
+         * before the traversal is stopped are ever examined. Since the bounds of inner nodes are rounded outwards in the
+         * compact form of this tree, their entry distances are lower bounds of the entry distances of their leafs, which
+         * keeps the order of the visited leafs intact.
+         *
+         * @tparam F the type of the visitor, must be a function (const U&, T) -> bool
+         * @param ray the ray to test
+         * @param visitor the visitor to call for each found data item
+         */
+        template <typename F>
+        void findIntersectorsByDistance(const vm::ray<T,S>& ray, F&& visitor) const {
+            validateFlatTree();
+
+            if (m_flatNodes.empty()) {
+                return;
+            }
+
+            using Entry = std::pair<T, std::uint32_t>;
+            const auto compare = [](const Entry& lhs, const Entry& rhs) { return lhs.first > rhs.first; };
+            std::priority_queue<Entry, std::vector<Entry>, decltype(compare)> queue(compare);
+
+            const auto enqueue = [&](const std::uint32_t index) {
+                const auto& node = m_flatNodes[index];
+                const auto distance = node.leafIndex != NoLeaf
+                    ? entryDistance(ray, m_flatLeafs[node.leafIndex].bounds)
+                    : entryDistance(ray, Box(node.bounds));
+                if (!vm::is_nan(distance)) {
+                    queue.emplace(distance, index);
+                }
+            };
+
+            enqueue(0u);
+            while (!queue.empty()) {
+                const auto [distance, index] = queue.top();
+                queue.pop();
+
+                const auto& node = m_flatNodes[index];
+                if (node.leafIndex != NoLeaf) {
+                    if (!visitor(m_flatLeafs[node.leafIndex].data, distance)) {
+                        return;
                     }
-                );
-                m_root->accept(visitor);
+                } else {
+                    // the left child directly follows its parent, and the right child follows the left child's subtree
+                    enqueue(index + 1u);
+                    enqueue(m_flatNodes[index + 1u].skipIndex);
+                }
             }
         }
-
+    private:
+        /**
+         * Returns the distance from the origin of the given ray to the point where it enters the given box, 0 if the box
+         * contains the ray origin, or NaN if the ray does not hit the box.
+         */
+        static T entryDistance(const vm::ray<T,S>& ray, const Box& box) {
+            return box.contains(ray.origin) ? T(0) : vm::intersect_ray_bbox(ray, box);
+        }
+    public:
         /**
          * Finds every data item in this tree whose bounding box contains the given point and returns a list of those items.
          *
@@ -674,22 +1178,302 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return bounds.contains(point);
+                },
+                [&](const FlatLeaf& leaf) {
+                    out = leaf.data;
+                    ++out;
+                }
+            );
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and returns a list of
+         * those items. Boxes that only touch the given box are considered to intersect it.
+         *
+         * @param box the box to test
+         * @return a list containing all found data items
+         */
+        List findIntersectors(const Box& box) const {
+            List result;
+            findIntersectors(box, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and appends it to the given
+         * output iterator. Boxes that only touch the given box are considered to intersect it.
+         *
+         * @tparam O the output iterator type
+         * @param box the box to test
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const Box& box, O out) const {
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return bounds.intersects(box);
+                },
+                [&](const FlatLeaf& leaf) {
+                    out = leaf.data;
+                    ++out;
+                }
+            );
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box is contained in the given box and returns a list of those
+         * items.
+         *
+         * @param box the containing box
+         * @return a list containing all found data items
+         */
+        List findContainedBy(const Box& box) const {
+            List result;
+            findContainedBy(box, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box is contained in the given box and appends it to the given
+         * output iterator.
+         *
+         * @tparam O the output iterator type
+         * @param box the containing box
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findContainedBy(const Box& box, O out) const {
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return bounds.intersects(box);
+                },
+                [&](const FlatLeaf& leaf) {
+                    if (box.contains(leaf.bounds)) {
+                        out = leaf.data;
+                        ++out;
+                    }
+                }
+            );
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box is not contained in the given box and returns a list of
+         * those items.
+         *
+         * @param box the containing box
+         * @return a list containing all found data items
+         */
+        List findNotContainedBy(const Box& box) const {
+            List result;
+            findNotContainedBy(box, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box is not contained in the given box and appends it to the
+         * given output iterator. Subtrees whose bounds are contained in the given box are skipped, so the cost of this
+         * query depends on the number of items found rather than on the number of items in this tree.
+         *
+         * @tparam O the output iterator type
+         * @param box the containing box
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findNotContainedBy(const Box& box, O out) const {
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return !box.contains(bounds);
+                },
+                [&](const FlatLeaf& leaf) {
+                    out = leaf.data;
+                    ++out;
+                }
+            );
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the convex volume bounded by the given
+         * planes and returns a list of those items. The plane normals must point out of the volume, which is the case
+         * for the planes returned by Renderer::Camera::frustumPlanes.
+         *
+         * The test is conservative: a bounding box is only rejected if it lies entirely above one of the planes, so
+         * some boxes near the corners of the volume may be returned even though they don't intersect it.
+         *
+         * @param planes the planes bounding the convex volume
+         * @return a list containing all found data items
+         */
+        List findIntersectors(const std::vector<Plane>& planes) const {
+            List result;
+            findIntersectors(planes, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the convex volume bounded by the given
+         * planes and appends it to the given output iterator. See above for the requirements on the given planes.
+         *
+         * @tparam O the output iterator type
+         * @param planes the planes bounding the convex volume
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const std::vector<Plane>& planes, O out) const {
+            visitFlatTree(
+                [&](const Box& bounds) {
+                    return intersectsVolume(bounds, planes);
+                },
+                [&](const FlatLeaf& leaf) {
+                    out = leaf.data;
+                    ++out;
+                }
+            );
+        }
+    private:
+        /**
+         * Checks whether the given box is not entirely above any of the given planes. For each plane, only the corner
+         * of the box that lies furthest in the opposite direction of the plane normal needs to be tested.
+         */
+        static bool intersectsVolume(const Box& box, const std::vector<Plane>& planes) {
+            for (const auto& plane : planes) {
+                vm::vec<T,S> corner;
+                for (size_t i = 0; i < S; ++i) {
+                    corner[i] = plane.normal[i] >= T(0) ? box.min[i] : box.max[i];
+                }
+                if (plane.point_distance(corner) > T(0)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    private:
+        void invalidateFlatTree() {
+            m_flatTreeValid.store(false, std::memory_order_release);
+        }
+
+        /**
+         * Visits the compact form of this tree in depth first order. Inner nodes whose bounds are rejected by the given
+         * test function are skipped along with their subtrees. Leafs are visited if their exact bounds are accepted by
+         * the given test function.
+         *
+         * @tparam I the type of the test function, must be a function const Box& -> bool
+         * @tparam L the type of the leaf visitor, must be a function const FlatLeaf& -> void
+         * @param testBounds the test function
+         * @param visitLeaf the leaf visitor
+         */
+        template <typename I, typename L>
+        void visitFlatTree(const I& testBounds, const L& visitLeaf) const {
+            validateFlatTree();
+
+            const auto count = m_flatNodes.size();
+            std::size_t index = 0u;
+            while (index < count) {
+                const auto& node = m_flatNodes[index];
+                if (node.leafIndex != NoLeaf) {
+                    const auto& leaf = m_flatLeafs[node.leafIndex];
+                    if (testBounds(leaf.bounds)) {
+                        visitLeaf(leaf);
+                    }
+                    ++index;
+                } else if (testBounds(Box(node.bounds))) {
+                    ++index;
+                } else {
+                    index = node.skipIndex;
+                }
+            }
+        }
+
+        /**
+         * Rebuilds the compact form of this tree if the structure of the tree was modified since it was last built.
+         * Concurrent queries are allowed as long as the tree isn't modified, so the rebuild is guarded by a mutex. The
+         * mutex is only taken if the compact form is invalid.
+         */
+        void validateFlatTree() const {
+            if (m_flatTreeValid.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            const auto lock = std::lock_guard<std::mutex>(m_flatTreeMutex);
+            if (m_flatTreeValid.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            m_flatNodes.clear();
+            m_flatLeafs.clear();
+
             if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
-                            ++out;
-                        }
+                // a binary tree with n leafs has 2n - 1 nodes
+                const auto leafCount = m_leafForData.size();
+                const auto nodeCount = 2u * leafCount - 1u;
+                assert(nodeCount < NoLeaf);
+
+                m_flatNodes.reserve(nodeCount);
+                m_flatLeafs.reserve(leafCount);
+
+                // Every stack entry either holds a node to emit, or the index of an emitted inner node whose subtree has
+                // been emitted completely, which means that its skip index is the index of the next node to be emitted.
+                struct Entry {
+                    const Node* node;
+                    std::uint32_t finishedIndex;
+                };
+
+                auto stack = std::vector<Entry>{ Entry{ m_root, NoLeaf } };
+                while (!stack.empty()) {
+                    const auto entry = stack.back();
+                    stack.pop_back();
+
+                    const auto index = static_cast<std::uint32_t>(m_flatNodes.size());
+                    if (entry.node == nullptr) {
+                        m_flatNodes[entry.finishedIndex].skipIndex = index;
+                        continue;
                     }
-                );
-                m_root->accept(visitor);
+
+                    LambdaVisitor visitor(
+                        [&](const InnerNode* innerNode) {
+                            innerNode->m_flatIndex = index;
+                            m_flatNodes.push_back(FlatNode{ toFlatBounds(innerNode->bounds()), NoLeaf, NoLeaf });
+                            stack.push_back(Entry{ nullptr, index });
+                            stack.push_back(Entry{ innerNode->right(), NoLeaf });
+                            stack.push_back(Entry{ innerNode->left(), NoLeaf });
+                            return false;
+                        },
+                        [&](const LeafNode* leaf) {
+                            const auto leafIndex = static_cast<std::uint32_t>(m_flatLeafs.size());
+                            leaf->m_flatIndex = index;
+                            m_flatNodes.push_back(FlatNode{ toFlatBounds(leaf->bounds()), index + 1u, leafIndex });
+                            m_flatLeafs.push_back(FlatLeaf{ leaf->bounds(), leaf->data() });
+                        }
+                    );
+                    entry.node->accept(visitor);
+                }
+
+                assert(m_flatNodes.size() == nodeCount);
             }
+
+            m_flatTreeValid.store(true, std::memory_order_release);
         }
 
+        /**
+         * Converts the given bounds to single precision such that the result contains the given bounds.
+         */
+        static vm::bbox<float,S> toFlatBounds(const Box& bounds) {
+            vm::bbox<float,S> result;
+            for (size_t i = 0; i < S; ++i) {
+                result.min[i] = static_cast<float>(bounds.min[i]);
+                if (static_cast<T>(result.min[i]) > bounds.min[i]) {
+                    result.min[i] = std::nextafter(result.min[i], -std::numeric_limits<float>::infinity());
+                }
+
+                result.max[i] = static_cast<float>(bounds.max[i]);
+                if (static_cast<T>(result.max[i]) < bounds.max[i]) {
+                    result.max[i] = std::nextafter(result.max[i], std::numeric_limits<float>::infinity());
+                }
+            }
+            return result;
+        }
+    public:
         /**
          * Prints a textual representation of this tree to the given output stream.
          *
@@ -29,6 +29,8 @@
 
 #include <kdl/string_format.h>
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <string>
 
@@ -125,6 +127,40 @@ namespace TrenchBroom {
             return m_data.get() != nullptr;
         }
 
+        /**
+         * Converts the given palette indices to RGBA pixels and counts how often each index occurs. The average color
+         * and the transparency of the image are computed from these counts afterwards, so the converted pixels don't
+         * have to be read again.
+         *
+         * Consecutive pixels are counted in separate tables because textures often contain runs of the same index, and
+         * incrementing the same counter repeatedly would make every iteration wait for the previous one.
+         */
+        static void convertIndices(const unsigned char* indices, const size_t pixelCount, const unsigned char* paletteData, unsigned char* rgbaData, std::array<size_t, 256>& indexCounts) {
+            constexpr auto TableCount = size_t(4);
+            std::array<std::array<uint32_t, 256>, TableCount> counts{};
+
+            size_t i = 0;
+            for (; i + TableCount <= pixelCount; i += TableCount) {
+                for (size_t j = 0; j < TableCount; ++j) {
+                    const auto index = indices[i + j];
+                    std::memcpy(rgbaData + (i + j) * 4, paletteData + index * 4, 4);
+                    ++counts[j][index];
+                }
+            }
+            for (; i < pixelCount; ++i) {
+                const auto index = indices[i];
+                std::memcpy(rgbaData + i * 4, paletteData + index * 4, 4);
+                ++counts[0][index];
+            }
+
+            for (size_t index = 0; index < 256; ++index) {
+                indexCounts[index] = 0;
+                for (size_t j = 0; j < TableCount; ++j) {
+                    indexCounts[index] += counts[j][index];
+                }
+            }
+        }
+
         bool Palette::indexedToRgba(IO::BufferedReader& reader, const size_t pixelCount, TextureBuffer& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
             ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
             ensure(initialized(), "indexedToRgba called on uninitialized palette");
@@ -137,38 +173,23 @@ namespace TrenchBroom {
             const unsigned char* indexedImage = reinterpret_cast<const unsigned char*>(reader.begin() + reader.position());
             reader.seekForward(pixelCount); // throws ReaderException if there aren't pixelCount bytes available
 
-            // Write rgba pixels
-            unsigned char* const rgbaData = rgbaImage.data();
-            for (size_t i = 0; i < pixelCount; ++i) {
-                const int index = static_cast<int>(indexedImage[i]);
-
-                std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
-            }
+            std::array<size_t, 256> indexCounts;
+            convertIndices(indexedImage, pixelCount, paletteData, rgbaImage.data(), indexCounts);
 
-            // Check average color
-            uint32_t colorSum[3] = {0, 0, 0};
-            for (size_t i = 0; i < pixelCount; ++i) {
-                colorSum[0] += static_cast<uint32_t>(rgbaData[(i * 4) + 0]);
-                colorSum[1] += static_cast<uint32_t>(rgbaData[(i * 4) + 1]);
-                colorSum[2] += static_cast<uint32_t>(rgbaData[(i * 4) + 2]);
+            // Compute the average color from the palette entries weighted by their number of occurrences
+            size_t colorSum[3] = {0, 0, 0};
+            for (size_t index = 0; index < 256; ++index) {
+                colorSum[0] += indexCounts[index] * static_cast<size_t>(paletteData[(index * 4) + 0]);
+                colorSum[1] += indexCounts[index] * static_cast<size_t>(paletteData[(index * 4) + 1]);
+                colorSum[2] += indexCounts[index] * static_cast<size_t>(paletteData[(index * 4) + 2]);
             }
             averageColor = Color(static_cast<float>(colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
                                  static_cast<float>(colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
                                  static_cast<float>(colorSum[2]) / (255.0f * static_cast<float>(pixelCount)),
                                  1.0f);
 
-            // Check for transparency
-            bool hasTransparency = false;
-            if (transparency == PaletteTransparency::Index255Transparent) {
-                // Take the bitwise AND of the alpha channel of all pixels
-                unsigned char andAlpha = 0xff;
-                for (size_t i = 0; i < pixelCount; ++i) {
-                    andAlpha &= rgbaData[(i * 4) + 3];
-                }
-                hasTransparency = (andAlpha != 0xff);
-            }
-
-            return hasTransparency;
+            // Only index 255 is transparent in the transparent palette
+            return transparency == PaletteTransparency::Index255Transparent && indexCounts[255] > 0;
         }
     }
 }
@@ -18,11 +18,15 @@
  */
 
 #include "Texture.h"
+#include "Assets/TextureArray.h"
 #include "Assets/TextureBuffer.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureCompression.h"
 #include "Renderer/GL.h"
 
-#include <algorithm> // for std::max
+#include <vecmath/vec.h>
+
+#include <algorithm> // for std::max, std::min
 #include <cassert>
 
 namespace TrenchBroom {
@@ -38,11 +42,19 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_minFilter(0),
+        m_magFilter(0),
+        m_loaded(true),
+        m_activated(false),
+        m_uploaded(false),
+        m_textureArray(nullptr),
+        m_textureArrayLayer(0) {
             assert(m_width > 0);
             assert(m_height > 0);
-            assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
+            assert(buffer.size() >= mipBufferSize(vm::vec2s(m_width, m_height), format));
             m_buffers.push_back(std::move(buffer));
+            generateMipsIfMissing();
         }
 
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, BufferList&& buffers, const GLenum format, const TextureType type) :
@@ -57,17 +69,23 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(std::move(buffers)) {
+        m_buffers(std::move(buffers)),
+        m_minFilter(0),
+        m_magFilter(0),
+        m_loaded(true),
+        m_activated(false),
+        m_uploaded(false),
+        m_textureArray(nullptr),
+        m_textureArrayLayer(0) {
             assert(m_width > 0);
             assert(m_height > 0);
 
-            [[maybe_unused]] const auto bytesPerPixel = bytesPerPixelForFormat(format);
-
             for (size_t level = 0; level < m_buffers.size(); ++level) {
-                [[maybe_unused]] const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
-                [[maybe_unused]] const auto numBytes = bytesPerPixel * mipSize.x() * mipSize.y();
+                [[maybe_unused]] const auto numBytes = mipBufferSize(sizeAtMipLevel(m_width, m_height, level), format);
                 assert(m_buffers[level].size() >= numBytes);
             }
+
+            generateMipsIfMissing();
         }
 
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const GLenum format, const TextureType type) :
@@ -81,10 +99,26 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_textureId(0),
+        m_minFilter(0),
+        m_magFilter(0),
+        m_loaded(true),
+        m_activated(false),
+        m_uploaded(false),
+        m_textureArray(nullptr),
+        m_textureArrayLayer(0) {}
 
         Texture::~Texture() = default;
 
+        void Texture::generateMipsIfMissing() {
+            // Textures are usually read on worker threads, so computing the mipmaps here is cheaper than letting the
+            // driver generate them on the main thread when the texture is uploaded. Masked textures only use their
+            // first mipmap.
+            if (m_buffers.size() == 1u && m_type != TextureType::Masked && !compressed()) {
+                generateMips(m_buffers, m_width, m_height, m_format);
+            }
+        }
+
         TextureType Texture::selectTextureType(const bool masked) {
             if (masked) {
                 return TextureType::Masked;
@@ -180,60 +214,187 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        bool Texture::lazy() const {
+            return static_cast<bool>(m_dataReader);
+        }
+
+        void Texture::setDataReader(DataReader dataReader) {
+            assert(!isPrepared());
+
+            m_dataReader = std::move(dataReader);
+            m_loaded = !lazy();
+            if (lazy()) {
+                m_buffers.clear();
+            }
+        }
+
+        const Texture::DataReader& Texture::dataReader() const {
+            return m_dataReader;
+        }
+
+        bool Texture::loaded() const {
+            return m_loaded;
+        }
+
+        void Texture::load() {
+            setData(m_dataReader());
+        }
+
+        void Texture::setData(Texture data) {
+            assert(lazy());
+            assert(!loaded());
+
+            if (!data.m_buffers.empty()) {
+                // the reader returns a default texture if the data cannot be read, which can have other dimensions
+                m_width = data.m_width;
+                m_height = data.m_height;
+            }
+            m_averageColor = data.m_averageColor;
+            m_format = data.m_format;
+            m_type = data.m_type;
+            m_buffers = std::move(data.m_buffers);
+            m_loaded = true;
+        }
+
+        void Texture::unload() {
+            assert(lazy());
+
+            releaseTextureArrayLayer();
+            m_textureId = 0;
+            m_buffers.clear();
+            m_loaded = false;
+            m_uploaded = false;
+        }
+
+        bool Texture::activated() const {
+            return m_activated;
+        }
+
+        void Texture::resetActivated() {
+            m_activated = false;
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
 
+        size_t Texture::uploadSize() const {
+            // Only the first mipmap is uploaded for masked textures.
+            const auto mipmapsToUpload = (m_type == TextureType::Masked) ? std::min(size_t(1), m_buffers.size()) : m_buffers.size();
+
+            size_t result = 0;
+            for (size_t i = 0; i < mipmapsToUpload; ++i) {
+                result += m_buffers[i].size();
+            }
+            return result;
+        }
+
         void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter) {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
             if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+                m_textureId = textureId;
+                m_minFilter = minFilter;
+                m_magFilter = magFilter;
+
+                // faces are rendered from the texture array, so don't occupy video memory with a second copy unless
+                // this texture is activated, and don't keep the data in memory either because the copy can be read back
+                // from the array
+                if (m_textureArray == nullptr) {
+                    upload();
                 } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
+                    m_buffers.clear();
                 }
+            }
+        }
+
+        void Texture::upload() const {
+            glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+            glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+            glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+            if (m_type == TextureType::Masked) {
+                // masked textures don't work well with mipmaps, so we force GL_NEAREST filtering and only upload the first one
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            } else {
+                // textures without stored mipmaps have had them computed when they were read
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
+            }
+
+            // Upload only the first mipmap for masked textures.
+            const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
 
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
+            // if the driver cannot decompress the texture, it is decompressed here
+            const auto uploadCompressed = compressed() && compressedFormatsSupported();
 
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+            for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
 
+                if (uploadCompressed) {
+                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
+                    glAssert(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), m_format,
+                                                    static_cast<GLsizei>(mipSize.x()),
+                                                    static_cast<GLsizei>(mipSize.y()),
+                                                    0, static_cast<GLsizei>(mipBufferSize(mipSize, m_format)), data));
+                } else if (compressed()) {
+                    const auto decompressed = decompressMip(m_buffers[j], mipSize, m_format);
+                    const GLvoid* data = reinterpret_cast<const GLvoid*>(decompressed.data());
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                          static_cast<GLsizei>(mipSize.x()),
+                                          static_cast<GLsizei>(mipSize.y()),
+                                          0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+                } else {
                     const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
                     glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
                                           static_cast<GLsizei>(mipSize.x()),
                                           static_cast<GLsizei>(mipSize.y()),
                                           0, m_format, GL_UNSIGNED_BYTE, data));
                 }
+            }
 
-                m_buffers.clear();
-                m_textureId = textureId;
+            m_buffers.clear();
+            m_uploaded = true;
+        }
+
+        void Texture::compress() {
+            if (m_buffers.empty() || compressed()) {
+                return;
             }
+
+            // masked textures only use their first mipmap
+            if (m_type != TextureType::Masked) {
+                generateMips(m_buffers, m_width, m_height, m_format);
+            }
+
+            const auto compressedFormat = m_type == TextureType::Masked ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            for (size_t level = 0; level < m_buffers.size(); ++level) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
+                m_buffers[level] = compressMip(m_buffers[level], mipSize, m_format, compressedFormat);
+            }
+            m_format = compressedFormat;
+        }
+
+        bool Texture::compressed() const {
+            return isCompressedFormat(m_format);
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
-            if (isPrepared()) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
+            // a texture whose upload was deferred applies the filters when it is uploaded
+            if (m_uploaded) {
                 activate();
                 if (m_type == TextureType::Masked) {
                     // Force GL_NEAREST filtering for masked textures.
@@ -248,7 +409,13 @@ namespace TrenchBroom {
         }
 
         void Texture::activate() const {
+            m_activated = true;
             if (isPrepared()) {
+                if (!m_uploaded) {
+                    assert(m_textureArray != nullptr);
+                    m_buffers = m_textureArray->readLayer(m_textureArrayLayer, m_format);
+                    upload();
+                }
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
                 switch (m_culling) {
@@ -304,6 +471,36 @@ namespace TrenchBroom {
             }
         }
 
+        bool Texture::canUseTextureArray() const {
+            return m_type == TextureType::Opaque
+                && !compressed()
+                && m_culling == TextureCulling::CullDefault
+                && m_blendFunc.enable == TextureBlendFunc::Enable::UseDefault;
+        }
+
+        const TextureArray* Texture::textureArray() const {
+            return m_textureArray;
+        }
+
+        size_t Texture::textureArrayLayer() const {
+            return m_textureArrayLayer;
+        }
+
+        void Texture::setTextureArray(TextureArray* textureArray, const size_t layer) {
+            assert(m_textureArray == nullptr);
+
+            m_textureArray = textureArray;
+            m_textureArrayLayer = layer;
+        }
+
+        void Texture::releaseTextureArrayLayer() {
+            if (m_textureArray != nullptr) {
+                m_textureArray->releaseLayer(m_textureArrayLayer);
+                m_textureArray = nullptr;
+                m_textureArrayLayer = 0;
+            }
+        }
+
         const Texture::BufferList& Texture::buffersIfUnprepared() const {
             return m_buffers;
         }
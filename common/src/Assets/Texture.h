@@ -26,12 +26,14 @@
 
 #include <vecmath/forward.h>
 
+#include <functional>
 #include <set>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
+        class TextureArray;
         class TextureCollection;
 
         enum class TextureType {
@@ -72,6 +74,12 @@ namespace TrenchBroom {
         };
 
         class Texture {
+        public:
+            /**
+             * Reads the data of a lazily loaded texture. Returns a texture with the same name and dimensions that holds
+             * the data.
+             */
+            using DataReader = std::function<Texture()>;
         private:
             using Buffer = TextureBuffer;
             using BufferList = std::vector<Buffer>;
@@ -101,6 +109,21 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+
+            // the filters of the OpenGL texture object, which are applied when the texture is uploaded, see prepare
+            int m_minFilter;
+            int m_magFilter;
+
+            // only set for lazily loaded textures, whose data is read when it is first needed
+            DataReader m_dataReader;
+            bool m_loaded;
+            mutable bool m_activated;
+            // whether the data of this texture was uploaded to its OpenGL texture object, see prepare
+            mutable bool m_uploaded;
+
+            // only set if a copy of this texture is stored in a layer of a texture array
+            TextureArray* m_textureArray;
+            size_t m_textureArrayLayer;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type);
@@ -156,12 +179,99 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Indicates whether the data of this texture is read only when it is needed, and can be unloaded again
+             * afterwards.
+             */
+            bool lazy() const;
+            void setDataReader(DataReader dataReader);
+
+            /**
+             * Returns the data reader of this lazy texture. The data reader does not refer to this texture, so a copy
+             * of it can be called on another thread, and the result passed to setData.
+             */
+            const DataReader& dataReader() const;
+
+            /**
+             * Indicates whether the data of this texture has been read. This is always true for textures which are not
+             * lazy.
+             */
+            bool loaded() const;
+
+            /**
+             * Reads the data of this lazy texture, which must not be loaded yet. Afterwards, the texture can be
+             * prepared.
+             */
+            void load();
+
+            /**
+             * Sets the data of this lazy texture, which must not be loaded yet, to the data of the given texture that
+             * was returned by this texture's data reader. Afterwards, the texture can be prepared.
+             */
+            void setData(Texture data);
+
+            /**
+             * Discards the data of this lazy texture and releases its texture array layer. The caller is responsible
+             * for deleting the OpenGL texture object.
+             */
+            void unload();
+
+            /**
+             * Indicates whether activate was called since the last call to resetActivated. This is used to determine
+             * which lazy textures are needed for rendering.
+             */
+            bool activated() const;
+            void resetActivated();
+
             bool isPrepared() const;
+            /**
+             * Returns the number of bytes of texture data that will be uploaded when this texture is prepared.
+             */
+            size_t uploadSize() const;
+
+            /**
+             * Uploads the data of this texture to the given OpenGL texture object. If a copy of this texture is stored
+             * in a texture array, faces are rendered from the array, so the upload is deferred until this texture is
+             * activated, which only happens for the few textures that are rendered individually, e.g. in the texture
+             * browser. The data is not kept in memory in the meantime, it is read back from the texture array when this
+             * texture is activated.
+             */
             void prepare(GLuint textureId, int minFilter, int magFilter);
+
+            /**
+             * Compresses the data of this texture to BC3 if it is masked, or to BC1 otherwise. Unless the texture is
+             * masked, its missing mipmaps are computed before it is compressed. Has no effect if this texture is
+             * prepared or already compressed.
+             */
+            void compress();
+            bool compressed() const;
             void setMode(int minFilter, int magFilter);
 
             void activate() const;
             void deactivate() const;
+
+            /**
+             * Indicates whether this texture can be rendered from a layer of a texture array. This is only the case for
+             * textures which are not masked or compressed and which don't change the culling or blending state when
+             * they are activated, because the faces of all textures in an array are rendered with the same state.
+             */
+            bool canUseTextureArray() const;
+
+            /**
+             * Returns the texture array that holds a copy of this texture, or null if there is none. The layer is
+             * released when this texture is unloaded.
+             */
+            const TextureArray* textureArray() const;
+            size_t textureArrayLayer() const;
+            void setTextureArray(TextureArray* textureArray, size_t layer);
+
+            /**
+             * Releases the layer of this texture's texture array so that it can be used for another texture.
+             */
+            void releaseTextureArrayLayer();
+        private:
+            void generateMipsIfMissing();
+            void upload() const;
         public: // exposed for tests only
             /**
              * Returns the texture data in the format returned by format().
@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureArray.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static size_t mipLevelCount(const size_t width, const size_t height) {
+            size_t result = 1u;
+            for (auto size = std::max(width, height); size > 1u; size /= 2u) {
+                ++result;
+            }
+            return result;
+        }
+
+        TextureArray::TextureArray(const size_t width, const size_t height, const int minFilter, const int magFilter) :
+        m_width(width),
+        m_height(height),
+        m_mipLevels(mipLevelCount(width, height)),
+        m_textureId(0),
+        m_usedLayerCount(0) {
+            assert(supported());
+
+            glAssert(glGenTextures(1, &m_textureId));
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MIN_FILTER, minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAG_FILTER, magFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_S, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_T, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_mipLevels - 1u)));
+
+            // allocate the storage of all layers
+            for (size_t level = 0u; level < m_mipLevels; ++level) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
+                glAssert(glTexImage3D(GL_TEXTURE_2D_ARRAY_EXT, static_cast<GLint>(level), GL_RGBA,
+                                      static_cast<GLsizei>(mipSize.x()),
+                                      static_cast<GLsizei>(mipSize.y()),
+                                      static_cast<GLsizei>(LayerCount),
+                                      0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+            }
+
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+        }
+
+        TextureArray::~TextureArray() {
+            if (m_textureId != 0) {
+                glAssert(glDeleteTextures(1, &m_textureId));
+                m_textureId = 0;
+            }
+        }
+
+        bool TextureArray::supported() {
+            return GLEW_EXT_texture_array != GL_FALSE;
+        }
+
+        size_t TextureArray::width() const {
+            return m_width;
+        }
+
+        size_t TextureArray::height() const {
+            return m_height;
+        }
+
+        bool TextureArray::full() const {
+            return m_usedLayerCount == LayerCount && m_freeLayers.empty();
+        }
+
+        bool TextureArray::empty() const {
+            return m_freeLayers.size() == m_usedLayerCount;
+        }
+
+        size_t TextureArray::addTexture(const Texture& texture) {
+            assert(!full());
+            assert(texture.width() == m_width);
+            assert(texture.height() == m_height);
+
+            const auto& buffers = texture.buffersIfUnprepared();
+            assert(!buffers.empty());
+
+            size_t layer;
+            if (!m_freeLayers.empty()) {
+                layer = m_freeLayers.back();
+                m_freeLayers.pop_back();
+            } else {
+                layer = m_usedLayerCount++;
+            }
+
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureId));
+
+            // the mipmaps which the texture doesn't provide are computed from the smallest one that it provides
+            auto computedMip = TextureBuffer();
+            for (size_t level = 0u; level < m_mipLevels; ++level) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
+                if (level >= buffers.size()) {
+                    const auto& previousMip = level - 1u < buffers.size() ? buffers[level - 1u] : computedMip;
+                    computedMip = downsampleMip(previousMip, sizeAtMipLevel(m_width, m_height, level - 1u), texture.format());
+                }
+
+                const auto& mip = level < buffers.size() ? buffers[level] : computedMip;
+                glAssert(glTexSubImage3D(GL_TEXTURE_2D_ARRAY_EXT, static_cast<GLint>(level),
+                                         0, 0, static_cast<GLint>(layer),
+                                         static_cast<GLsizei>(mipSize.x()),
+                                         static_cast<GLsizei>(mipSize.y()),
+                                         1, texture.format(), GL_UNSIGNED_BYTE, mip.data()));
+            }
+
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+            return layer;
+        }
+
+        TextureBufferList TextureArray::readLayer(const size_t layer, const GLenum format) const {
+            assert(layer < m_usedLayerCount);
+
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+
+            glAssert(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureId));
+
+            auto result = TextureBufferList();
+            result.reserve(m_mipLevels);
+            for (size_t level = 0u; level < m_mipLevels; ++level) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
+                const auto layerSize = mipSize.x() * mipSize.y() * bytesPerPixel;
+
+                auto allLayers = TextureBuffer(layerSize * LayerCount);
+                glAssert(glGetTexImage(GL_TEXTURE_2D_ARRAY_EXT, static_cast<GLint>(level), format, GL_UNSIGNED_BYTE, allLayers.data()));
+
+                auto mip = TextureBuffer(layerSize);
+                std::copy_n(allLayers.data() + layer * layerSize, layerSize, mip.data());
+                result.push_back(std::move(mip));
+            }
+
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+            return result;
+        }
+
+        void TextureArray::releaseLayer(const size_t layer) {
+            assert(layer < m_usedLayerCount);
+            m_freeLayers.push_back(layer);
+        }
+
+        void TextureArray::setMode(const int minFilter, const int magFilter) {
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MIN_FILTER, minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAG_FILTER, magFilter));
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+        }
+
+        void TextureArray::activate() const {
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureId));
+        }
+
+        void TextureArray::deactivate() const {
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+        }
+    }
+}
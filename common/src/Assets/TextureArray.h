@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/GL.h"
+#include "Assets/TextureBuffer.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+
+        /**
+         * An OpenGL texture array whose layers hold copies of textures with the same dimensions. The faces of all
+         * textures in an array can be rendered with a single draw call, where the layer of each face's texture is passed
+         * as the third texture coordinate.
+         *
+         * Every layer has a full chain of mipmaps down to 1x1 pixels, so that the smallest mipmap holds the average
+         * color of the layer. Mipmaps which are not provided by a texture are computed when it is added.
+         *
+         * Texture arrays require the GL_EXT_texture_array extension.
+         */
+        class TextureArray {
+        public:
+            /**
+             * The number of layers of every texture array. The storage for all layers is allocated when the array is
+             * created.
+             */
+            static constexpr size_t LayerCount = 32u;
+        private:
+            size_t m_width;
+            size_t m_height;
+            size_t m_mipLevels;
+            GLuint m_textureId;
+
+            size_t m_usedLayerCount;
+            std::vector<size_t> m_freeLayers;
+        public:
+            /**
+             * Creates a texture array for textures with the given dimensions. Must be called with a current GL context.
+             */
+            TextureArray(size_t width, size_t height, int minFilter, int magFilter);
+            ~TextureArray();
+
+            TextureArray(const TextureArray&) = delete;
+            TextureArray& operator=(const TextureArray&) = delete;
+
+            /**
+             * Indicates whether texture arrays are supported by the current GL context.
+             */
+            static bool supported();
+
+            size_t width() const;
+            size_t height() const;
+
+            /**
+             * Indicates whether all layers of this array are in use.
+             */
+            bool full() const;
+
+            /**
+             * Indicates whether none of the layers of this array are in use.
+             */
+            bool empty() const;
+
+            /**
+             * Copies the data of the given texture into an unused layer and returns the index of that layer. The
+             * texture must have the same dimensions as this array, it must not be prepared yet, and this array must not
+             * be full.
+             */
+            size_t addTexture(const Texture& texture);
+
+            /**
+             * Reads the mipmaps of the given layer back from video memory in the given format, one of GL_RGB, GL_BGR,
+             * GL_RGBA, GL_BGRA. A single layer cannot be read without a framebuffer object, so every mipmap is read for
+             * all layers and the given layer is copied out of it. This is expensive and only meant for the rare cases
+             * where a texture in this array is rendered on its own.
+             */
+            TextureBufferList readLayer(size_t layer, GLenum format) const;
+
+            /**
+             * Marks the given layer as unused. The data of the layer is overwritten when another texture is added.
+             */
+            void releaseLayer(size_t layer);
+
+            void setMode(int minFilter, int magFilter);
+
+            void activate() const;
+            void deactivate() const;
+        };
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureArrayPool.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureArray.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace Assets {
+        TextureArrayPool::TextureArrayPool() = default;
+
+        TextureArrayPool::~TextureArrayPool() = default;
+
+        void TextureArrayPool::addTexture(Texture& texture, const int minFilter, const int magFilter) {
+            if (texture.textureArray() != nullptr || !texture.canUseTextureArray() || texture.buffersIfUnprepared().empty()) {
+                return;
+            }
+
+            auto it = std::find_if(std::begin(m_arrays), std::end(m_arrays), [&](const auto& array) {
+                return array->width() == texture.width() && array->height() == texture.height() && !array->full();
+            });
+            if (it == std::end(m_arrays)) {
+                m_arrays.push_back(std::make_unique<TextureArray>(texture.width(), texture.height(), minFilter, magFilter));
+                it = std::prev(std::end(m_arrays));
+            }
+
+            auto& array = **it;
+            texture.setTextureArray(&array, array.addTexture(texture));
+            m_addedTextures.push_back(&texture);
+        }
+
+        std::vector<const Texture*> TextureArrayPool::takeAddedTextures() {
+            return std::exchange(m_addedTextures, {});
+        }
+
+        void TextureArrayPool::removeEmptyArrays() {
+            m_arrays.erase(std::remove_if(std::begin(m_arrays), std::end(m_arrays), [](const auto& array) {
+                return array->empty();
+            }), std::end(m_arrays));
+        }
+
+        void TextureArrayPool::setTextureMode(const int minFilter, const int magFilter) {
+            for (auto& array : m_arrays) {
+                array->setMode(minFilter, magFilter);
+            }
+        }
+    }
+}
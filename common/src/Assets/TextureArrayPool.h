@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+        class TextureArray;
+
+        /**
+         * Manages the texture arrays of a texture manager. Textures are added to the first array with matching
+         * dimensions that has an unused layer, and new arrays are created as needed. Arrays whose layers all became
+         * unused are destroyed by removeEmptyArrays.
+         */
+        class TextureArrayPool {
+        private:
+            std::vector<std::unique_ptr<TextureArray>> m_arrays;
+            std::vector<const Texture*> m_addedTextures;
+        public:
+            TextureArrayPool();
+            ~TextureArrayPool();
+
+            TextureArrayPool(const TextureArrayPool&) = delete;
+            TextureArrayPool& operator=(const TextureArrayPool&) = delete;
+
+            /**
+             * Copies the data of the given texture into a layer of a texture array, unless the texture is already stored
+             * in a texture array, it cannot be rendered from a texture array, or it has no data. Must be called before
+             * the texture is prepared.
+             */
+            void addTexture(Texture& texture, int minFilter, int magFilter);
+
+            /**
+             * Returns the textures which were added to a texture array since the last call and forgets them. Faces using
+             * these textures must be staged again to be rendered from the texture arrays.
+             */
+            std::vector<const Texture*> takeAddedTextures();
+
+            /**
+             * Destroys the texture arrays which have no used layers. Must be called with a current GL context.
+             */
+            void removeEmptyArrays();
+
+            void setTextureMode(int minFilter, int magFilter);
+        };
+    }
+}
@@ -25,7 +25,8 @@
 
 #include <FreeImage.h>
 
-#include <algorithm> // for std::max
+#include <algorithm> // for std::max, std::min
+#include <cassert>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -111,5 +112,44 @@ namespace TrenchBroom {
                 FreeImage_Unload(newBitmap);
             }
         }
+
+        TextureBuffer downsampleMip(const TextureBuffer& buffer, const vm::vec2s& size, const GLenum format) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            assert(buffer.size() == size.x() * size.y() * bytesPerPixel);
+
+            const auto newSize = sizeAtMipLevel(size.x(), size.y(), 1u);
+            auto result = TextureBuffer(newSize.x() * newSize.y() * bytesPerPixel);
+
+            const auto* src = buffer.data();
+            auto* dest = result.data();
+            for (size_t y = 0u; y < newSize.y(); ++y) {
+                const auto y0 = std::min(2u * y, size.y() - 1u);
+                const auto y1 = std::min(2u * y + 1u, size.y() - 1u);
+                for (size_t x = 0u; x < newSize.x(); ++x) {
+                    const auto x0 = std::min(2u * x, size.x() - 1u);
+                    const auto x1 = std::min(2u * x + 1u, size.x() - 1u);
+                    for (size_t c = 0u; c < bytesPerPixel; ++c) {
+                        const auto sum =
+                            src[(y0 * size.x() + x0) * bytesPerPixel + c] +
+                            src[(y0 * size.x() + x1) * bytesPerPixel + c] +
+                            src[(y1 * size.x() + x0) * bytesPerPixel + c] +
+                            src[(y1 * size.x() + x1) * bytesPerPixel + c];
+                        *dest++ = static_cast<unsigned char>((sum + 2u) / 4u);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        void generateMips(TextureBufferList& buffers, const size_t width, const size_t height, const GLenum format) {
+            assert(!buffers.empty());
+
+            auto size = sizeAtMipLevel(width, height, buffers.size() - 1u);
+            while (size.x() > 1u || size.y() > 1u) {
+                buffers.push_back(downsampleMip(buffers.back(), size, format));
+                size = sizeAtMipLevel(size.x(), size.y(), 1u);
+            }
+        }
     }
 }
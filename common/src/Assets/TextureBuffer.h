@@ -48,6 +48,29 @@ namespace TrenchBroom {
         void setMipBufferSize(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
         void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize);
+
+        /**
+         * Computes the next mipmap level of the given mipmap by averaging blocks of 2x2 pixels. The given mipmap must
+         * be tightly packed in the given format. If one of its dimensions is odd, the last row or column is averaged
+         * with itself.
+         *
+         * @param buffer the mipmap to downsample
+         * @param size the size of the given mipmap
+         * @param format the format of the given mipmap, one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA
+         * @return the next mipmap level, its size is given by sizeAtMipLevel(size.x(), size.y(), 1)
+         */
+        TextureBuffer downsampleMip(const TextureBuffer& buffer, const vm::vec2s& size, GLenum format);
+
+        /**
+         * Appends the mipmaps which are missing from the given list until the smallest one has a size of 1x1. Each
+         * added mipmap is computed from the previous one using downsampleMip.
+         *
+         * @param buffers the mipmaps to complete, must contain at least the first mipmap
+         * @param width the width of the first mipmap
+         * @param height the height of the first mipmap
+         * @param format the format of the mipmaps, one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA
+         */
+        void generateMips(TextureBufferList& buffers, size_t width, size_t height, GLenum format);
     }
 }
 
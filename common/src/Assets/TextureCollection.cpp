@@ -19,7 +19,9 @@
 
 #include "TextureCollection.h"
 
+#include "BufferedLogger.h"
 #include "Ensure.h"
+#include "Assets/TextureArrayPool.h"
 
 #include <kdl/vector_utils.h>
 
@@ -29,22 +31,30 @@
 namespace TrenchBroom {
     namespace Assets {
         TextureCollection::TextureCollection() :
-        m_loaded(false) {}
+        m_loaded(false),
+        m_preparedCount(0) {}
 
         TextureCollection::TextureCollection(std::vector<Texture> textures) :
         m_loaded(false),
-        m_textures(std::move(textures)) {}
+        m_textures(std::move(textures)),
+        m_preparedCount(0) {}
 
         TextureCollection::TextureCollection(const IO::Path& path) :
         m_loaded(false),
-        m_path(path) {}
+        m_path(path),
+        m_preparedCount(0) {}
 
         TextureCollection::TextureCollection(const IO::Path& path, std::vector<Texture> textures) :
         m_loaded(true),
         m_path(path),
-        m_textures(std::move(textures)) {}
+        m_textures(std::move(textures)),
+        m_preparedCount(0) {}
 
         TextureCollection::~TextureCollection() {
+            for (auto& texture : m_textures) {
+                texture.releaseTextureArrayLayer();
+            }
+
             if (!m_textureIds.empty()) {
                 glAssert(glDeleteTextures(static_cast<GLsizei>(m_textureIds.size()),
                                           static_cast<GLuint*>(&m_textureIds.front())));
@@ -104,22 +114,55 @@ namespace TrenchBroom {
         }
 
         bool TextureCollection::prepared() const {
-            return !m_textureIds.empty();
+            return m_preparedCount == textureCount();
         }
 
-        void TextureCollection::prepare(const int minFilter, const int magFilter) {
+        size_t TextureCollection::prepare(const int minFilter, const int magFilter, const size_t maxBytes, TextureArrayPool* textureArrays) {
             assert(!prepared());
+            generateTextureIds();
+
+            size_t uploadedBytes = 0;
+            do {
+                // lazy textures that are not loaded have no data and are skipped here
+                Texture& texture = m_textures[m_preparedCount];
+                if (!texture.isPrepared()) {
+                    uploadedBytes += texture.uploadSize();
+                    if (textureArrays != nullptr) {
+                        textureArrays->addTexture(texture, minFilter, magFilter);
+                    }
+                    texture.prepare(m_textureIds[m_preparedCount], minFilter, magFilter);
+                }
+                ++m_preparedCount;
+            } while (m_preparedCount < textureCount() && uploadedBytes < maxBytes);
 
-            m_textureIds.resize(textureCount());
-            if (textureCount() != 0u) {
-                glAssert(glGenTextures(static_cast<GLsizei>(textureCount()),
-                                       static_cast<GLuint*>(&m_textureIds.front())));
+            return uploadedBytes;
+        }
 
-                for (size_t i = 0; i < textureCount(); ++i) {
-                    Texture& texture = m_textures[i];
-                    texture.prepare(m_textureIds[i], minFilter, magFilter);
-                }
+        size_t TextureCollection::loadTexture(const size_t index, Texture data, const int minFilter, const int magFilter, TextureArrayPool* textureArrays) {
+            assert(index < textureCount());
+            generateTextureIds();
+
+            Texture& texture = m_textures[index];
+            texture.setData(std::move(data));
+
+            const auto uploadedBytes = texture.uploadSize();
+            if (textureArrays != nullptr) {
+                textureArrays->addTexture(texture, minFilter, magFilter);
+            }
+            texture.prepare(m_textureIds[index], minFilter, magFilter);
+            return uploadedBytes;
+        }
+
+        void TextureCollection::unloadTexture(const size_t index) {
+            assert(index < textureCount());
+
+            Texture& texture = m_textures[index];
+            if (texture.isPrepared()) {
+                // replace the texture object instead of reusing it so that no stale mipmaps remain
+                glAssert(glDeleteTextures(1, &m_textureIds[index]));
+                glAssert(glGenTextures(1, &m_textureIds[index]));
             }
+            texture.unload();
         }
 
         void TextureCollection::setTextureMode(const int minFilter, const int magFilter) {
@@ -127,5 +170,23 @@ namespace TrenchBroom {
                 texture.setMode(minFilter, magFilter);
             }
         }
+
+        void TextureCollection::setLazyTextureLogger(std::shared_ptr<BufferedLogger> logger) {
+            m_lazyTextureLogger = std::move(logger);
+        }
+
+        void TextureCollection::flushLazyTextureLog() {
+            if (m_lazyTextureLogger != nullptr) {
+                m_lazyTextureLogger->flush();
+            }
+        }
+
+        void TextureCollection::generateTextureIds() {
+            if (m_textureIds.empty() && textureCount() != 0u) {
+                m_textureIds.resize(textureCount());
+                glAssert(glGenTextures(static_cast<GLsizei>(textureCount()),
+                                       static_cast<GLuint*>(&m_textureIds.front())));
+            }
+        }
     }
 }
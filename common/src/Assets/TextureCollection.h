@@ -23,11 +23,16 @@
 #include "IO/Path.h"
 #include "Renderer/GL.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
+    class BufferedLogger;
+
     namespace Assets {
+        class TextureArrayPool;
+
         class TextureCollection {
         private:
             using TextureIdList = std::vector<GLuint>;
@@ -37,6 +42,9 @@ namespace TrenchBroom {
             std::vector<Texture> m_textures;
 
             TextureIdList m_textureIds;
+            size_t m_preparedCount;
+
+            std::shared_ptr<BufferedLogger> m_lazyTextureLogger;
 
             friend class Texture;
         public:
@@ -67,9 +75,52 @@ namespace TrenchBroom {
             const Texture* textureByName(const std::string& name) const;
             Texture* textureByName(const std::string& name);
 
+            /**
+             * Indicates whether all textures of this collection have been uploaded.
+             */
             bool prepared() const;
-            void prepare(int minFilter, int magFilter);
+
+            /**
+             * Uploads the textures which have not been uploaded yet, in order, until at least the given number of bytes
+             * has been uploaded or all textures are uploaded. At least one texture is uploaded by every call, so that
+             * textures which are larger than the given budget are uploaded eventually.
+             *
+             * @param minFilter the minification filter to set for the uploaded textures
+             * @param magFilter the magnification filter to set for the uploaded textures
+             * @param maxBytes the number of bytes to upload
+             * @param textureArrays if not null, the uploaded textures are also added to these texture arrays
+             * @return the number of bytes that were uploaded
+             */
+            size_t prepare(int minFilter, int magFilter, size_t maxBytes, TextureArrayPool* textureArrays);
+
+            /**
+             * Sets the data of the lazy texture with the given index and uploads it. The texture must not be loaded.
+             *
+             * @param index the index of the texture to load
+             * @param data the data of the texture, as returned by its data reader
+             * @param minFilter the minification filter to set for the texture
+             * @param magFilter the magnification filter to set for the texture
+             * @param textureArrays if not null, the texture is also added to these texture arrays
+             * @return the number of bytes that were uploaded
+             */
+            size_t loadTexture(size_t index, Texture data, int minFilter, int magFilter, TextureArrayPool* textureArrays);
+
+            /**
+             * Discards the data of the lazy texture with the given index and frees its OpenGL texture object.
+             *
+             * @param index the index of the texture to unload
+             */
+            void unloadTexture(size_t index);
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Sets the logger to which the data readers of the lazy textures of this collection log. The data readers
+             * are called on worker threads, so their messages are stored until flushLazyTextureLog is called.
+             */
+            void setLazyTextureLogger(std::shared_ptr<BufferedLogger> logger);
+            void flushLazyTextureLog();
+        private:
+            void generateTextureIds();
         };
     }
 }
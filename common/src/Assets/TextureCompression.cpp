@@ -0,0 +1,322 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCompression.h"
+
+#include "Ensure.h"
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static constexpr size_t BlockSize = 4u;
+
+        // the RGBA components of a pixel
+        using Pixel = std::array<int, 4>;
+        using Block = std::array<Pixel, BlockSize * BlockSize>;
+
+        bool isCompressedFormat(const GLenum format) {
+            return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+
+        bool compressedFormatsSupported() {
+            return GLEW_EXT_texture_compression_s3tc != GL_FALSE;
+        }
+
+        static size_t blockCount(const size_t pixelCount) {
+            return (pixelCount + BlockSize - 1u) / BlockSize;
+        }
+
+        static size_t bytesPerBlock(const GLenum compressedFormat) {
+            return compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8u : 16u;
+        }
+
+        size_t mipBufferSize(const vm::vec2s& size, const GLenum format) {
+            if (isCompressedFormat(format)) {
+                return blockCount(size.x()) * blockCount(size.y()) * bytesPerBlock(format);
+            } else {
+                return size.x() * size.y() * bytesPerPixelForFormat(format);
+            }
+        }
+
+        static Block readBlock(const TextureBuffer& buffer, const vm::vec2s& size, const GLenum format, const size_t blockX, const size_t blockY) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            const auto swapRedAndBlue = format == GL_BGR || format == GL_BGRA;
+
+            auto result = Block{};
+            for (size_t y = 0u; y < BlockSize; ++y) {
+                // blocks which extend past the edges of the mipmap repeat its last row and column
+                const auto pixelY = std::min(blockY * BlockSize + y, size.y() - 1u);
+                for (size_t x = 0u; x < BlockSize; ++x) {
+                    const auto pixelX = std::min(blockX * BlockSize + x, size.x() - 1u);
+                    const auto* src = buffer.data() + (pixelY * size.x() + pixelX) * bytesPerPixel;
+
+                    auto& pixel = result[y * BlockSize + x];
+                    pixel[0] = src[swapRedAndBlue ? 2u : 0u];
+                    pixel[1] = src[1u];
+                    pixel[2] = src[swapRedAndBlue ? 0u : 2u];
+                    pixel[3] = bytesPerPixel == 4u ? src[3u] : 255;
+                }
+            }
+            return result;
+        }
+
+        static uint16_t toRgb565(const Pixel& pixel) {
+            const auto r = (pixel[0] * 31 + 127) / 255;
+            const auto g = (pixel[1] * 63 + 127) / 255;
+            const auto b = (pixel[2] * 31 + 127) / 255;
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        static Pixel fromRgb565(const uint16_t color) {
+            const auto r = (color >> 11) & 0x1F;
+            const auto g = (color >> 5) & 0x3F;
+            const auto b = color & 0x1F;
+            return Pixel{(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+        }
+
+        static std::array<Pixel, 4> colorPalette(const uint16_t color0, const uint16_t color1, const bool fourColors) {
+            const auto pixel0 = fromRgb565(color0);
+            const auto pixel1 = fromRgb565(color1);
+
+            auto result = std::array<Pixel, 4>{pixel0, pixel1, pixel0, pixel0};
+            for (size_t c = 0u; c < 3u; ++c) {
+                if (fourColors) {
+                    result[2][c] = (2 * pixel0[c] + pixel1[c]) / 3;
+                    result[3][c] = (pixel0[c] + 2 * pixel1[c]) / 3;
+                } else {
+                    result[2][c] = (pixel0[c] + pixel1[c]) / 2;
+                    result[3][c] = 0;
+                }
+            }
+            return result;
+        }
+
+        static std::array<int, 8> alphaPalette(const int alpha0, const int alpha1) {
+            if (alpha0 > alpha1) {
+                return {
+                    alpha0, alpha1,
+                    (6 * alpha0 + 1 * alpha1) / 7, (5 * alpha0 + 2 * alpha1) / 7,
+                    (4 * alpha0 + 3 * alpha1) / 7, (3 * alpha0 + 4 * alpha1) / 7,
+                    (2 * alpha0 + 5 * alpha1) / 7, (1 * alpha0 + 6 * alpha1) / 7
+                };
+            } else {
+                return {
+                    alpha0, alpha1,
+                    (4 * alpha0 + 1 * alpha1) / 5, (3 * alpha0 + 2 * alpha1) / 5,
+                    (2 * alpha0 + 3 * alpha1) / 5, (1 * alpha0 + 4 * alpha1) / 5,
+                    0, 255
+                };
+            }
+        }
+
+        static int squaredDistance(const Pixel& lhs, const Pixel& rhs) {
+            auto result = 0;
+            for (size_t c = 0u; c < 3u; ++c) {
+                result += (lhs[c] - rhs[c]) * (lhs[c] - rhs[c]);
+            }
+            return result;
+        }
+
+        /**
+         * Uses two opposite corners of the bounding box of the block's colors as the end points, choosing the diagonal
+         * along which the colors are spread. This is not optimal, but it is fast and good enough for textures in an
+         * editor.
+         */
+        static void compressColorBlock(const Block& block, unsigned char* dest) {
+            auto min = Pixel{255, 255, 255, 255};
+            auto max = Pixel{0, 0, 0, 0};
+            auto sum = Pixel{0, 0, 0, 0};
+            for (const auto& pixel : block) {
+                for (size_t c = 0u; c < 3u; ++c) {
+                    min[c] = std::min(min[c], pixel[c]);
+                    max[c] = std::max(max[c], pixel[c]);
+                    sum[c] += pixel[c];
+                }
+            }
+
+            // swap the end points of every component that decreases while the component with the largest range increases
+            size_t major = 0u;
+            for (size_t c = 1u; c < 3u; ++c) {
+                if (max[c] - min[c] > max[major] - min[major]) {
+                    major = c;
+                }
+            }
+            for (size_t c = 0u; c < 3u; ++c) {
+                auto covariance = 0;
+                for (const auto& pixel : block) {
+                    covariance += (16 * pixel[major] - sum[major]) * (16 * pixel[c] - sum[c]);
+                }
+                if (covariance < 0) {
+                    std::swap(min[c], max[c]);
+                }
+            }
+
+            // moving the end points inwards a little reduces the error for the colors in between
+            for (size_t c = 0u; c < 3u; ++c) {
+                const auto inset = (max[c] - min[c]) / 16;
+                min[c] += inset;
+                max[c] -= inset;
+            }
+
+            // the first color must be greater than the second color to select the mode with four colors
+            auto color0 = toRgb565(max);
+            auto color1 = toRgb565(min);
+            if (color0 < color1) {
+                std::swap(color0, color1);
+            }
+
+            uint32_t indices = 0u;
+            if (color0 != color1) {
+                const auto palette = colorPalette(color0, color1, true);
+                for (size_t i = 0u; i < block.size(); ++i) {
+                    auto bestIndex = uint32_t(0);
+                    auto bestDistance = std::numeric_limits<int>::max();
+                    for (uint32_t j = 0u; j < palette.size(); ++j) {
+                        const auto distance = squaredDistance(block[i], palette[j]);
+                        if (distance < bestDistance) {
+                            bestIndex = j;
+                            bestDistance = distance;
+                        }
+                    }
+                    indices |= bestIndex << (2u * i);
+                }
+            }
+
+            dest[0] = static_cast<unsigned char>(color0 & 0xFF);
+            dest[1] = static_cast<unsigned char>(color0 >> 8);
+            dest[2] = static_cast<unsigned char>(color1 & 0xFF);
+            dest[3] = static_cast<unsigned char>(color1 >> 8);
+            for (size_t i = 0u; i < 4u; ++i) {
+                dest[4u + i] = static_cast<unsigned char>((indices >> (8u * i)) & 0xFF);
+            }
+        }
+
+        static void compressAlphaBlock(const Block& block, unsigned char* dest) {
+            auto alpha0 = 0;
+            auto alpha1 = 255;
+            for (const auto& pixel : block) {
+                alpha0 = std::max(alpha0, pixel[3]);
+                alpha1 = std::min(alpha1, pixel[3]);
+            }
+
+            uint64_t indices = 0u;
+            if (alpha0 != alpha1) {
+                const auto palette = alphaPalette(alpha0, alpha1);
+                for (size_t i = 0u; i < block.size(); ++i) {
+                    auto bestIndex = uint64_t(0);
+                    auto bestDistance = std::numeric_limits<int>::max();
+                    for (uint64_t j = 0u; j < palette.size(); ++j) {
+                        const auto distance = std::abs(block[i][3] - palette[j]);
+                        if (distance < bestDistance) {
+                            bestIndex = j;
+                            bestDistance = distance;
+                        }
+                    }
+                    indices |= bestIndex << (3u * i);
+                }
+            }
+
+            dest[0] = static_cast<unsigned char>(alpha0);
+            dest[1] = static_cast<unsigned char>(alpha1);
+            for (size_t i = 0u; i < 6u; ++i) {
+                dest[2u + i] = static_cast<unsigned char>((indices >> (8u * i)) & 0xFF);
+            }
+        }
+
+        TextureBuffer compressMip(const TextureBuffer& buffer, const vm::vec2s& size, const GLenum format, const GLenum compressedFormat) {
+            ensure(isCompressedFormat(compressedFormat), "compressedFormat is a compressed format");
+            assert(buffer.size() == mipBufferSize(size, format));
+
+            auto result = TextureBuffer(mipBufferSize(size, compressedFormat));
+            auto* dest = result.data();
+            for (size_t blockY = 0u; blockY < blockCount(size.y()); ++blockY) {
+                for (size_t blockX = 0u; blockX < blockCount(size.x()); ++blockX) {
+                    const auto block = readBlock(buffer, size, format, blockX, blockY);
+                    if (compressedFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+                        compressAlphaBlock(block, dest);
+                        dest += 8u;
+                    }
+                    compressColorBlock(block, dest);
+                    dest += 8u;
+                }
+            }
+
+            return result;
+        }
+
+        TextureBuffer decompressMip(const TextureBuffer& buffer, const vm::vec2s& size, const GLenum compressedFormat) {
+            ensure(isCompressedFormat(compressedFormat), "compressedFormat is a compressed format");
+            assert(buffer.size() == mipBufferSize(size, compressedFormat));
+
+            const auto hasAlpha = compressedFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+            auto result = TextureBuffer(size.x() * size.y() * 4u);
+            const auto* src = buffer.data();
+            for (size_t blockY = 0u; blockY < blockCount(size.y()); ++blockY) {
+                for (size_t blockX = 0u; blockX < blockCount(size.x()); ++blockX) {
+                    auto alphas = std::array<int, BlockSize * BlockSize>{};
+                    alphas.fill(255);
+                    if (hasAlpha) {
+                        const auto palette = alphaPalette(src[0], src[1]);
+                        uint64_t indices = 0u;
+                        for (size_t i = 0u; i < 6u; ++i) {
+                            indices |= uint64_t(src[2u + i]) << (8u * i);
+                        }
+                        for (size_t i = 0u; i < alphas.size(); ++i) {
+                            alphas[i] = palette[(indices >> (3u * i)) & 0x7];
+                        }
+                        src += 8u;
+                    }
+
+                    const auto color0 = static_cast<uint16_t>(src[0] | (src[1] << 8));
+                    const auto color1 = static_cast<uint16_t>(src[2] | (src[3] << 8));
+                    const auto indices = uint32_t(src[4]) | (uint32_t(src[5]) << 8) | (uint32_t(src[6]) << 16) | (uint32_t(src[7]) << 24);
+                    // BC3 always uses the mode with four colors
+                    const auto palette = colorPalette(color0, color1, hasAlpha || color0 > color1);
+                    src += 8u;
+
+                    for (size_t i = 0u; i < BlockSize * BlockSize; ++i) {
+                        const auto x = blockX * BlockSize + i % BlockSize;
+                        const auto y = blockY * BlockSize + i / BlockSize;
+                        if (x < size.x() && y < size.y()) {
+                            const auto& color = palette[(indices >> (2u * i)) & 0x3];
+                            auto* dest = result.data() + (y * size.x() + x) * 4u;
+                            dest[0] = static_cast<unsigned char>(color[0]);
+                            dest[1] = static_cast<unsigned char>(color[1]);
+                            dest[2] = static_cast<unsigned char>(color[2]);
+                            dest[3] = static_cast<unsigned char>(alphas[i]);
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/GL.h"
+
+#include <vecmath/forward.h>
+
+#include <cstddef>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class TextureBuffer;
+
+        /**
+         * Indicates whether the given format is one of the S3TC formats GL_COMPRESSED_RGB_S3TC_DXT1_EXT (BC1) or
+         * GL_COMPRESSED_RGBA_S3TC_DXT5_EXT (BC3), which are the compressed formats that textures can have.
+         */
+        bool isCompressedFormat(GLenum format);
+
+        /**
+         * Indicates whether the GL context supports uploading S3TC compressed textures. Must be called with a current
+         * GL context. If this returns false, compressed textures are decompressed when they are uploaded.
+         */
+        bool compressedFormatsSupported();
+
+        /**
+         * Returns the number of bytes of a mipmap with the given size in the given format. Compressed mipmaps are
+         * stored in blocks of 4x4 pixels, so their dimensions are rounded up to multiples of 4.
+         */
+        size_t mipBufferSize(const vm::vec2s& size, GLenum format);
+
+        /**
+         * Compresses the given mipmap. Pixels with alpha values are compressed to BC3, all other pixels to BC1, which
+         * drops their alpha channel.
+         *
+         * @param buffer the mipmap to compress, must be tightly packed in the given format
+         * @param size the size of the given mipmap
+         * @param format the format of the given mipmap, one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA
+         * @param compressedFormat the format to compress to, GL_COMPRESSED_RGB_S3TC_DXT1_EXT or
+         * GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+         * @return the compressed mipmap
+         */
+        TextureBuffer compressMip(const TextureBuffer& buffer, const vm::vec2s& size, GLenum format, GLenum compressedFormat);
+
+        /**
+         * Decompresses the given mipmap to GL_RGBA.
+         *
+         * @param buffer the mipmap to decompress
+         * @param size the size of the given mipmap
+         * @param compressedFormat the format of the given mipmap, GL_COMPRESSED_RGB_S3TC_DXT1_EXT or
+         * GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+         * @return the decompressed mipmap
+         */
+        TextureBuffer decompressMip(const TextureBuffer& buffer, const vm::vec2s& size, GLenum compressedFormat);
+    }
+}
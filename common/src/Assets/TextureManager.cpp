@@ -22,10 +22,12 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureArray.h"
 #include "Assets/TextureCollection.h"
 #include "IO/TextureLoader.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
@@ -33,6 +35,7 @@
 #include <chrono>
 #include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -56,15 +59,28 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Approximates the number of bytes used by the given texture, including its mipmaps.
+         */
+        static size_t textureBytes(const Texture& texture) {
+            return texture.width() * texture.height() * 4u * 4u / 3u;
+        }
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
+        m_commitCount(0),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_lazyLoading(false),
+        m_useTextureArrays(false) {}
 
-        TextureManager::~TextureManager() = default;
+        TextureManager::~TextureManager() {
+            cancelLoadingLazyTextures();
+        }
 
         void TextureManager::setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader) {
+            cancelLoadingLazyTextures();
             auto collections = std::move(m_collections);
             clear();
 
@@ -73,7 +89,7 @@ namespace TrenchBroom {
                 if (it == std::end(collections) || !it->loaded()) {
                     try {
                         const auto startTime = std::chrono::high_resolution_clock::now();
-                        auto collection = loader.loadTextureCollection(path);
+                        auto collection = loader.loadTextureCollection(path, m_lazyLoading);
                         const auto endTime = std::chrono::high_resolution_clock::now();
 
                         m_logger.info() << "Loaded texture collection '" << path << "' in "
@@ -98,6 +114,7 @@ namespace TrenchBroom {
         }
 
         void TextureManager::setTextureCollections(std::vector<TextureCollection> collections) {
+            cancelLoadingLazyTextures();
             for (auto& collection : collections) {
                 addTextureCollection(std::move(collection));
             }
@@ -116,11 +133,15 @@ namespace TrenchBroom {
         }
 
         void TextureManager::clear() {
+            cancelLoadingLazyTextures();
             m_collections.clear();
 
             m_toPrepare.clear();
             m_texturesByName.clear();
             m_textures.clear();
+            m_lazyTextures.clear();
+            m_textureArrays.takeAddedTextures();
+            m_texturesWithChangedArrayLayers.clear();
 
             // Remove logging because it might fail when the document is already destroyed.
         }
@@ -131,10 +152,43 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        void TextureManager::setLazyLoading(const bool lazyLoading) {
+            m_lazyLoading = lazyLoading;
+        }
+
+        void TextureManager::setUseTextureArrays(const bool useTextureArrays) {
+            m_useTextureArrays = useTextureArrays;
+        }
+
+        void TextureManager::setCompressedTextureCache(std::shared_ptr<const IO::CompressedTextureCache> compressedTextureCache) {
+            m_compressedTextureCache = std::move(compressedTextureCache);
+        }
+
+        const std::shared_ptr<const IO::CompressedTextureCache>& TextureManager::compressedTextureCache() const {
+            return m_compressedTextureCache;
+        }
+
         void TextureManager::commitChanges() {
+            ++m_commitCount;
+
             resetTextureMode();
-            prepare();
+            const auto uploadedBytes = prepare(MaxUploadBytesPerCommit);
+            loadLazyTextures(MaxUploadBytesPerCommit - std::min(uploadedBytes, MaxUploadBytesPerCommit));
+            unloadUnusedLazyTextures();
             m_toRemove.clear();
+
+            const auto addedTextures = m_textureArrays.takeAddedTextures();
+            m_texturesWithChangedArrayLayers.insert(std::end(m_texturesWithChangedArrayLayers), std::begin(addedTextures), std::end(addedTextures));
+            m_textureArrays.removeEmptyArrays();
+        }
+
+        bool TextureManager::hasPendingChanges() const {
+            return !m_toPrepare.empty() || !m_toRemove.empty() || m_resetTextureMode || m_loadedTextureData.valid()
+                || std::any_of(std::begin(m_lazyTextures), std::end(m_lazyTextures), [&](const auto& lazyTexture) { return needsLoading(lazyTexture); });
+        }
+
+        std::vector<const Texture*> TextureManager::takeTexturesWithChangedArrayLayers() {
+            return std::exchange(m_texturesWithChangedArrayLayers, {});
         }
 
         const Texture* TextureManager::texture(const std::string& name) const {
@@ -163,16 +217,162 @@ namespace TrenchBroom {
                 for (auto& collection : m_collections) {
                     collection.setTextureMode(m_minFilter, m_magFilter);
                 }
+                m_textureArrays.setTextureMode(m_minFilter, m_magFilter);
                 m_resetTextureMode = false;
             }
         }
 
-        void TextureManager::prepare() {
-            for (const size_t index : m_toPrepare) {
-                auto& collection = m_collections[index];
-                collection.prepare(m_minFilter, m_magFilter);
+        TextureArrayPool* TextureManager::textureArrays() {
+            return m_useTextureArrays && TextureArray::supported() ? &m_textureArrays : nullptr;
+        }
+
+        size_t TextureManager::prepare(const size_t maxBytes) {
+            auto remainingBytes = maxBytes;
+
+            auto it = std::begin(m_toPrepare);
+            while (it != std::end(m_toPrepare) && remainingBytes > 0u) {
+                auto& collection = m_collections[*it];
+                const auto uploadedBytes = collection.prepare(m_minFilter, m_magFilter, remainingBytes, textureArrays());
+                remainingBytes -= std::min(uploadedBytes, remainingBytes);
+
+                if (!collection.prepared()) {
+                    break;
+                }
+                ++it;
             }
-            m_toPrepare.clear();
+
+            m_toPrepare.erase(std::begin(m_toPrepare), it);
+            return maxBytes - remainingBytes;
+        }
+
+        void TextureManager::loadLazyTextures(const size_t maxBytes) {
+            uploadLoadedLazyTextures();
+
+            // the textures which are being read are not loaded yet, but they must not be read again
+            const auto startLoading = !m_loadedTextureData.valid();
+            auto texturesToLoad = std::vector<LazyTexture>{};
+            size_t bytesToLoad = 0;
+
+            for (auto& lazyTexture : m_lazyTextures) {
+                auto& texture = *m_collections[lazyTexture.collectionIndex].textureByIndex(lazyTexture.textureIndex);
+
+                if (texture.usageCount() > 0 || texture.activated()) {
+                    lazyTexture.lastUse = m_commitCount;
+                    if (startLoading && !texture.loaded() && bytesToLoad < maxBytes) {
+                        texturesToLoad.push_back(lazyTexture);
+                        bytesToLoad += textureBytes(texture);
+                    }
+                }
+
+                // textures which are rendered again before the next commit will be activated again
+                texture.resetActivated();
+            }
+
+            if (!texturesToLoad.empty()) {
+                startLoadingLazyTextures(std::move(texturesToLoad));
+            }
+        }
+
+        void TextureManager::startLoadingLazyTextures(std::vector<LazyTexture> lazyTextures) {
+            assert(!m_loadedTextureData.valid());
+
+            // the worker must not access the textures, which are owned by this thread, so it reads the data using copies
+            // of their data readers
+            auto dataReaders = kdl::vec_transform(lazyTextures, [&](const auto& lazyTexture) {
+                return m_collections[lazyTexture.collectionIndex].textureByIndex(lazyTexture.textureIndex)->dataReader();
+            });
+
+            m_loadingTextures = std::move(lazyTextures);
+            m_loadedTextureData = std::async(std::launch::async, [dataReaders = std::move(dataReaders)]() {
+                auto result = std::vector<std::optional<Texture>>(dataReaders.size());
+
+                // exceptions thrown by the lambda would be swallowed by parallel_for
+                kdl::parallel_for(dataReaders.size(), [&](const size_t i) {
+                    try {
+                        result[i] = dataReaders[i]();
+                    } catch (const std::exception&) {
+                        result[i] = std::nullopt;
+                    }
+                });
+
+                return result;
+            });
+        }
+
+        void TextureManager::uploadLoadedLazyTextures() {
+            if (!m_loadedTextureData.valid() || m_loadedTextureData.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return;
+            }
+
+            auto loadedTextureData = m_loadedTextureData.get();
+            for (size_t i = 0; i < m_loadingTextures.size(); ++i) {
+                const auto& lazyTexture = m_loadingTextures[i];
+                auto& collection = m_collections[lazyTexture.collectionIndex];
+                const auto& texture = *collection.textureByIndex(lazyTexture.textureIndex);
+
+                // the texture keeps its dimensions and is rendered without data if its data could not be read
+                auto data = std::move(loadedTextureData[i]);
+                if (!data.has_value()) {
+                    data = Texture(texture.name(), 1, 1);
+                }
+
+                collection.loadTexture(lazyTexture.textureIndex, std::move(*data), m_minFilter, m_magFilter, textureArrays());
+            }
+
+            // forward the messages that the data readers logged on the worker threads
+            for (auto& collection : m_collections) {
+                collection.flushLazyTextureLog();
+            }
+
+            m_loadingTextures.clear();
+        }
+
+        void TextureManager::cancelLoadingLazyTextures() {
+            if (m_loadedTextureData.valid()) {
+                // waits until the worker has finished, the data readers don't refer to the textures
+                m_loadedTextureData = {};
+                m_loadingTextures.clear();
+            }
+        }
+
+        void TextureManager::unloadUnusedLazyTextures() {
+            auto unusedTextures = std::vector<LazyTexture*>();
+            size_t unusedBytes = 0;
+
+            for (auto& lazyTexture : m_lazyTextures) {
+                const auto& texture = *m_collections[lazyTexture.collectionIndex].textureByIndex(lazyTexture.textureIndex);
+                if (texture.loaded() && texture.usageCount() == 0 && lazyTexture.lastUse < m_commitCount) {
+                    unusedTextures.push_back(&lazyTexture);
+                    unusedBytes += textureBytes(texture);
+                }
+            }
+
+            if (unusedBytes > MaxUnusedLazyTextureBytes) {
+                std::sort(std::begin(unusedTextures), std::end(unusedTextures), [](const auto* lhs, const auto* rhs) {
+                    return lhs->lastUse < rhs->lastUse;
+                });
+
+                for (auto* lazyTexture : unusedTextures) {
+                    if (unusedBytes <= MaxUnusedLazyTextureBytes) {
+                        break;
+                    }
+
+                    auto& collection = m_collections[lazyTexture->collectionIndex];
+                    const auto& texture = *collection.textureByIndex(lazyTexture->textureIndex);
+                    unusedBytes -= textureBytes(texture);
+
+                    // unloading releases the texture's array layer
+                    if (texture.textureArray() != nullptr) {
+                        m_texturesWithChangedArrayLayers.push_back(&texture);
+                    }
+                    collection.unloadTexture(lazyTexture->textureIndex);
+                }
+            }
+        }
+
+        bool TextureManager::needsLoading(const LazyTexture& lazyTexture) const {
+            const auto& texture = *m_collections[lazyTexture.collectionIndex].textureByIndex(lazyTexture.textureIndex);
+            return !texture.loaded() && (texture.usageCount() > 0 || texture.activated());
         }
 
         void TextureManager::updateTextures() {
@@ -195,6 +395,16 @@ namespace TrenchBroom {
             }
 
             m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) { return const_cast<const Texture*>(t); });
+
+            m_lazyTextures.clear();
+            for (size_t i = 0; i < m_collections.size(); ++i) {
+                const auto& textures = m_collections[i].textures();
+                for (size_t j = 0; j < textures.size(); ++j) {
+                    if (textures[j].lazy() && !textures[j].overridden()) {
+                        m_lazyTextures.push_back(LazyTexture{i, j, 0});
+                    }
+                }
+            }
         }
     }
 }
@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include "Assets/TextureArrayPool.h"
 #include "Assets/TextureCollection.h"
 
+#include <future>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -29,6 +33,7 @@ namespace TrenchBroom {
     class Logger;
 
     namespace IO {
+        class CompressedTextureCache;
         class Path;
         class TextureLoader;
     }
@@ -41,8 +46,29 @@ namespace TrenchBroom {
         private:
             using TextureMap = std::map<std::string, Texture*>;
 
+            /**
+             * The maximum number of bytes of texture data to upload per call to commitChanges. The remaining textures
+             * are uploaded by later calls, and until then, they are rendered using their average color.
+             */
+            static constexpr size_t MaxUploadBytesPerCommit = 16u * 1024u * 1024u;
+
+            /**
+             * Loaded lazy textures which are not used by any face and were not rendered by the last commit are unloaded,
+             * least recently used first, once they take up more than this number of bytes.
+             */
+            static constexpr size_t MaxUnusedLazyTextureBytes = 128u * 1024u * 1024u;
+
+            struct LazyTexture {
+                size_t collectionIndex;
+                size_t textureIndex;
+                size_t lastUse;
+            };
+
             Logger& m_logger;
 
+            // must be declared before the collections so that it is destroyed after their textures release their layers
+            TextureArrayPool m_textureArrays;
+
             std::vector<TextureCollection> m_collections;
 
             std::vector<size_t> m_toPrepare;
@@ -51,9 +77,32 @@ namespace TrenchBroom {
             TextureMap m_texturesByName;
             std::vector<const Texture*> m_textures;
 
+            /**
+             * The lazy textures which are not overridden by a texture with the same name.
+             */
+            std::vector<LazyTexture> m_lazyTextures;
+            size_t m_commitCount;
+
+            /**
+             * The data of lazy textures is read on worker threads so that decoding does not block rendering. At most
+             * one batch of textures is read at a time, and its data is uploaded by the first commit after it has been
+             * read.
+             */
+            std::vector<LazyTexture> m_loadingTextures;
+            std::future<std::vector<std::optional<Texture>>> m_loadedTextureData;
+
+            /**
+             * The textures which were added to or removed from a texture array since the last call to
+             * takeTexturesWithChangedArrayLayers.
+             */
+            std::vector<const Texture*> m_texturesWithChangedArrayLayers;
+
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+            bool m_lazyLoading;
+            bool m_useTextureArrays;
+            std::shared_ptr<const IO::CompressedTextureCache> m_compressedTextureCache;
         public:
             TextureManager(int magFilter, int minFilter, Logger& logger);
             ~TextureManager();
@@ -66,8 +115,48 @@ namespace TrenchBroom {
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Specifies whether texture collections which are loaded from now on only read the names and dimensions of
+             * their textures. The data of such a lazy texture is read and uploaded once a face uses it or it is
+             * rendered, and it is unloaded again when it is no longer needed.
+             */
+            void setLazyLoading(bool lazyLoading);
+
+            /**
+             * Specifies whether textures which are uploaded from now on are also copied into texture arrays, so that
+             * the faces of many textures can be rendered with a single draw call. This requires additional texture
+             * memory and has no effect if texture arrays are not supported by the GL context.
+             */
+            void setUseTextureArrays(bool useTextureArrays);
+
+            /**
+             * Sets the cache in which image textures that are loaded from now on are stored after they have been
+             * compressed. If the cache is null, image textures are not compressed.
+             */
+            void setCompressedTextureCache(std::shared_ptr<const IO::CompressedTextureCache> compressedTextureCache);
+            const std::shared_ptr<const IO::CompressedTextureCache>& compressedTextureCache() const;
+
+            /**
+             * Uploads pending textures to the GPU, but at most MaxUploadBytesPerCommit bytes (or a single texture if
+             * it exceeds that budget), and applies any changed texture mode. Must be called with a current GL context.
+             */
             void commitChanges();
 
+            /**
+             * Indicates whether some changes have not been committed yet. If this returns true after commitChanges was
+             * called, then some textures are still waiting to be read or uploaded, and the caller should render again
+             * soon.
+             */
+            bool hasPendingChanges() const;
+
+            /**
+             * Returns the textures which were added to or removed from a texture array by the commits since the last
+             * call, and forgets them. Faces with these textures must be staged for rendering again, since the texture
+             * array and the layer of a face's texture are only read when the face is staged.
+             */
+            std::vector<const Texture*> takeTexturesWithChangedArrayLayers();
+
             const Texture* texture(const std::string& name) const;
             Texture* texture(const std::string& name);
             
@@ -75,7 +164,14 @@ namespace TrenchBroom {
             const std::vector<TextureCollection>& collections() const;
         private:
             void resetTextureMode();
-            void prepare();
+            TextureArrayPool* textureArrays();
+            size_t prepare(size_t maxBytes);
+            void loadLazyTextures(size_t maxBytes);
+            void startLoadingLazyTextures(std::vector<LazyTexture> lazyTextures);
+            void uploadLoadedLazyTextures();
+            void cancelLoadingLazyTextures();
+            void unloadUnusedLazyTextures();
+            bool needsLoading(const LazyTexture& lazyTexture) const;
 
             void updateTextures();
         };
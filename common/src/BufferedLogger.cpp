@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferedLogger.h"
+
+#include <string>
+#include <utility>
+
+namespace TrenchBroom {
+    BufferedLogger::BufferedLogger(Logger& logger) :
+    m_logger(logger),
+    m_threadId(std::this_thread::get_id()) {}
+
+    void BufferedLogger::flush() {
+        auto messages = std::vector<Message>{};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(messages, m_messages);
+        }
+
+        for (const auto& message : messages) {
+            m_logger.log(message.level, message.str);
+        }
+    }
+
+    void BufferedLogger::doLog(const LogLevel level, const std::string& message) {
+        doLog(level, QString::fromStdString(message));
+    }
+
+    void BufferedLogger::doLog(const LogLevel level, const QString& message) {
+        if (std::this_thread::get_id() == m_threadId) {
+            m_logger.log(level, message);
+        } else {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_messages.push_back(Message{level, message});
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Logger.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <QString>
+
+namespace TrenchBroom {
+    /**
+     * A logger that can be used from several threads at the same time. Messages logged on the thread that created this
+     * logger are forwarded to another logger immediately. Messages logged on other threads are stored until they are
+     * forwarded by calling flush, which must only be called on the thread that created this logger.
+     */
+    class BufferedLogger : public Logger {
+    private:
+        struct Message {
+            LogLevel level;
+            QString str;
+        };
+
+        Logger& m_logger;
+        std::thread::id m_threadId;
+        std::mutex m_mutex;
+        std::vector<Message> m_messages;
+    public:
+        explicit BufferedLogger(Logger& logger);
+
+        /**
+         * Forwards all stored messages to the target logger in the order in which they were logged.
+         */
+        void flush();
+    private:
+        void doLog(LogLevel level, const std::string& message) override;
+        void doLog(LogLevel level, const QString& message) override;
+
+        deleteCopyAndMove(BufferedLogger)
+    };
+}
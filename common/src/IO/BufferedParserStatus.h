@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/ParserStatus.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    enum class LogLevel;
+
+    namespace IO {
+        /**
+         * A parser status that records all messages instead of logging them, so that parsing can happen on a worker
+         * thread. The recorded messages are formatted using the prefix of the given target status, and they can later be
+         * passed on to the target status on the thread that owns it. Progress is not reported.
+         */
+        class BufferedParserStatus : public ParserStatus {
+        private:
+            ParserStatus& m_target;
+            std::vector<std::pair<LogLevel, std::string>> m_messages;
+        public:
+            explicit BufferedParserStatus(ParserStatus& target);
+
+            /**
+             * Passes all recorded messages to the target status in the order in which they were recorded, and clears the
+             * recorded messages.
+             */
+            void replay();
+        private:
+            void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
+        };
+    }
+}
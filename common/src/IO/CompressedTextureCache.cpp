@@ -0,0 +1,240 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompressedTextureCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCompression.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+
+#include <vecmath/vec.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string Magic = "TBTC";
+        static const uint32_t Version = 1u;
+
+        static const std::string CacheFileExtension = "tbtex";
+
+        CompressedTextureCache::CompressedTextureCache(const Path& directory, const size_t maxBytes) :
+        m_directory(directory),
+        m_maxBytes(maxBytes),
+        m_bytesWrittenSinceTrim(0) {
+            // removes the files which were not used recently in previous sessions
+            trim();
+        }
+
+        const Path& CompressedTextureCache::directory() const {
+            return m_directory;
+        }
+
+        size_t CompressedTextureCache::maxBytes() const {
+            return m_maxBytes;
+        }
+
+        /**
+         * 64 bit FNV-1a hash.
+         */
+        static uint64_t hashBytes(const char* begin, const char* end, uint64_t hash = 14695981039346656037ull) {
+            for (const auto* cur = begin; cur != end; ++cur) {
+                hash ^= static_cast<unsigned char>(*cur);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::string CompressedTextureCache::makeKey(const FileSystem& fs, const File& file) {
+            std::stringstream str;
+            if (fs.canMakeAbsolute(file.path())) {
+                const auto absolutePath = fs.makeAbsolute(file.path());
+                str << absolutePath.asString() << "|" << Disk::fileModificationTime(absolutePath) << "|" << file.size();
+            } else {
+                const auto reader = file.reader().buffer();
+                str << file.path().asString() << "|" << file.size() << "|" << hashBytes(reader.begin(), reader.end());
+            }
+            return str.str();
+        }
+
+        std::optional<Assets::Texture> CompressedTextureCache::readTexture(const std::string& key, const std::string& textureName) const {
+            try {
+                const auto path = cacheFilePath(key);
+                if (!Disk::fileExists(path)) {
+                    return std::nullopt;
+                }
+
+                const auto file = Disk::openFile(path);
+                auto reader = file->reader().buffer();
+                if (reader.readString(Magic.size()) != Magic || reader.readSize<uint32_t>() != Version) {
+                    return std::nullopt;
+                }
+
+                // the file name is only a hash of the key, so the key is stored to detect collisions
+                const auto keyLength = reader.readSize<uint32_t>();
+                if (reader.readString(keyLength) != key) {
+                    return std::nullopt;
+                }
+
+                const auto width = reader.readSize<uint32_t>();
+                const auto height = reader.readSize<uint32_t>();
+                const auto format = reader.read<uint32_t, GLenum>();
+                const auto type = reader.readSize<uint32_t>() == 0u ? Assets::TextureType::Opaque : Assets::TextureType::Masked;
+                const auto r = reader.readFloat<float>();
+                const auto g = reader.readFloat<float>();
+                const auto b = reader.readFloat<float>();
+                const auto a = reader.readFloat<float>();
+
+                if (width == 0u || height == 0u || !Assets::isCompressedFormat(format)) {
+                    return std::nullopt;
+                }
+
+                const auto mipCount = reader.readSize<uint32_t>();
+                auto buffers = Assets::TextureBufferList{};
+                for (size_t level = 0u; level < mipCount; ++level) {
+                    const auto size = reader.readSize<uint32_t>();
+                    if (size != Assets::mipBufferSize(Assets::sizeAtMipLevel(width, height, level), format)) {
+                        return std::nullopt;
+                    }
+
+                    auto buffer = Assets::TextureBuffer(size);
+                    reader.read(buffer.data(), size);
+                    buffers.push_back(std::move(buffer));
+                }
+
+                if (buffers.empty()) {
+                    return std::nullopt;
+                }
+
+                // the modification time of a cache file is the time it was last used, see trim
+                QFile touchFile(pathAsQString(path));
+                if (touchFile.open(QIODevice::Append)) {
+                    touchFile.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+                }
+
+                return Assets::Texture(textureName, width, height, Color(r, g, b, a), std::move(buffers), format, type);
+            } catch (const Exception&) {
+                // the file is damaged or was replaced while it was read, so the texture must be read from its image
+                return std::nullopt;
+            }
+        }
+
+        template <typename T>
+        static void write(QIODevice& device, const T value) {
+            device.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void write(QIODevice& device, const std::string& str) {
+            device.write(str.data(), static_cast<qint64>(str.size()));
+        }
+
+        void CompressedTextureCache::writeTexture(const std::string& key, const Assets::Texture& texture) const {
+            assert(texture.compressed());
+
+            Disk::ensureDirectoryExists(m_directory);
+
+            // the data is written to a unique temporary file in the same directory which replaces the cache file when
+            // it is committed, so that other threads and processes never read a partially written texture
+            const auto path = cacheFilePath(key);
+            QSaveFile file(pathAsQString(path));
+            if (!file.open(QIODevice::WriteOnly)) {
+                throw FileSystemException("Could not open file '" + path.asString() + "' for writing");
+            }
+
+            write(file, Magic);
+            write(file, Version);
+            write(file, static_cast<uint32_t>(key.size()));
+            write(file, key);
+
+            write(file, static_cast<uint32_t>(texture.width()));
+            write(file, static_cast<uint32_t>(texture.height()));
+            write(file, static_cast<uint32_t>(texture.format()));
+            write(file, static_cast<uint32_t>(texture.type() == Assets::TextureType::Opaque ? 0u : 1u));
+
+            const auto& color = texture.averageColor();
+            write(file, color.r());
+            write(file, color.g());
+            write(file, color.b());
+            write(file, color.a());
+
+            const auto& buffers = texture.buffersIfUnprepared();
+            write(file, static_cast<uint32_t>(buffers.size()));
+            for (const auto& buffer : buffers) {
+                write(file, static_cast<uint32_t>(buffer.size()));
+                file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<qint64>(buffer.size()));
+            }
+
+            // commit discards the temporary file if any write failed
+            const auto fileSize = static_cast<size_t>(file.size());
+            if (!file.commit()) {
+                throw FileSystemException("Could not write file '" + path.asString() + "'");
+            }
+
+            const auto bytesWrittenSinceTrim = m_bytesWrittenSinceTrim += fileSize;
+            if (bytesWrittenSinceTrim > m_maxBytes / 4u) {
+                trim();
+            }
+        }
+
+        void CompressedTextureCache::trim() const {
+            // if another thread is trimming the cache already, there is no need to wait for it
+            auto lock = std::unique_lock<std::mutex>(m_trimMutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return;
+            }
+            m_bytesWrittenSinceTrim = 0;
+
+            // least recently used first
+            const auto dir = QDir(pathAsQString(m_directory));
+            const auto fileInfos = dir.entryInfoList({QString::fromStdString("*." + CacheFileExtension)}, QDir::Files, QDir::Time | QDir::Reversed);
+
+            size_t totalBytes = 0;
+            for (const auto& fileInfo : fileInfos) {
+                totalBytes += static_cast<size_t>(fileInfo.size());
+            }
+
+            for (auto it = fileInfos.begin(); it != fileInfos.end() && totalBytes > m_maxBytes; ++it) {
+                if (QFile::remove(it->absoluteFilePath())) {
+                    totalBytes -= static_cast<size_t>(it->size());
+                }
+            }
+        }
+
+        Path CompressedTextureCache::cacheFilePath(const std::string& key) const {
+            std::stringstream str;
+            str << std::hex << hashBytes(key.data(), key.data() + key.size()) << "." << CacheFileExtension;
+            return m_directory + Path(str.str());
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/Path.h"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace IO {
+        class File;
+        class FileSystem;
+
+        /**
+         * Stores compressed textures in a directory on disk so that they don't have to be decoded and compressed again
+         * when they are loaded the next time. Every texture is stored in a file of its own whose name is derived from
+         * the key of the image file it was read from.
+         *
+         * The size of the cache is bounded. Whenever the files written since the last time exceed a quarter of the
+         * maximum size, the least recently used files are removed until the cache fits into its maximum size again.
+         * This also removes the files of images which have been modified or deleted, because their keys are never
+         * used again.
+         *
+         * The cache can be used by several threads at once.
+         */
+        class CompressedTextureCache {
+        public:
+            static constexpr size_t DefaultMaxBytes = 1024u * 1024u * 1024u;
+        private:
+            Path m_directory;
+            size_t m_maxBytes;
+
+            mutable std::atomic<size_t> m_bytesWrittenSinceTrim;
+            mutable std::mutex m_trimMutex;
+        public:
+            /**
+             * Creates a cache that stores its files in the given directory and removes the least recently used files
+             * if the directory holds more than the given number of bytes. The directory is created when the first
+             * texture is written.
+             */
+            explicit CompressedTextureCache(const Path& directory, size_t maxBytes = DefaultMaxBytes);
+
+            const Path& directory() const;
+            size_t maxBytes() const;
+
+            /**
+             * Returns the key of the given image file. If the file is stored on disk, the key consists of its absolute
+             * path, its modification time and its size. Otherwise, e.g. for files in archives, the key consists of its
+             * path, its size and a hash of its contents.
+             *
+             * @param fs the file system that the file was opened from
+             * @param file the image file
+             * @return the key
+             */
+            static std::string makeKey(const FileSystem& fs, const File& file);
+
+            /**
+             * Reads the texture with the given key from the cache and marks its file as recently used.
+             *
+             * @param key the key of the image file that the texture was read from
+             * @param textureName the name of the returned texture
+             * @return the texture, or an empty optional if the cache does not contain a valid texture for the key
+             */
+            std::optional<Assets::Texture> readTexture(const std::string& key, const std::string& textureName) const;
+
+            /**
+             * Writes the given texture to the cache, replacing any texture with the same key.
+             *
+             * @param key the key of the image file that the texture was read from
+             * @param texture the texture to write, must be compressed and not prepared
+             *
+             * @throws FileSystemException if the texture cannot be written
+             */
+            void writeTexture(const std::string& key, const Assets::Texture& texture) const;
+
+            /**
+             * Removes the least recently used files until the files of this cache take up at most the maximum number
+             * of bytes. Files which cannot be removed, e.g. because they are being read, are skipped.
+             */
+            void trim() const;
+        private:
+            Path cacheFilePath(const std::string& key) const;
+        };
+    }
+}
@@ -30,6 +30,7 @@
 #include <fstream>
 #include <string>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
@@ -117,6 +118,15 @@ namespace TrenchBroom {
                 return fileInfo.exists() && fileInfo.isFile();
             }
 
+            std::int64_t fileModificationTime(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                QFileInfo fileInfo = QFileInfo(pathAsQString(fixedPath));
+                if (!fileInfo.exists() || !fileInfo.isFile()) {
+                    throw FileNotFoundException(fixedPath.asString());
+                }
+                return static_cast<std::int64_t>(fileInfo.lastModified().toMSecsSinceEpoch());
+            }
+
             std::vector<Path> getDirectoryContents(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 QDir dir(pathAsQString(fixedPath));
@@ -139,7 +149,12 @@ namespace TrenchBroom {
                     throw FileNotFoundException(fixedPath.asString());
                 }
 
-                return std::make_shared<CFile>(fixedPath);
+                try {
+                    return std::make_shared<MappedFile>(fixedPath);
+                } catch (const FileSystemException&) {
+                    // not every file can be mapped, e.g. files on some network shares, so read those through the C API
+                    return std::make_shared<CFile>(fixedPath);
+                }
             }
 
             std::string readTextFile(const Path& path) {
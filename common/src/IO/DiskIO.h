@@ -21,6 +21,7 @@
 
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -36,6 +37,13 @@ namespace TrenchBroom {
             bool directoryExists(const Path& path);
             bool fileExists(const Path& path);
 
+            /**
+             * Returns the time when the given file was last modified in milliseconds since the epoch.
+             *
+             * @throws FileNotFoundException if the file does not exist
+             */
+            std::int64_t fileModificationTime(const Path& path);
+
             std::vector<Path> getDirectoryContents(const Path& path);
             std::shared_ptr<File> openFile(const Path& path);
             std::string readTextFile(const Path& path);
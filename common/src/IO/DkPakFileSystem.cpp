@@ -117,7 +117,7 @@ namespace TrenchBroom {
                 if (compressed) {
                     m_root.addFile(entryPath, std::make_unique<DkCompressedFile>(entryFile, uncompressedSize));
                 } else {
-                    m_root.addFile(entryPath, std::make_unique<SimpleFileEntry>(entryFile));
+                    m_root.addFile(entryPath, std::make_unique<BufferedFileEntry>(entryFile));
                 }
             }
         }
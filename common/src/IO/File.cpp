@@ -21,6 +21,9 @@
 
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+
+#include <QFile>
 
 namespace TrenchBroom {
     namespace IO {
@@ -90,6 +93,46 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_file(std::make_shared<QFile>(pathAsQString(path))),
+        m_begin(nullptr),
+        m_end(nullptr) {
+            if (!m_file->open(QIODevice::ReadOnly)) {
+                throw FileSystemException("Cannot open file " + path.asString());
+            }
+
+            // empty files cannot be mapped
+            const auto size = static_cast<size_t>(m_file->size());
+            if (size > 0u) {
+                const auto* data = m_file->map(0, m_file->size());
+                if (data == nullptr) {
+                    throw FileSystemException("Cannot map file " + path.asString() + ": " + m_file->errorString().toStdString());
+                }
+                m_begin = reinterpret_cast<const char*>(data);
+                m_end = m_begin + size;
+            }
+        }
+
+        // closing the file also unmaps it, which happens when the last reader of this file is destroyed
+        MappedFile::~MappedFile() = default;
+
+        Reader MappedFile::reader() const {
+            return Reader::from(m_begin, m_end, m_file);
+        }
+
+        size_t MappedFile::size() const {
+            return static_cast<size_t>(m_end - m_begin);
+        }
+
+        const char* MappedFile::begin() const {
+            return m_begin;
+        }
+
+        const char* MappedFile::end() const {
+            return m_end;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -25,6 +25,8 @@
 #include <cstdio>
 #include <memory>
 
+class QFile;
+
 namespace TrenchBroom {
     namespace IO {
         /**
@@ -133,6 +135,45 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is opened and mapped
+         * in the constructor and unmapped and closed in the destructor.
+         *
+         * Readers of this file and of views into this file read directly from the mapped memory, so that buffering a
+         * reader does not copy the file contents, and the operating system only loads those parts of the file into
+         * memory that are actually read. These readers share the ownership of the mapping, so it stays valid until
+         * this file and all of its readers and buffered readers are destroyed.
+         */
+        class MappedFile : public File {
+        private:
+            std::shared_ptr<QFile> m_file;
+            const char* m_begin;
+            const char* m_end;
+        public:
+            /**
+             * Creates a new file with the given path, opens the file for reading and maps it into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            Reader reader() const override;
+            size_t size() const override;
+
+            /**
+             * Returns the start of the mapped memory.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the mapped memory (position after the last byte).
+             */
+            const char* end() const;
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
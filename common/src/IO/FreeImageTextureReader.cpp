@@ -25,15 +25,19 @@
 #include "FreeImage.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
+#include "IO/CompressedTextureCache.h"
 #include "IO/File.h"
 #include "IO/ImageLoaderImpl.h"
 
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
-        FreeImageTextureReader::FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger) :
-        TextureReader(nameStrategy, fs, logger) {}
+        FreeImageTextureReader::FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache) :
+        TextureReader(nameStrategy, fs, logger),
+        m_textureCache(std::move(textureCache)) {}
 
         /**
          * The byte order of a 32bpp FIBITMAP is defined by the macros FI_RGBA_RED,
@@ -77,6 +81,35 @@ namespace TrenchBroom {
         }
 
         Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
+            if (!m_textureCache) {
+                return readImage(file);
+            }
+
+            auto key = std::string();
+            try {
+                key = CompressedTextureCache::makeKey(m_fs, *file);
+            } catch (const Exception&) {
+                // the file cannot be identified, so it is read without the cache
+                return readImage(file);
+            }
+
+            if (auto cachedTexture = m_textureCache->readTexture(key, textureName(file->path()))) {
+                return std::move(*cachedTexture);
+            }
+
+            auto texture = readImage(file);
+            texture.compress();
+
+            try {
+                m_textureCache->writeTexture(key, texture);
+            } catch (const Exception& e) {
+                m_logger.warn() << "Could not cache texture '" << texture.name() << "': " << e.what();
+            }
+
+            return texture;
+        }
+
+        Assets::Texture FreeImageTextureReader::readImage(std::shared_ptr<File> file) const {
             auto reader = file->reader().buffer();
 
             InitFreeImage::initialize();
@@ -141,5 +174,43 @@ namespace TrenchBroom {
 
             return Assets::Texture(textureName(path), imageWidth, imageHeight, averageColor, std::move(buffers), format, textureType);
         }
+
+        std::optional<Assets::Texture> FreeImageTextureReader::doReadTextureHeader(std::shared_ptr<File> file) const {
+            auto reader = file->reader().buffer();
+
+            InitFreeImage::initialize();
+
+            const auto* begin       = reader.begin();
+            const auto* end         = reader.end();
+            const auto  imageSize   = static_cast<size_t>(end - begin);
+                  auto* imageBegin  = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+                  auto* imageMemory = FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize));
+            const auto  imageFormat = FreeImage_GetFileTypeFromMemory(imageMemory);
+
+            // only read the header if the image format supports it
+            if (!FreeImage_FIFSupportsNoPixels(imageFormat)) {
+                FreeImage_CloseMemory(imageMemory);
+                return std::nullopt;
+            }
+
+            auto* image = FreeImage_LoadFromMemory(imageFormat, imageMemory, FIF_LOAD_NOPIXELS);
+            if (image == nullptr) {
+                FreeImage_CloseMemory(imageMemory);
+                return std::nullopt;
+            }
+
+            const auto imageWidth  = static_cast<size_t>(FreeImage_GetWidth(image));
+            const auto imageHeight = static_cast<size_t>(FreeImage_GetHeight(image));
+
+            FreeImage_Unload(image);
+            FreeImage_CloseMemory(imageMemory);
+
+            if (!checkTextureDimensions(imageWidth, imageHeight)) {
+                return std::nullopt;
+            }
+
+            constexpr auto format = freeImage32BPPFormatToGLFormat();
+            return Assets::Texture(textureName(file->path()), imageWidth, imageHeight, format);
+        }
     }
 }
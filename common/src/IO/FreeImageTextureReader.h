@@ -23,19 +23,31 @@
 #include "IO/TextureReader.h"
 
 #include <memory>
+#include <optional>
 
 namespace TrenchBroom {
     class Logger;
     
     namespace IO {
+        class CompressedTextureCache;
         class File;
         class FileSystem;
 
         class FreeImageTextureReader : public TextureReader {
+        private:
+            std::shared_ptr<const CompressedTextureCache> m_textureCache;
         public:
-            explicit FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
+            /**
+             * Creates a reader for images in the formats supported by FreeImage.
+             *
+             * If a texture cache is given, the textures are compressed after they are read, and they are stored in
+             * and read from the given cache.
+             */
+            explicit FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache = nullptr);
         private:
             Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture readImage(std::shared_ptr<File> file) const;
+            std::optional<Assets::Texture> doReadTextureHeader(std::shared_ptr<File> file) const override;
         };
     }
 }
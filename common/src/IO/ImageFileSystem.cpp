@@ -41,6 +41,16 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        ImageFileSystemBase::BufferedFileEntry::BufferedFileEntry(std::shared_ptr<File> file) :
+        m_file(std::move(file)) {}
+
+        std::shared_ptr<File> ImageFileSystemBase::BufferedFileEntry::doOpen() const {
+            const auto size = m_file->size();
+            auto data = std::make_unique<char[]>(size);
+            m_file->reader().read(data.get(), size);
+            return std::make_shared<OwningBufferFile>(m_file->path(), std::move(data), size);
+        }
+
         ImageFileSystemBase::CompressedFileEntry::CompressedFileEntry(std::shared_ptr<File> file, const size_t uncompressedSize) :
         m_file(file),
         m_uncompressedSize(uncompressedSize) {}
@@ -195,11 +205,16 @@ namespace TrenchBroom {
 
         std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
             const auto searchPath = path.makeLowerCase().makeCanonical();
+
+            const auto lock = std::lock_guard<std::mutex>(m_openFileMutex);
             return m_root.findFile(path).open();
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
         ImageFileSystemBase(std::move(next), path),
+        // the archive is not mapped into memory because it stays open for as long as this file system exists, and such
+        // a long-lived mapping prevents other programs from replacing the file on Windows, and causes a crash on other
+        // platforms if the file is truncated
         m_file(std::make_shared<CFile>(path)) {
             ensure(m_path.isAbsolute(), "path must be absolute");
         }
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom {
     namespace IO {
@@ -52,6 +53,19 @@ namespace TrenchBroom {
                 std::shared_ptr<File> doOpen() const override;
             };
 
+            /**
+             * An entry of an archive whose contents are read into memory when it is opened, so that the returned file
+             * does not read from the archive file, which is shared by all entries.
+             */
+            class BufferedFileEntry : public FileEntry {
+            private:
+                std::shared_ptr<File> m_file;
+            public:
+                explicit BufferedFileEntry(std::shared_ptr<File> file);
+            private:
+                std::shared_ptr<File> doOpen() const override;
+            };
+
             class CompressedFileEntry : public FileEntry {
             private:
                 std::shared_ptr<File> m_file;
@@ -90,6 +104,12 @@ namespace TrenchBroom {
         protected:
             Path m_path;
             Directory m_root;
+        private:
+            /**
+             * Opening an entry reads from the archive file, which is shared by all entries, and files can be opened on
+             * several threads, e.g. when lazy textures are read.
+             */
+            mutable std::mutex m_openFileMutex;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
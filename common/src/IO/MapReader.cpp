@@ -19,6 +19,7 @@
 
 #include "MapReader.h"
 
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
@@ -32,6 +33,7 @@
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 
+#include <kdl/invoke.h>
 #include <kdl/map_utils.h>
 #include <kdl/overload.h>
 #include <kdl/parallel.h>
@@ -40,9 +42,17 @@
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace TrenchBroom {
@@ -71,15 +81,312 @@ namespace TrenchBroom {
             return m_id;
         }
 
+        /**
+         * Parses a block of consecutive brushes on a worker thread. The block is parsed in the context of the entire
+         * source so that the tokens have the same positions as if the block was parsed by the reader that owns it.
+         */
+        class MapReader::BrushBlockReader : public MapReader {
+        public:
+            BrushBlockReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const TokenizerState& begin, const TokenizerState& end) :
+            MapReader(str, sourceMapFormat, targetMapFormat) {
+                restrictTo({ begin, str.data(), end.cur });
+            }
+
+            std::vector<BrushInfo> read(ParserStatus& status) {
+                parseBrushes(status);
+                return std::move(m_brushInfos);
+            }
+        private: // the brushes are only parsed, so no nodes are ever created
+            Model::Node* onWorldspawn(const std::vector<Model::EntityProperty>& /* properties */, const ExtraAttributes& /* extraAttributes */, ParserStatus& /* status */) override { return nullptr; }
+            void onWorldspawnFilePosition(size_t /* startLine */, size_t /* lineCount */, ParserStatus& /* status */) override {}
+            void onLayer(Model::LayerNode* /* layer */, ParserStatus& /* status */) override {}
+            void onNode(Model::Node* /* parent */, Model::Node* /* node */, ParserStatus& /* status */) override {}
+            void onUnresolvedNode(const ParentInfo& /* parentInfo */, Model::Node* /* node */, ParserStatus& /* status */) override {}
+            void onBrush(Model::Node* /* parent */, Model::BrushNode* /* brush */, ParserStatus& /* status */) override {}
+        };
+
+        namespace {
+            /**
+             * The number of brushes per block. The blocks should be large enough to amortize the cost of setting up a
+             * reader, and small enough so that the blocks can be distributed evenly among the worker threads.
+             */
+            constexpr size_t BrushBlockSize = 256u;
+
+            struct BrushBlock {
+                TokenizerState begin;
+                TokenizerState end;
+            };
+
+            bool isWhitespace(const char c) {
+                return c == ' ' || c == '\t' || c == '\r';
+            }
+
+            bool isLine(const char* begin, const char* end, const char c) {
+                return end - begin == 1 && *begin == c;
+            }
+
+            /**
+             * Checks whether the given line is a comment that is discarded by the tokenizer. Comments starting with
+             * three slashes and a space contain extra attributes and are not discarded.
+             */
+            bool isComment(const char* begin, const char* end) {
+                if (end - begin >= 1 && *begin == ';') {
+                    return true;
+                }
+                if (end - begin >= 2 && begin[0] == '/' && begin[1] == '/') {
+                    return end - begin < 4 || begin[2] != '/' || begin[3] != ' ';
+                }
+                return false;
+            }
+
+            bool isExtraAttributes(const char* begin, const char* end) {
+                return end - begin >= 4 && begin[0] == '/' && begin[1] == '/' && begin[2] == '/' && begin[3] == ' ';
+            }
+
+            /**
+             * Checks whether the given line consists of exactly two quoted strings, taking escaped quotes into account
+             * in the same way as the tokenizer.
+             */
+            bool isPropertyLine(const char* begin, const char* end) {
+                auto quotes = size_t(0);
+                const char* lastQuote = nullptr;
+                auto escaped = false;
+                for (const auto* c = begin; c < end; ++c) {
+                    if (*c == '"' && !escaped) {
+                        ++quotes;
+                        lastQuote = c;
+                    }
+                    escaped = *c == '\\' && !escaped;
+                }
+                return quotes == 4u && *begin == '"' && lastQuote == end - 1;
+            }
+
+            bool startsOrEndsWithBrace(const char* begin, const char* end) {
+                return *begin == '{' || *begin == '}' || *(end - 1) == '{' || *(end - 1) == '}';
+            }
+
+            /**
+             * Splits the brushes of the entities in the given string into blocks of consecutive brushes that can be
+             * parsed independently.
+             *
+             * This is a line based scanner that only accepts the layout of well formed map files where every brace that
+             * opens or closes an entity or a brush is on a line of its own. It tracks line and column numbers exactly
+             * like the tokenizer, so that the returned states can be used to start or continue tokenizing. If the
+             * scanner encounters anything unexpected, it gives up and returns an empty vector, and the entire string is
+             * parsed sequentially.
+             */
+            std::vector<BrushBlock> findBrushBlocks(const std::string_view str) {
+                auto result = std::vector<BrushBlock>{};
+
+                auto blockBegin = std::optional<TokenizerState>{};
+                auto blockEnd = TokenizerState{};
+                auto brushCount = size_t(0);
+
+                const auto closeBlock = [&]() {
+                    if (blockBegin) {
+                        result.push_back(BrushBlock{*blockBegin, blockEnd});
+                        blockBegin = std::nullopt;
+                        brushCount = 0u;
+                    }
+                };
+
+                const auto* end = str.data() + str.size();
+                const auto* lineBegin = str.data();
+                auto line = size_t(1);
+                auto depth = size_t(0);
+
+                while (lineBegin < end) {
+                    // a line ends with a line feed or with a carriage return that is not followed by a line feed
+                    const auto* lineEnd = lineBegin;
+                    while (lineEnd < end && *lineEnd != '\n' && (*lineEnd != '\r' || (lineEnd + 1 < end && *(lineEnd + 1) == '\n'))) {
+                        ++lineEnd;
+                    }
+
+                    const auto* b = lineBegin;
+                    const auto* e = lineEnd;
+                    while (b < e && isWhitespace(*b)) {
+                        ++b;
+                    }
+                    while (e > b && isWhitespace(*(e - 1))) {
+                        --e;
+                    }
+
+                    const auto column = static_cast<size_t>(b - lineBegin) + 1u;
+                    if (depth == 0u) {
+                        if (isLine(b, e, '{')) {
+                            ++depth;
+                        } else if (b != e && !isComment(b, lineEnd)) {
+                            return {};
+                        }
+                    } else if (depth == 1u) {
+                        if (isLine(b, e, '{')) {
+                            if (!blockBegin) {
+                                blockBegin = TokenizerState{b, line, column, false};
+                            }
+                            ++depth;
+                        } else if (isLine(b, e, '}')) {
+                            closeBlock();
+                            --depth;
+                        } else if (isExtraAttributes(b, lineEnd) || isPropertyLine(b, e)) {
+                            closeBlock();
+                        } else if (b != e && !isComment(b, lineEnd)) {
+                            return {};
+                        }
+                    } else {
+                        if (isLine(b, e, '{')) {
+                            ++depth;
+                        } else if (isLine(b, e, '}')) {
+                            if (--depth == 1u) {
+                                blockEnd = TokenizerState{e, line, column + 1u, false};
+                                if (++brushCount == BrushBlockSize) {
+                                    closeBlock();
+                                }
+                            }
+                        } else if (b != e && (startsOrEndsWithBrace(b, e) || std::find(b, e, '"') != e)) {
+                            return {};
+                        }
+                    }
+
+                    lineBegin = lineEnd + 1;
+                    ++line;
+                }
+
+                if (depth != 0u) {
+                    return {};
+                }
+                return result;
+            }
+        }
+
+        /**
+         * Processes brush blocks on worker threads while the reader that owns the queue parses the remainder of the
+         * map. The workers process the blocks in file order, and they never run more than a fixed number of blocks
+         * ahead of the reader, so that the memory held by processed blocks that have not been taken yet is bounded.
+         *
+         * Destroying the queue stops the workers and waits for them to finish.
+         */
+        class MapReader::BrushBlockQueue {
+        public:
+            using ProcessBlock = std::function<std::optional<ParsedBrushBlock>(const BrushBlock&)>;
+        private:
+            std::vector<BrushBlock> m_blocks;
+            std::vector<std::optional<ParsedBrushBlock>> m_results;
+            std::vector<bool> m_done;
+            ProcessBlock m_processBlock;
+            size_t m_capacity;
+
+            std::mutex m_mutex;
+            std::condition_variable m_blockDone;
+            std::condition_variable m_blockTaken;
+            size_t m_nextBlockToProcess;
+            size_t m_nextBlockToTake;
+            bool m_stopped;
+
+            std::vector<std::future<void>> m_workers;
+        public:
+            BrushBlockQueue(std::vector<BrushBlock> blocks, ProcessBlock processBlock) :
+            m_blocks(std::move(blocks)),
+            m_results(m_blocks.size()),
+            m_done(m_blocks.size(), false),
+            m_processBlock(std::move(processBlock)),
+            m_capacity(0u),
+            m_nextBlockToProcess(0u),
+            m_nextBlockToTake(0u),
+            m_stopped(false) {
+                const auto workerCount = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+                m_capacity = 4u * workerCount;
+
+                try {
+                    for (size_t i = 0u; i < workerCount; ++i) {
+                        m_workers.push_back(std::async(std::launch::async, [&]() { work(); }));
+                    }
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+            }
+
+            ~BrushBlockQueue() {
+                stop();
+            }
+
+            /**
+             * Takes the block that begins at the given position, waiting until it has been processed if necessary.
+             * All blocks that begin before the given position are discarded.
+             *
+             * Returns an empty optional if no block begins at the given position or if the block could not be
+             * processed.
+             */
+            std::optional<ParsedBrushBlock> take(const char* position) {
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                while (m_nextBlockToTake < m_blocks.size() && m_blocks[m_nextBlockToTake].begin.cur < position) {
+                    m_results[m_nextBlockToTake++] = std::nullopt;
+                }
+                if (m_nextBlockToTake == m_blocks.size() || m_blocks[m_nextBlockToTake].begin.cur != position) {
+                    m_blockTaken.notify_all();
+                    return std::nullopt;
+                }
+
+                const auto index = m_nextBlockToTake++;
+                m_blockTaken.notify_all();
+                m_blockDone.wait(lock, [&]() { return m_done[index]; });
+                return std::move(m_results[index]);
+            }
+        private:
+            void work() {
+                while (true) {
+                    auto index = size_t(0);
+                    {
+                        auto lock = std::unique_lock<std::mutex>(m_mutex);
+                        m_blockTaken.wait(lock, [&]() {
+                            return m_stopped || m_nextBlockToProcess == m_blocks.size() || m_nextBlockToProcess < m_nextBlockToTake + m_capacity;
+                        });
+                        if (m_stopped || m_nextBlockToProcess == m_blocks.size()) {
+                            return;
+                        }
+                        index = m_nextBlockToProcess++;
+                    }
+
+                    auto result = m_processBlock(m_blocks[index]);
+
+                    {
+                        auto lock = std::unique_lock<std::mutex>(m_mutex);
+                        m_results[index] = std::move(result);
+                        m_done[index] = true;
+                    }
+                    m_blockDone.notify_all();
+                }
+            }
+
+            void stop() {
+                {
+                    auto lock = std::unique_lock<std::mutex>(m_mutex);
+                    m_stopped = true;
+                }
+                m_blockTaken.notify_all();
+                for (auto& worker : m_workers) {
+                    worker.wait();
+                }
+            }
+        };
+
         MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
-        StandardMapParser(std::move(str), sourceMapFormat, targetMapFormat),
+        StandardMapParser(str, sourceMapFormat, targetMapFormat),
+        m_str(str),
+        m_sourceMapFormat(sourceMapFormat),
+        m_targetMapFormat(targetMapFormat),
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
+        MapReader::~MapReader() = default;
 
         void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(status);
+            {
+                parseBrushBlocks(status);
+                const kdl::invoke_later stopBrushBlocks([this]() { m_brushBlocks.reset(); });
+                parseEntities(status);
+            }
             createNodes(status);
             resolveNodes(status);
         }
@@ -110,7 +417,7 @@ namespace TrenchBroom {
         }
 
         void MapReader::onBeginBrush(const size_t /* line */, ParserStatus& /* status */) {
-            m_brushInfos.push_back(BrushInfo{{}, 0, 0, {}});
+            m_brushInfos.push_back(BrushInfo{{}, 0, 0, {}, std::nullopt});
         }
 
         void MapReader::onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) {
@@ -151,8 +458,64 @@ namespace TrenchBroom {
                 ));
         }
 
+        // implement StandardMapParser interface
+
+        std::optional<TokenizerState> MapReader::skipParsedBrushes(const char* position, ParserStatus& /* status */) {
+            if (!m_brushBlocks) {
+                return std::nullopt;
+            }
+
+            auto block = m_brushBlocks->take(position);
+            if (!block) {
+                return std::nullopt;
+            }
+
+            assert(!m_entityInfos.empty());
+            EntityInfo& entity = m_entityInfos.back();
+            for (auto& brushInfo : block->brushInfos) {
+                m_brushInfos.push_back(std::move(brushInfo));
+                ++entity.brushesEnd;
+            }
+            assert(entity.brushesEnd == m_brushInfos.size());
+
+            block->status->replay();
+            return block->end;
+        }
+
         // helper methods
 
+        /**
+         * Finds blocks of consecutive brushes in the source and starts parsing them and building their geometry on
+         * worker threads, so that this overlaps with parseEntities. The processed blocks are picked up by
+         * skipParsedBrushes when parseEntities reaches the first brush of a block, waiting for the block if necessary,
+         * and the messages that were logged while parsing a block are passed on to the given status at that point, so
+         * that they appear in file order.
+         *
+         * If a block cannot be parsed, parseEntities parses its brushes by itself, which reports the error exactly as if
+         * the block had not been parsed in advance.
+         */
+        void MapReader::parseBrushBlocks(ParserStatus& status) {
+            auto blocks = findBrushBlocks(m_str);
+            if (blocks.size() < 2u) {
+                return;
+            }
+
+            m_brushBlocks = std::make_unique<BrushBlockQueue>(std::move(blocks), [&](const BrushBlock& block) -> std::optional<ParsedBrushBlock> {
+                auto blockStatus = std::make_unique<BufferedParserStatus>(status);
+                try {
+                    auto reader = BrushBlockReader(m_str, m_sourceMapFormat, m_targetMapFormat, block.begin, block.end);
+                    auto brushInfos = reader.read(*blockStatus);
+                    for (auto& brushInfo : brushInfos) {
+                        brushInfo.brush = Model::Brush::create(m_worldBounds, std::move(brushInfo.faces));
+                    }
+                    return ParsedBrushBlock{block.end, std::move(brushInfos), std::move(blockStatus)};
+                } catch (...) {
+                    // exceptions cannot leave the worker thread; the error is reported when the brushes are parsed again
+                    return std::nullopt;
+                }
+            });
+        }
+
         void MapReader::createNodes(ParserStatus& status) {
             auto loadedBrushes = loadBrushes(status);
 
@@ -163,7 +526,9 @@ namespace TrenchBroom {
             // handle the case of parsing no entities, but a list of brushes (NodeReader)
             if (m_entityInfos.empty()) {
                 for (LoadedBrush& loadedBrush : loadedBrushes) {
-                    createBrush(std::move(*loadedBrush.brush), nullptr, loadedBrush.startLine, loadedBrush.lineCount, std::move(loadedBrush.extraAttributes), status);
+                    if (auto* brushNode = createBrush(std::move(*loadedBrush.brush), loadedBrush.startLine, loadedBrush.lineCount, std::move(loadedBrush.extraAttributes), status)) {
+                        onBrush(nullptr, brushNode, status);
+                    }
                 }
             }
         }
@@ -187,14 +552,15 @@ namespace TrenchBroom {
                     m_brushParent = onWorldspawn(properties, extraAttributes, status);
                     break;
                 case EntityType_Default:
-                    createEntity(line, properties, extraAttributes, status);
+                    // the brushes are added to the entity before the entity is stored, so that they are inserted
+                    // together with the entity
+                    createEntity(line, properties, extraAttributes, createBrushes(info, loadedBrushes, status), status);
                     break;
             }
 
             // add brushes
-            for (size_t i = info.brushesBegin; i < info.brushesEnd; ++i) {
-                LoadedBrush& loadedBrush = loadedBrushes.at(i);
-                createBrush(std::move(*loadedBrush.brush), m_brushParent, loadedBrush.startLine, loadedBrush.lineCount, std::move(loadedBrush.extraAttributes), status);
+            if (type != EntityType_Default) {
+                onBrushes(m_brushParent, createBrushes(info, loadedBrushes, status), status);
             }
 
             // cleanup
@@ -289,95 +655,98 @@ namespace TrenchBroom {
             groupNode->setPersistentId(groupId);
             setExtraAttributes(groupNode, extraAttributes);
 
-            storeNode(groupNode, properties, status);
+            storeNode(groupNode, findParentInfo(groupNode, properties, status), status);
             m_groups.insert(std::make_pair(groupId, groupNode));
 
             m_currentNode = groupNode;
             m_brushParent = groupNode;
         }
 
-        void MapReader::createEntity(const size_t /* line */, const std::vector<Model::EntityProperty>& properties, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            Model::EntityNode* entity = new Model::EntityNode(Model::Entity());
-            entity->setEntity(Model::Entity(properties));
-            setExtraAttributes(entity, extraAttributes);
+        void MapReader::createEntity(const size_t /* line */, const std::vector<Model::EntityProperty>& properties, const ExtraAttributes& extraAttributes, std::vector<Model::BrushNode*> brushes, ParserStatus& status) {
+            Model::EntityNode* entityNode = new Model::EntityNode(Model::Entity());
+            setExtraAttributes(entityNode, extraAttributes);
+
+            // strip the parent properties before the entity is stored so that it is added to the index only once
+            const auto parentInfo = findParentInfo(entityNode, properties, status);
+            auto entity = Model::Entity(properties);
+            stripParentProperties(entity, parentInfo);
+            entityNode->setEntity(std::move(entity));
+
+            onBrushes(entityNode, std::move(brushes), status);
+            storeNode(entityNode, parentInfo, status);
+
+            m_currentNode = entityNode;
+            m_brushParent = entityNode;
+        }
+
+        std::vector<Model::BrushNode*> MapReader::createBrushes(const EntityInfo& info, std::vector<LoadedBrush>& loadedBrushes, ParserStatus& status) {
+            auto result = std::vector<Model::BrushNode*>{};
+            result.reserve(info.brushesEnd - info.brushesBegin);
 
-            const ParentInfo::Type parentType = storeNode(entity, properties, status);
-            stripParentProperties(entity, parentType);
+            for (size_t i = info.brushesBegin; i < info.brushesEnd; ++i) {
+                LoadedBrush& loadedBrush = loadedBrushes.at(i);
+                if (auto* brushNode = createBrush(std::move(*loadedBrush.brush), loadedBrush.startLine, loadedBrush.lineCount, std::move(loadedBrush.extraAttributes), status)) {
+                    result.push_back(brushNode);
+                }
+            }
 
-            m_currentNode = entity;
-            m_brushParent = entity;
+            return result;
         }
 
-        void MapReader::createBrush(kdl::result<Model::Brush, Model::BrushError> brush, Model::Node* parent, const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            std::move(brush)
-                .and_then(
-                    [&](Model::Brush&& b) {
+        Model::BrushNode* MapReader::createBrush(kdl::result<Model::Brush, Model::BrushError> brush, const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            return std::move(brush)
+                .visit(kdl::overload(
+                    [&](Model::Brush&& b) -> Model::BrushNode* {
                         Model::BrushNode* brushNode = new Model::BrushNode(std::move(b));
                         setFilePosition(brushNode, startLine, lineCount);
                         setExtraAttributes(brushNode, extraAttributes);
-
-                        onBrush(parent, brushNode, status);
-
-                        return kdl::void_result;
-                    }
-                ).handle_errors(
-                    [&](const Model::BrushError e) {
+                        return brushNode;
+                    },
+                    [&](const Model::BrushError e) -> Model::BrushNode* {
                         status.error(startLine, kdl::str_to_string("Skipping brush: ", e));
+                        return nullptr;
                     }
-                );
+                ));
         }
 
-        MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const std::vector<Model::EntityProperty>& properties, ParserStatus& status) {
+        std::optional<MapReader::ParentInfo> MapReader::findParentInfo(const Model::Node* node, const std::vector<Model::EntityProperty>& properties, ParserStatus& status) const {
             const std::string& layerIdStr = findProperty(properties, Model::PropertyKeys::Layer);
             if (!kdl::str_is_blank(layerIdStr)) {
                 if (const auto rawId = kdl::str_to_size(layerIdStr)) {
-                    const Model::IdType layerId = static_cast<Model::IdType>(*rawId);
-                    Model::LayerNode* layer = kdl::map_find_or_default(m_layers, layerId,
-                        static_cast<Model::LayerNode*>(nullptr));
-                    if (layer != nullptr)
-                        onNode(layer, node, status);
-                    else
-                        m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
-                    return ParentInfo::Type_Layer;
+                    return ParentInfo::layer(static_cast<Model::IdType>(*rawId));
                 }
 
                 status.warn(node->lineNumber(), kdl::str_to_string("Entity has invalid parent id '", layerIdStr, "'"));
             } else {
                 const std::string& groupIdStr = findProperty(properties, Model::PropertyKeys::Group);
                 if (!kdl::str_is_blank(groupIdStr)) {
-                if (const auto rawId = kdl::str_to_size(groupIdStr)) {
-                        const Model::IdType groupId = static_cast<Model::IdType>(*rawId);
-                        Model::GroupNode* group = kdl::map_find_or_default(m_groups, groupId,
-                            static_cast<Model::GroupNode*>(nullptr));
-                        if (group != nullptr)
-                            onNode(group, node, status);
-                        else
-                            m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
-                        return ParentInfo::Type_Group;
+                    if (const auto rawId = kdl::str_to_size(groupIdStr)) {
+                        return ParentInfo::group(static_cast<Model::IdType>(*rawId));
                     }
 
                     status.warn(node->lineNumber(), kdl::str_to_string("Entity has invalid parent id '", groupIdStr, "'"));
                 }
             }
 
-            onNode(nullptr, node, status);
-            return ParentInfo::Type_None;
+            return std::nullopt;
         }
 
-        void MapReader::stripParentProperties(Model::EntityNodeBase* node, ParentInfo::Type parentType) {
-            auto entity = node->entity();
-            switch (parentType) {
-                case ParentInfo::Type_Layer:
-                    entity.removeProperty(Model::PropertyKeys::Layer);
-                    break;
-                case ParentInfo::Type_Group:
-                    entity.removeProperty(Model::PropertyKeys::Group);
-                    break;
-                case ParentInfo::Type_None:
-                    break;
-                switchDefault();
+        void MapReader::storeNode(Model::Node* node, const std::optional<ParentInfo>& parentInfo, ParserStatus& status) {
+            if (parentInfo) {
+                if (Model::Node* parent = resolveParent(*parentInfo)) {
+                    onNode(parent, node, status);
+                } else {
+                    m_unresolvedNodes.push_back(std::make_pair(node, *parentInfo));
+                }
+            } else {
+                onNode(nullptr, node, status);
+            }
+        }
+
+        void MapReader::stripParentProperties(Model::Entity& entity, const std::optional<ParentInfo>& parentInfo) {
+            if (parentInfo) {
+                entity.removeProperty(parentInfo->layer() ? Model::PropertyKeys::Layer : Model::PropertyKeys::Group);
             }
-            node->setEntity(std::move(entity));
         }
 
         /**
@@ -397,13 +766,14 @@ namespace TrenchBroom {
         }
 
         /**
-         * Transforms m_brushInfos into a vector of LoadedBrush (leaving m_brushInfos empty).
+         * Transforms m_brushInfos into a vector of LoadedBrush (leaving m_brushInfos empty). Brushes that were already
+         * built by parseBrushBlocks are taken as they are.
          */
         std::vector<MapReader::LoadedBrush> MapReader::loadBrushes(ParserStatus& /* status */) {
-            // In parallel, create Brush objects (moving faces out of m_brushInfos)
+            // In parallel, create the remaining Brush objects (moving faces out of m_brushInfos)
             auto loadedBrushes = kdl::vec_parallel_transform(std::move(m_brushInfos), [&](BrushInfo&& brushInfo) {
                 LoadedBrush result;
-                result.brush = std::make_optional(Model::Brush::create(m_worldBounds, std::move(brushInfo.faces)));
+                result.brush = brushInfo.brush ? std::move(brushInfo.brush) : std::make_optional(Model::Brush::create(m_worldBounds, std::move(brushInfo.faces)));
                 result.extraAttributes = std::move(brushInfo.extraAttributes);
                 result.startLine = brushInfo.startLine;
                 result.lineCount = brushInfo.lineCount;
@@ -450,6 +820,15 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Default implementation adds the brushes one by one.
+         */
+        void MapReader::onBrushes(Model::Node* parent, std::vector<Model::BrushNode*> brushes, ParserStatus& status) {
+            for (auto* brush : brushes) {
+                onBrush(parent, brush, status);
+            }
+        }
+
         /**
          * Default implementation adds it to the current BrushInfo
          * Overridden in BrushFaceReader (which doesn't use m_brushInfos) to collect the faces directly
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "FloatType.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/StandardMapParser.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
@@ -31,14 +32,15 @@
 #include <vecmath/bbox.h>
 
 #include <map>
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
-        class EntityNodeBase;
         class BrushNode;
+        class Entity;
         class EntityProperty;
         class GroupNode;
         class LayerNode;
@@ -59,7 +61,8 @@ namespace TrenchBroom {
          * The flow of data is:
          *
          * 1. MapParser callbacks get called with the raw data, which we just store
-         *    (m_entityInfos, m_brushInfos)
+         *    (m_entityInfos, m_brushInfos); when reading entities, blocks of brushes are parsed and their geometry is
+         *    built on worker threads while the remainder of the map is parsed
          * 2. convert the raw data to nodes (for brushes this happens in parallel)
          * 3. post process the nodes to resolve layers, etc.
          */
@@ -99,6 +102,9 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            std::string_view m_str;
+            Model::MapFormat m_sourceMapFormat;
+            Model::MapFormat m_targetMapFormat;
             vm::bbox3 m_worldBounds;
         private: // data populated in response to MapParser callbacks
             struct BrushInfo {
@@ -106,6 +112,8 @@ namespace TrenchBroom {
                 size_t startLine;
                 size_t lineCount;
                 ExtraAttributes extraAttributes;
+                // set if the brush was already built while parsing, the faces are moved into the brush then
+                std::optional<kdl::result<Model::Brush, Model::BrushError>> brush;
             };
             struct EntityInfo {
                 size_t startLine;
@@ -117,6 +125,16 @@ namespace TrenchBroom {
             };
             std::vector<EntityInfo> m_entityInfos;
             std::vector<BrushInfo> m_brushInfos;
+        private: // data populated by parseBrushBlocks
+            class BrushBlockReader;
+            class BrushBlockQueue;
+
+            struct ParsedBrushBlock {
+                TokenizerState end;
+                std::vector<BrushInfo> brushInfos;
+                std::unique_ptr<BufferedParserStatus> status;
+            };
+            std::unique_ptr<BrushBlockQueue> m_brushBlocks;
         private: // data populated by loadBrushes
             struct LoadedBrush {
                 // optional wrapper is just to let this struct be default-constructible
@@ -141,6 +159,9 @@ namespace TrenchBroom {
              * @param targetMapFormat the format to convert the created objects to
              */
             MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+        public:
+            ~MapReader() override;
+        protected:
 
             /**
              * Attempts to parse as one or more entities.
@@ -167,16 +188,22 @@ namespace TrenchBroom {
             void onEndBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
             void onStandardBrushFace(size_t line, Model::MapFormat targetMapFormat, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, ParserStatus& status) override;
             void onValveBrushFace(size_t line, Model::MapFormat targetMapFormat, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override;
+        private: // implement StandardMapParser interface
+            std::optional<TokenizerState> skipParsedBrushes(const char* position, ParserStatus& status) override;
         private: // helper methods
+            void parseBrushBlocks(ParserStatus& status);
+
             void createNodes(ParserStatus& status);
             void createNode(EntityInfo& info, std::vector<LoadedBrush>& brushes, ParserStatus& status);
             void createLayer(size_t line, const std::vector<Model::EntityProperty>& propeties, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createGroup(size_t line, const std::vector<Model::EntityProperty>& properties, const ExtraAttributes& extraAttributes, ParserStatus& status);
-            void createEntity(size_t line, const std::vector<Model::EntityProperty>& properties, const ExtraAttributes& extraAttributes, ParserStatus& status);
-            void createBrush(kdl::result<Model::Brush, Model::BrushError> brush, Model::Node* parent, size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void createEntity(size_t line, const std::vector<Model::EntityProperty>& properties, const ExtraAttributes& extraAttributes, std::vector<Model::BrushNode*> brushes, ParserStatus& status);
+            std::vector<Model::BrushNode*> createBrushes(const EntityInfo& info, std::vector<LoadedBrush>& loadedBrushes, ParserStatus& status);
+            Model::BrushNode* createBrush(kdl::result<Model::Brush, Model::BrushError> brush, size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
 
-            ParentInfo::Type storeNode(Model::Node* node, const std::vector<Model::EntityProperty>& properties, ParserStatus& status);
-            void stripParentProperties(Model::EntityNodeBase* node, ParentInfo::Type parentType);
+            std::optional<ParentInfo> findParentInfo(const Model::Node* node, const std::vector<Model::EntityProperty>& properties, ParserStatus& status) const;
+            void storeNode(Model::Node* node, const std::optional<ParentInfo>& parentInfo, ParserStatus& status);
+            void stripParentProperties(Model::Entity& entity, const std::optional<ParentInfo>& parentInfo);
 
             void resolveNodes(ParserStatus& status);
             std::vector<LoadedBrush> loadBrushes(ParserStatus& status);
@@ -194,6 +221,7 @@ namespace TrenchBroom {
             virtual void onNode(Model::Node* parent, Model::Node* node, ParserStatus& status) = 0;
             virtual void onUnresolvedNode(const ParentInfo& parentInfo, Model::Node* node, ParserStatus& status) = 0;
             virtual void onBrush(Model::Node* parent, Model::BrushNode* brush, ParserStatus& status) = 0;
+            virtual void onBrushes(Model::Node* parent, std::vector<Model::BrushNode*> brushes, ParserStatus& status);
             virtual void onBrushFace(Model::BrushFace face, ParserStatus& status);
         };
     }
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NumberParser.h"
+
+#include <kdl/string_utils.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            bool isDigit(const char c) {
+                return c >= '0' && c <= '9';
+            }
+
+            const char* parseSign(const char* cur, const char* end, bool& negative) {
+                negative = false;
+                if (cur < end && (*cur == '+' || *cur == '-')) {
+                    negative = *cur == '-';
+                    ++cur;
+                }
+                return cur;
+            }
+        }
+
+        std::optional<long> parseLong(const char* begin, const char* end) {
+            // 18 decimal digits always fit into 63 bits
+            constexpr auto MaxDigits = 18;
+
+            bool negative;
+            const auto* cur = parseSign(begin, end, negative);
+            const auto* digitsBegin = cur;
+
+            auto value = int64_t(0);
+            while (cur < end && isDigit(*cur)) {
+                value = value * 10 + (*cur - '0');
+                ++cur;
+            }
+
+            if (cur == end && cur > digitsBegin && cur - digitsBegin <= MaxDigits && value <= std::numeric_limits<long>::max()) {
+                return static_cast<long>(negative ? -value : value);
+            }
+            return kdl::str_to_long(std::string(begin, end));
+        }
+
+        std::optional<double> parseDouble(const char* begin, const char* end) {
+            // integers with up to 15 significant digits are exactly representable as doubles, and so are the powers of
+            // 10 up to 10^22; multiplying or dividing two such numbers yields the correctly rounded result
+            constexpr auto MaxSignificantDigits = 15;
+            constexpr auto MaxExponent = 22;
+            static const double PowersOf10[] = {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            const auto fallback = [&]() { return kdl::str_to_double(std::string(begin, end)); };
+
+            bool negative;
+            const auto* cur = parseSign(begin, end, negative);
+
+            auto mantissa = int64_t(0);
+            auto significantDigits = 0;
+            auto digits = 0;
+            auto exponent = 0;
+
+            while (cur < end && isDigit(*cur)) {
+                if (mantissa != 0 || *cur != '0') {
+                    mantissa = mantissa * 10 + (*cur - '0');
+                    ++significantDigits;
+                }
+                ++digits;
+                ++cur;
+                if (significantDigits > MaxSignificantDigits) {
+                    return fallback();
+                }
+            }
+
+            if (cur < end && *cur == '.') {
+                ++cur;
+                while (cur < end && isDigit(*cur)) {
+                    if (mantissa != 0 || *cur != '0') {
+                        mantissa = mantissa * 10 + (*cur - '0');
+                        ++significantDigits;
+                    }
+                    ++digits;
+                    --exponent;
+                    ++cur;
+                    if (significantDigits > MaxSignificantDigits) {
+                        return fallback();
+                    }
+                }
+            }
+
+            if (digits == 0) {
+                return fallback();
+            }
+
+            if (cur < end && (*cur == 'e' || *cur == 'E')) {
+                ++cur;
+                bool negativeExponent;
+                cur = parseSign(cur, end, negativeExponent);
+
+                const auto* exponentBegin = cur;
+                auto explicitExponent = 0;
+                while (cur < end && isDigit(*cur) && cur - exponentBegin < 4) {
+                    explicitExponent = explicitExponent * 10 + (*cur - '0');
+                    ++cur;
+                }
+                if (cur == exponentBegin) {
+                    return fallback();
+                }
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            }
+
+            if (cur != end || exponent < -MaxExponent || exponent > MaxExponent) {
+                return fallback();
+            }
+
+            auto value = static_cast<double>(mantissa);
+            if (exponent < 0) {
+                value /= PowersOf10[-exponent];
+            } else {
+                value *= PowersOf10[exponent];
+            }
+            return negative ? -value : value;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Interprets the given range of characters as a signed integer and returns it. If the range cannot be
+         * interpreted as a signed integer, returns an empty optional.
+         *
+         * Ranges consisting of an optional sign followed by decimal digits are converted directly. Anything else is
+         * passed on to kdl::str_to_long, so the result is always the same as if the range had been copied into a string
+         * and converted by kdl::str_to_long.
+         */
+        std::optional<long> parseLong(const char* begin, const char* end);
+
+        /**
+         * Interprets the given range of characters as a floating point number and returns it. If the range cannot be
+         * interpreted as a floating point number, returns an empty optional.
+         *
+         * Ranges consisting of an optional sign, decimal digits with an optional fractional part and an optional
+         * exponent are converted directly if the conversion is exact, which is the case for integers and for numbers
+         * with up to 15 significant digits and a small exponent. This does not depend on the current locale. Anything
+         * else is passed on to kdl::str_to_double, so the result is always the same as if the range had been copied into
+         * a string and converted by kdl::str_to_double.
+         */
+        std::optional<double> parseDouble(const char* begin, const char* end);
+    }
+}
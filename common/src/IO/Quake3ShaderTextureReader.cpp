@@ -28,12 +28,14 @@
 #include "Renderer/GL.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        Quake3ShaderTextureReader::Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger) :
-        TextureReader(nameStrategy, fs, logger) {}
+        Quake3ShaderTextureReader::Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache) :
+        TextureReader(nameStrategy, fs, logger),
+        m_textureCache(std::move(textureCache)) {}
 
         Assets::Texture Quake3ShaderTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             const auto* shaderFile = dynamic_cast<ObjectFile<Assets::Quake3Shader>*>(file.get());
@@ -85,7 +87,7 @@ namespace TrenchBroom {
                 throw AssetException("Image file '" + imagePath.asString() + "' does not exist");
             }
 
-            FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger);
+            FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger, m_textureCache);
             return imageReader.readTexture(m_fs.openFile(imagePath));
         }
 
@@ -29,6 +29,7 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class CompressedTextureCache;
         class File;
         class FileSystem;
         class Path;
@@ -39,6 +40,8 @@ namespace TrenchBroom {
          * available as a virtual object file in the file system.
          */
         class Quake3ShaderTextureReader : public TextureReader {
+        private:
+            std::shared_ptr<const CompressedTextureCache> m_textureCache;
         public:
             /**
              * Creates a texture reader using the given name strategy and file system to locate the texture image.
@@ -46,8 +49,9 @@ namespace TrenchBroom {
              * @param nameStrategy the strategy to determine the texture name
              * @param fs the file system to use when locating the texture image
              * @param logger the logger to use
+             * @param textureCache if given, the texture images are compressed and cached in this cache
              */
-            Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
+            Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache = nullptr);
         private:
             Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
             Assets::Texture loadTextureImage(const Path& shaderPath, const Path& imagePath) const;
@@ -66,7 +66,7 @@ namespace TrenchBroom {
             return doGetSubSource(position, length);
         }
 
-        std::tuple<const char*, const char*, std::unique_ptr<char[]>> Reader::Source::buffer() const {
+        std::tuple<const char*, const char*, std::shared_ptr<const void>> Reader::Source::buffer() const {
             return doBuffer();
         }
 
@@ -116,10 +116,10 @@ namespace TrenchBroom {
             return std::make_unique<FileSource>(m_file, m_offset + position, length);
         }
 
-        std::tuple<const char*, const char*, std::unique_ptr<char[]>> Reader::FileSource::doBuffer() const {
+        std::tuple<const char*, const char*, std::shared_ptr<const void>> Reader::FileSource::doBuffer() const {
             std::fseek(m_file, static_cast<long>(m_offset), SEEK_SET);
 
-            auto buffer = std::make_unique<char[]>(m_length);
+            auto buffer = std::shared_ptr<char[]>(new char[m_length]);
             const auto read = std::fread(buffer.get(), 1, m_length, m_file);
             if (read != m_length) {
                 throwError("fread failed");
@@ -142,10 +142,11 @@ namespace TrenchBroom {
             }
         }
 
-        Reader::BufferSource::BufferSource(const char* begin, const char* end) :
+        Reader::BufferSource::BufferSource(const char* begin, const char* end, std::shared_ptr<const void> owner) :
         m_begin(begin),
         m_end(end),
-        m_current(begin) {
+        m_current(begin),
+        m_owner(std::move(owner)) {
             if (m_begin > m_end) {
                 throw ReaderException("Invalid buffer");
             }
@@ -177,11 +178,11 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<Reader::Source> Reader::BufferSource::doGetSubSource(const size_t position, const size_t length) const {
-            return std::make_unique<BufferSource>(m_begin + position, m_begin + position + length);
+            return std::make_unique<BufferSource>(m_begin + position, m_begin + position + length, m_owner);
         }
 
-        std::tuple<const char*, const char*, std::unique_ptr<char[]>> Reader::BufferSource::doBuffer() const {
-            return std::make_tuple(m_begin, m_end, nullptr);
+        std::tuple<const char*, const char*, std::shared_ptr<const void>> Reader::BufferSource::doBuffer() const {
+            return std::make_tuple(m_begin, m_end, m_owner);
         }
 
         Reader::Reader(std::unique_ptr<Source> source) :
@@ -197,6 +198,10 @@ namespace TrenchBroom {
             return Reader(std::make_unique<BufferSource>(begin, end));
         }
 
+        Reader Reader::from(const char* begin, const char* end, std::shared_ptr<const void> owner) {
+            return Reader(std::make_unique<BufferSource>(begin, end, std::move(owner)));
+        }
+
         size_t Reader::size() const {
             return m_source->size();
         }
@@ -269,9 +274,8 @@ namespace TrenchBroom {
             return std::string(buffer.data());
         }
 
-        BufferedReader::BufferedReader(const char* begin, const char* end, std::unique_ptr<char[]> buffer) :
-        Reader(std::make_unique<BufferSource>(begin, end)),
-        m_buffer(std::move(buffer)) {}
+        BufferedReader::BufferedReader(const char* begin, const char* end, std::shared_ptr<const void> buffer) :
+        Reader(std::make_unique<BufferSource>(begin, end, std::move(buffer))) {}
 
         const char* BufferedReader::begin() const {
             // This cast is safe since this reader can only host a buffer source!
@@ -103,12 +103,12 @@ namespace TrenchBroom {
                  * buffer, and the buffer itself will also be returned.
                  *
                  * @return a tuple containing of two pointers, the first of which points to the beginning of a memory
-                 * region and the second of which points to its end, and optionally a pointer to the newly allocated
-                 * memory that holds the data
+                 * region and the second of which points to its end, and optionally an owner that keeps the memory
+                 * region alive, i.e. the newly allocated buffer or the owner of this source's memory region
                  *
                  * @throw ReaderException if reading fails
                  */
-                std::tuple<const char*, const char*, std::unique_ptr<char[]>> buffer() const;
+                std::tuple<const char*, const char*, std::shared_ptr<const void>> buffer() const;
             private:
                 void ensurePosition(size_t position) const;
 
@@ -117,7 +117,7 @@ namespace TrenchBroom {
                 virtual void doRead(char* val, size_t size) = 0;
                 virtual void doSeek(size_t offset) = 0;
                 virtual std::unique_ptr<Source> doGetSubSource(size_t offset, size_t length) const = 0;
-                virtual std::tuple<const char*, const char*, std::unique_ptr<char[]>> doBuffer() const = 0;
+                virtual std::tuple<const char*, const char*, std::shared_ptr<const void>> doBuffer() const = 0;
             };
 
             /**
@@ -146,20 +146,21 @@ namespace TrenchBroom {
                 void doRead(char* val, size_t size) override;
                 void doSeek(size_t position) override;
                 std::unique_ptr<Source> doGetSubSource(size_t position, size_t length) const override;
-                std::tuple<const char*, const char*, std::unique_ptr<char[]>> doBuffer() const override;
+                std::tuple<const char*, const char*, std::shared_ptr<const void>> doBuffer() const override;
             private:
                 [[noreturn]] void throwError(const std::string& msg) const;
             };
         protected:
             /**
              * A reader source that reads from a memory region. Does not take ownership of the memory region and will
-             * not deallocate it.
+             * not deallocate it, but it can share the ownership of an object that keeps the memory region alive.
              */
             class BufferSource : public Source {
             private:
                 const char* m_begin;
                 const char* m_end;
                 const char* m_current;
+                std::shared_ptr<const void> m_owner;
             public:
                 /**
                  * Creates a new reader source for the given memory region.
@@ -167,10 +168,12 @@ namespace TrenchBroom {
                  * @param begin the beginning of the memory region
                  * @param end the end of the memory region (as in, the position after the last byte), must not be
                  * before the given beginning
+                 * @param owner an optional object that keeps the memory region alive, shared with sub sources and
+                 * buffered readers of this source
                  *
                  * @throw ReaderException if the given memory region is invalid
                  */
-                BufferSource(const char* begin, const char* end);
+                BufferSource(const char* begin, const char* end, std::shared_ptr<const void> owner = nullptr);
 
                 /**
                  * Returns the beginning of the underlying memory region.
@@ -187,7 +190,7 @@ namespace TrenchBroom {
                 void doRead(char* val, size_t size) override;
                 void doSeek(size_t position) override;
                 std::unique_ptr<Source> doGetSubSource(size_t position, size_t length) const override;
-                std::tuple<const char*, const char*, std::unique_ptr<char[]>> doBuffer() const override;
+                std::tuple<const char*, const char*, std::shared_ptr<const void>> doBuffer() const override;
             };
         protected:
             std::unique_ptr<Source> m_source;
@@ -221,6 +224,19 @@ namespace TrenchBroom {
              * @throw ReaderException if the reader cannot be created
              */
             static Reader from(const char* begin, const char* end);
+            /**
+             * Creates a new reader that reads from the given memory region and keeps the given owner of the memory
+             * region alive. The ownership is shared with all sub readers and buffered readers created from the
+             * returned reader, so that these readers may outlive the object the memory region was obtained from.
+             *
+             * @param begin the beginning of the memory region
+             * @param end the end of the memory region (the position after the last byte)
+             * @param owner the object that keeps the memory region alive
+             * @return the reader
+             *
+             * @throw ReaderException if the reader cannot be created
+             */
+            static Reader from(const char* begin, const char* end, std::shared_ptr<const void> owner);
         public:
             /**
              * Returns the size of the underlying reader source.
@@ -529,18 +545,17 @@ namespace TrenchBroom {
          * be created when calling the Reader::buffer() method.
          */
         class BufferedReader : public Reader {
-        private:
-            std::unique_ptr<char[]> m_buffer;
         public:
             /**
-             * Creates a new buffered reader for the given memory region. If the given buffer is not nullptr, it will
-             * be moved into this object and it will be destroyed when this object is destroyed.
+             * Creates a new buffered reader for the given memory region. If the given buffer is not nullptr, this
+             * object shares its ownership, and it will be destroyed when this object and all other owners are
+             * destroyed.
              *
              * @param begin the beginning of the memory region
              * @param end the end of the memory region (the position after the last byte)
-             * @param buffer the buffer to intern into this object
+             * @param buffer the buffer or other object that keeps the memory region alive
              */
-            BufferedReader(const char* begin, const char* end, std::unique_ptr<char[]> buffer);
+            BufferedReader(const char* begin, const char* end, std::shared_ptr<const void> buffer);
 
             /**
              * Returns the beginning of the underlying buffer memory region.
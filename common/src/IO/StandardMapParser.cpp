@@ -29,6 +29,7 @@
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -180,6 +181,14 @@ namespace TrenchBroom {
             m_tokenizer.reset();
         }
 
+        void StandardMapParser::restrictTo(const TokenizerStateAndSource& stateAndSource) {
+            m_tokenizer.restoreStateAndSource(stateAndSource);
+        }
+
+        std::optional<TokenizerState> StandardMapParser::skipParsedBrushes(const char* /* position */, ParserStatus& /* status */) {
+            return std::nullopt;
+        }
+
         void StandardMapParser::parseEntity(ParserStatus& status) {
             Token token = m_tokenizer.nextToken();
             if (token.type() == QuakeMapToken::Eof) {
@@ -211,7 +220,11 @@ namespace TrenchBroom {
                             beginEntity(startLine, properties, extraAttributes, status);
                             beginEntityCalled = true;
                         }
-                        parseBrushOrBrushPrimitiveOrPatch(status);
+                        if (const auto state = skipParsedBrushes(token.begin(), status)) {
+                            m_tokenizer.adoptState(*state);
+                        } else {
+                            parseBrushOrBrushPrimitiveOrPatch(status);
+                        }
                         break;
                     case QuakeMapToken::CBrace:
                         m_tokenizer.nextToken();
@@ -29,6 +29,7 @@
 
 #include <vecmath/forward.h>
 
+#include <optional>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -95,7 +96,23 @@ namespace TrenchBroom {
             void parseBrushFaces(ParserStatus& status);
 
             void reset();
+
+            /**
+             * Makes the parser read the given part of its source, starting at the given state. The line and column
+             * numbers of the given state must match the position of its current character in the source.
+             */
+            void restrictTo(const TokenizerStateAndSource& stateAndSource);
         private:
+            /**
+             * Called by parseEntities before a brush of an entity is parsed, with the position of the opening brace of
+             * that brush. Subclasses that have already parsed a sequence of brushes starting at this position by other
+             * means can report these brushes and return the tokenizer state after the closing brace of the last of them,
+             * and parsing continues from there.
+             *
+             * The default implementation returns an empty optional, so that the brush is parsed normally.
+             */
+            virtual std::optional<TokenizerState> skipParsedBrushes(const char* position, ParserStatus& status);
+
             void parseEntity(ParserStatus& status);
             void parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, ParserStatus& status);
 
@@ -19,7 +19,9 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
@@ -28,7 +30,12 @@
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <kdl/parallel.h>
+
+#include <functional>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,17 +55,52 @@ namespace TrenchBroom {
             return false;
         }
 
+        std::vector<std::optional<Assets::Texture>> TextureCollectionLoader::readTextures(const FileList& files, std::shared_ptr<const TextureReader> textureReader, const bool lazy) {
+            auto textures = std::vector<std::optional<Assets::Texture>>(files.size());
+            auto errors = std::vector<std::string>(files.size());
+
+            // exceptions thrown by the lambda would be swallowed by parallel_for, and the logger is not thread safe
+            kdl::parallel_for(files.size(), [&](const size_t i) {
+                try {
+                    if (lazy) {
+                        if (auto texture = textureReader->readTextureHeader(files[i])) {
+                            texture->setDataReader(createDataReader(files[i], textureReader));
+                            textures[i] = std::move(texture);
+                            return;
+                        }
+                    }
+                    textures[i] = textureReader->readTexture(files[i]);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (!textures[i].has_value()) {
+                    m_logger.warn() << errors[i];
+                }
+            }
+
+            return textures;
+        }
+
+        std::function<Assets::Texture()> TextureCollectionLoader::createDataReader(std::shared_ptr<File> file, std::shared_ptr<const TextureReader> textureReader) const {
+            return [file = std::move(file), textureReader = std::move(textureReader)]() {
+                return textureReader->readTexture(file);
+            };
+        }
+
         FileTextureCollectionLoader::FileTextureCollectionLoader(Logger& logger, const std::vector<IO::Path>& searchPaths, const std::vector<std::string>& exclusions) :
         TextureCollectionLoader(logger, exclusions),
         m_searchPaths(searchPaths) {}
 
-        Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader, const bool lazy) {
             const auto wadPath = Disk::resolvePath(m_searchPaths, path);
             WadFileSystem wadFS(wadPath, m_logger);
 
             const auto texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
+            auto files = FileList();
+            files.reserve(texturePaths.size());
             
             for (const auto& texturePath : texturePaths)  {
                 try {
@@ -67,12 +109,21 @@ namespace TrenchBroom {
                     if (shouldExclude(name)) {
                         continue;
                     }
-                    textures.push_back(textureReader.readTexture(file));
+                    files.push_back(std::move(file));
                 } catch (const std::exception& e) {
                     m_logger.warn() << e.what();
                 }
             }
 
+            auto textures = std::vector<Assets::Texture>();
+            textures.reserve(files.size());
+
+            for (auto& texture : readTextures(files, std::move(textureReader), lazy)) {
+                if (texture.has_value()) {
+                    textures.push_back(std::move(*texture));
+                }
+            }
+
             return Assets::TextureCollection(path, std::move(textures));
         }
 
@@ -80,10 +131,12 @@ namespace TrenchBroom {
         TextureCollectionLoader(logger, exclusions),
         m_gameFS(gameFS) {}
 
-        Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader, const bool lazy) {
             const auto texturePaths = m_gameFS.findItems(path, FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
+            auto files = FileList();
+            auto paths = std::vector<std::tuple<Path, Path>>();
+            files.reserve(texturePaths.size());
+            paths.reserve(texturePaths.size());
 
             for (const auto& texturePath : texturePaths) {
                 try {
@@ -101,16 +154,41 @@ namespace TrenchBroom {
                     if (shouldExclude(name)) {
                         continue;
                     }
-                    auto texture = textureReader.readTexture(file);
-                    texture.setAbsolutePath(absolutePath);
-                    texture.setRelativePath(texturePath);
-                    textures.push_back(std::move(texture));
+                    files.push_back(std::move(file));
+                    paths.emplace_back(absolutePath, texturePath);
                 } catch (const std::exception& e) {
                     m_logger.warn() << e.what();
                 }
             }
-            
+
+            auto readResult = readTextures(files, std::move(textureReader), lazy);
+            auto textures = std::vector<Assets::Texture>();
+            textures.reserve(readResult.size());
+
+            for (size_t i = 0; i < readResult.size(); ++i) {
+                if (readResult[i].has_value()) {
+                    auto& texture = *readResult[i];
+                    const auto& [absolutePath, relativePath] = paths[i];
+                    texture.setAbsolutePath(absolutePath);
+                    texture.setRelativePath(relativePath);
+                    textures.push_back(std::move(texture));
+                }
+            }
+
             return Assets::TextureCollection(path, std::move(textures));
         }
+
+        std::function<Assets::Texture()> DirectoryTextureCollectionLoader::createDataReader(std::shared_ptr<File> file, std::shared_ptr<const TextureReader> textureReader) const {
+            // keeping every file open until its texture is needed could exhaust the available file handles, so the
+            // file is opened again when the texture data is read
+            return [&gameFS = m_gameFS, path = file->path(), textureReader = std::move(textureReader)]() {
+                try {
+                    return textureReader->readTexture(gameFS.openFile(path));
+                } catch (const std::exception&) {
+                    // the texture keeps its dimensions and is rendered without data
+                    return Assets::Texture(path.lastComponent().asString(), 1, 1);
+                }
+            };
+        }
     }
 }
@@ -19,15 +19,17 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
-#include <string>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace Assets {
+        class Texture;
         class TextureCollection;
     }
 
@@ -48,9 +50,25 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            virtual Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) = 0;
+            virtual Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader, bool lazy) = 0;
         protected:
             bool shouldExclude(const std::string& textureName);
+
+            /**
+             * Reads the given files on several threads. The given texture reader must be safe to use concurrently.
+             *
+             * If lazy is true, only the headers of the textures are read if the reader supports it, and the returned
+             * textures read their data on demand using the given reader.
+             *
+             * The returned textures are in the same order as the given files. If a file could not be read, a warning
+             * is logged and the corresponding element of the returned vector is empty.
+             */
+            std::vector<std::optional<Assets::Texture>> readTextures(const FileList& files, std::shared_ptr<const TextureReader> textureReader, bool lazy);
+        private:
+            /**
+             * Returns a function that reads the data of the texture in the given file on demand.
+             */
+            virtual std::function<Assets::Texture()> createDataReader(std::shared_ptr<File> file, std::shared_ptr<const TextureReader> textureReader) const;
         };
 
         class FileTextureCollectionLoader : public TextureCollectionLoader {
@@ -59,7 +77,7 @@ namespace TrenchBroom {
         public:
             FileTextureCollectionLoader(Logger& logger, const std::vector<Path>& searchPaths, const std::vector<std::string>& exclusions);
         private:
-            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader, bool lazy) override;
         };
 
         class DirectoryTextureCollectionLoader : public TextureCollectionLoader {
@@ -68,7 +86,8 @@ namespace TrenchBroom {
         public:
             DirectoryTextureCollectionLoader(Logger& logger, const FileSystem& gameFS, const std::vector<std::string>& exclusions);
         private:
-            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader, bool lazy) override;
+            std::function<Assets::Texture()> createDataReader(std::shared_ptr<File> file, std::shared_ptr<const TextureReader> textureReader) const override;
         };
     }
 }
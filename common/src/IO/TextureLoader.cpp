@@ -35,15 +35,18 @@
 #include "IO/Path.h"
 #include "Model/GameConfig.h"
 
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger) :
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache) :
+        m_logger(std::make_shared<BufferedLogger>(logger)),
         m_textureExtensions(getTextureExtensions(textureConfig)),
-        m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
-        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
+        m_textureReader(shareTextureReader(createTextureReader(gameFS, textureConfig, *m_logger, std::move(textureCache)), m_logger)),
+        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, *m_logger)) {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
         }
@@ -54,7 +57,7 @@ namespace TrenchBroom {
             return textureConfig.format.extensions;
         }
 
-        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
+        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache) {
             const auto prefixLength = textureConfig.package.rootDirectory.length();
             const TextureReader::PathSuffixNameStrategy nameStrategy(prefixLength);
             
@@ -65,9 +68,9 @@ namespace TrenchBroom {
             } else if (textureConfig.format.format == "wal") {
                 return std::make_unique<WalTextureReader>(nameStrategy, gameFS, logger, loadPalette(gameFS, textureConfig, logger));
             } else if (textureConfig.format.format == "image") {
-                return std::make_unique<FreeImageTextureReader>(nameStrategy, gameFS, logger);
+                return std::make_unique<FreeImageTextureReader>(nameStrategy, gameFS, logger, std::move(textureCache));
             } else if (textureConfig.format.format == "q3shader") {
-                return std::make_unique<Quake3ShaderTextureReader>(nameStrategy, gameFS, logger);
+                return std::make_unique<Quake3ShaderTextureReader>(nameStrategy, gameFS, logger, std::move(textureCache));
             } else if (textureConfig.format.format == "m8") {
                 return std::make_unique<M8TextureReader>(nameStrategy, gameFS, logger);
             } else {
@@ -75,6 +78,13 @@ namespace TrenchBroom {
             }
         }
 
+        std::shared_ptr<const TextureReader> TextureLoader::shareTextureReader(std::unique_ptr<TextureReader> textureReader, std::shared_ptr<Logger> logger) {
+            // the reader refers to the logger, so the logger must live as long as the reader
+            return std::shared_ptr<const TextureReader>(textureReader.release(), [logger = std::move(logger)](const TextureReader* reader) {
+                delete reader;
+            });
+        }
+
         Assets::Palette TextureLoader::loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
             if (textureConfig.palette.isEmpty()) {
                 return Assets::Palette();
@@ -103,8 +113,18 @@ namespace TrenchBroom {
             }
         }
 
-        Assets::TextureCollection TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+        Assets::TextureCollection TextureLoader::loadTextureCollection(const Path& path, const bool lazy) {
+            try {
+                auto result = m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, m_textureReader, lazy);
+                if (lazy) {
+                    result.setLazyTextureLogger(m_logger);
+                }
+                m_logger->flush();
+                return result;
+            } catch (...) {
+                m_logger->flush();
+                throw;
+            }
         }
 
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
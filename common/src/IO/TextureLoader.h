@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "BufferedLogger.h"
 #include "Macros.h"
 
 #include <memory>
@@ -39,6 +40,7 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class CompressedTextureCache;
         class FileSystem;
         class Path;
         class TextureCollectionLoader;
@@ -46,19 +48,39 @@ namespace TrenchBroom {
 
         class TextureLoader {
         private:
+            /**
+             * The textures of a collection are decoded on several threads, so the readers must not log to the given
+             * logger directly. Lazy textures keep the reader alive, and the reader keeps this logger alive.
+             */
+            std::shared_ptr<BufferedLogger> m_logger;
             std::vector<std::string> m_textureExtensions;
-            std::unique_ptr<TextureReader> m_textureReader;
+            std::shared_ptr<const TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
-            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            /**
+             * Creates a texture loader for the given texture configuration.
+             *
+             * If a texture cache is given, image textures are compressed, and they are stored in and read from the given
+             * cache.
+             */
+            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache = nullptr);
             ~TextureLoader();
         private:
             static std::vector<std::string> getTextureExtensions(const Model::TextureConfig& textureConfig);
-            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
+            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<const CompressedTextureCache> textureCache);
+            static std::shared_ptr<const TextureReader> shareTextureReader(std::unique_ptr<TextureReader> textureReader, std::shared_ptr<Logger> logger);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
         public:
-            Assets::TextureCollection loadTextureCollection(const Path& path);
+            /**
+             * Loads the texture collection with the given path.
+             *
+             * @param path the path of the collection
+             * @param lazy whether to read only the names and dimensions of the textures, if the texture format supports
+             * it, and to read their data on demand
+             * @return the texture collection
+             */
+            Assets::TextureCollection loadTextureCollection(const Path& path, bool lazy = false);
             void loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndMove(TextureLoader)
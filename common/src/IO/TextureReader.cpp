@@ -19,6 +19,7 @@
 
 #include "TextureReader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
@@ -90,12 +91,21 @@ namespace TrenchBroom {
         Assets::Texture TextureReader::readTexture(std::shared_ptr<File> file) const {
             try {
                 return doReadTexture(file);
-            } catch (const AssetException& e) {
+            } catch (const std::exception& e) {
+                // besides asset exceptions, truncated files cause reader exceptions
                 m_logger.error() << "Could not read texture '" << file->path() << "': " << e.what();
                 return loadDefaultTexture(m_fs, m_logger, textureName(file->path()));
             }
         }
 
+        std::optional<Assets::Texture> TextureReader::readTextureHeader(std::shared_ptr<File> file) const {
+            try {
+                return doReadTextureHeader(file);
+            } catch (const Exception&) {
+                return std::nullopt;
+            }
+        }
+
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
@@ -104,6 +114,10 @@ namespace TrenchBroom {
             return m_nameStrategy->textureName(path.lastComponent().asString(), path);
         }
 
+        std::optional<Assets::Texture> TextureReader::doReadTextureHeader(std::shared_ptr<File> /* file */) const {
+            return std::nullopt;
+        }
+
         bool TextureReader::checkTextureDimensions(const size_t width, const size_t height) {
             return width <= 8192 && height <= 8192;
         }
@@ -22,6 +22,7 @@
 #include "Macros.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom {
@@ -118,6 +119,16 @@ namespace TrenchBroom {
              * @return an Assets::Texture object
              */
             Assets::Texture readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads only the name and the dimensions of the texture in the given file. The returned texture has no
+             * data.
+             *
+             * @param file the file containing the texture
+             * @return the texture, or an empty optional if this reader cannot read texture headers or if the header
+             * is invalid, in which case the texture must be read using readTexture
+             */
+            std::optional<Assets::Texture> readTextureHeader(std::shared_ptr<File> file) const;
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
@@ -130,6 +141,15 @@ namespace TrenchBroom {
              * @return an Assets::Texture object
              */
             virtual Assets::Texture doReadTexture(std::shared_ptr<File> file) const = 0;
+
+            /**
+             * Reads the name and the dimensions of a texture without reading its data. The default implementation
+             * returns an empty optional to indicate that this reader does not support reading texture headers.
+             *
+             * @param file the file containing the texture
+             * @return the texture or an empty optional
+             */
+            virtual std::optional<Assets::Texture> doReadTextureHeader(std::shared_ptr<File> file) const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "IO/NumberParser.h"
+
 #include <cassert>
 #include <string>
 
@@ -92,12 +94,12 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                return static_cast<T>(parseDouble(m_begin, m_end).value_or(0.0));
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                return static_cast<T>(parseLong(m_begin, m_end).value_or(0l));
             }
         };
     }
@@ -57,11 +57,38 @@ namespace TrenchBroom {
             }
         }
 
+        std::optional<Assets::Texture> WalTextureReader::doReadTextureHeader(std::shared_ptr<File> file) const {
+            const auto& path = file->path();
+            auto reader = file->reader().buffer();
+
+            const char version = reader.readChar<char>();
+            if (version == 3) {
+                const auto name = reader.readString(WalLayout::TextureNameLength);
+                reader.seekForward(3); // garbage
+
+                const auto width = reader.readSize<uint32_t>();
+                const auto height = reader.readSize<uint32_t>();
+                if (!checkTextureDimensions(width, height)) {
+                    return std::nullopt;
+                }
+                return Assets::Texture(textureName(name, path), width, height, GL_RGBA);
+            } else {
+                reader.seekFromBegin(0);
+                const auto name = reader.readString(WalLayout::TextureNameLength);
+                const auto width = reader.readSize<uint32_t>();
+                const auto height = reader.readSize<uint32_t>();
+                if (!checkTextureDimensions(width, height)) {
+                    return std::nullopt;
+                }
+                return Assets::Texture(textureName(name, path), width, height, GL_RGBA);
+            }
+        }
+
         Assets::Texture WalTextureReader::readQ2Wal(BufferedReader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 4;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const std::string name = reader.readString(WalLayout::TextureNameLength);
             const size_t width = reader.readSize<uint32_t>();
@@ -83,9 +110,9 @@ namespace TrenchBroom {
 
         Assets::Texture WalTextureReader::readDkWal(BufferedReader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 9;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const char version = reader.readChar<char>();
             ensure(version == 3, "Unknown WAL texture version");
@@ -129,7 +156,7 @@ namespace TrenchBroom {
         }
 
         bool WalTextureReader::readMips(const Assets::Palette& palette, const size_t mipLevels, const size_t offsets[], const size_t width, const size_t height, BufferedReader& reader, Assets::TextureBufferList& buffers, Color& averageColor, const Assets::PaletteTransparency transparency) {
-            static Color tempColor;
+            Color tempColor;
 
             auto hasTransparency = false;
             for (size_t i = 0; i < mipLevels; ++i) {
@@ -34,6 +34,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -41,6 +42,7 @@ namespace TrenchBroom {
         MapReader(std::move(str), sourceAndTargetMapFormat, sourceAndTargetMapFormat),
         m_world(std::make_unique<Model::WorldNode>(Model::Entity(), sourceAndTargetMapFormat)) {
             m_world->disableNodeTreeUpdates();
+            m_world->beginEntityNodeIndexBatch();
         }
 
         std::unique_ptr<Model::WorldNode> WorldReader::read(const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -48,6 +50,7 @@ namespace TrenchBroom {
             sanitizeLayerSortIndicies(status);
             m_world->rebuildNodeTree();
             m_world->enableNodeTreeUpdates();
+            m_world->endEntityNodeIndexBatch();
             return std::move(m_world);
         }
 
@@ -155,5 +158,12 @@ namespace TrenchBroom {
                 m_world->defaultLayer()->addChild(brush);
             }
         }
+
+        void WorldReader::onBrushes(Model::Node* parent, std::vector<Model::BrushNode*> brushes, ParserStatus& /* status */) {
+            if (parent == nullptr) {
+                parent = m_world->defaultLayer();
+            }
+            parent->addChildren(std::begin(brushes), std::end(brushes), brushes.size());
+        }
     }
 }
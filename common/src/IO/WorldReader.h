@@ -51,6 +51,7 @@ namespace TrenchBroom {
             void onNode(Model::Node* parent, Model::Node* node, ParserStatus& status) override;
             void onUnresolvedNode(const ParentInfo& parentInfo, Model::Node* node, ParserStatus& status) override;
             void onBrush(Model::Node* parent, Model::BrushNode* brush, ParserStatus& status) override;
+            void onBrushes(Model::Node* parent, std::vector<Model::BrushNode*> brushes, ParserStatus& status) override;
         };
     }
 }
@@ -62,7 +62,8 @@ namespace TrenchBroom {
 
         Brush::Brush(const Brush& other) :
         m_faces(other.m_faces),
-        m_geometry(other.m_geometry ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback()) : nullptr) {
+        m_geometry(other.m_geometry ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback()) : nullptr),
+        m_contentFlags(other.m_contentFlags) {
             if (m_geometry) {
                 for (BrushFaceGeometry* faceGeometry : m_geometry->faces()) {
                     if (const auto faceIndex = faceGeometry->payload()) {
@@ -75,7 +76,8 @@ namespace TrenchBroom {
 
         Brush::Brush(Brush&& other) noexcept :
         m_faces(std::move(other.m_faces)),
-        m_geometry(std::move(other.m_geometry)) {}
+        m_geometry(std::move(other.m_geometry)),
+        m_contentFlags(std::move(other.m_contentFlags)) {}
 
         Brush& Brush::operator=(Brush other) noexcept {
             using std::swap;
@@ -87,6 +89,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(lhs.m_faces, rhs.m_faces);
             swap(lhs.m_geometry, rhs.m_geometry);
+            swap(lhs.m_contentFlags, rhs.m_contentFlags);
         }
         
         Brush::~Brush() = default;
@@ -101,6 +104,8 @@ namespace TrenchBroom {
         }
 
         kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds) {
+            invalidateContentFlags();
+
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
             
@@ -182,6 +187,7 @@ namespace TrenchBroom {
 
         BrushFace& Brush::face(const size_t index) {
             assert(index < faceCount());
+            invalidateContentFlags();
             return m_faces[index];
         }
 
@@ -194,6 +200,7 @@ namespace TrenchBroom {
         }
 
         std::vector<BrushFace>& Brush::faces() {
+            invalidateContentFlags();
             return m_faces;
         }
 
@@ -213,7 +220,31 @@ namespace TrenchBroom {
             return true;
         }
 
+        bool Brush::hasMixedContentFlags() const {
+            // a flag is set on some faces, but not on all of them
+            const auto& flags = contentFlags();
+            return flags.anyFace != flags.allFaces;
+        }
+
+        const Brush::ContentFlags& Brush::contentFlags() const {
+            if (!m_contentFlags.has_value()) {
+                auto flags = ContentFlags{0, m_faces.empty() ? 0 : ~0};
+                for (const auto& face : m_faces) {
+                    const auto faceFlags = face.attributes().surfaceContents();
+                    flags.anyFace |= faceFlags;
+                    flags.allFaces &= faceFlags;
+                }
+                m_contentFlags = flags;
+            }
+            return *m_contentFlags;
+        }
+
+        void Brush::invalidateContentFlags() {
+            m_contentFlags = std::nullopt;
+        }
+
         void Brush::cloneFaceAttributesFrom(const Brush& brush) {
+            invalidateContentFlags();
             for (auto& destination : m_faces) {
                 if (const auto sourceIndex = brush.findFace(destination.boundary())) {
                     const auto& source = brush.face(*sourceIndex);
@@ -228,6 +259,7 @@ namespace TrenchBroom {
         }
 
         void Brush::cloneInvertedFaceAttributesFrom(const Brush& brush) {
+            invalidateContentFlags();
             for (auto& destination : m_faces) {
                 if (const auto sourceIndex = brush.findFace(destination.boundary().flip())) {
                     const auto& source = brush.face(*sourceIndex);
@@ -53,6 +53,17 @@ namespace TrenchBroom {
         private:
             std::vector<BrushFace> m_faces;
             std::unique_ptr<BrushGeometry> m_geometry;
+
+            struct ContentFlags {
+                int anyFace;
+                int allFaces;
+            };
+
+            /**
+             * The content flags of the faces, computed on demand. Since the faces can be modified through the non-const
+             * face accessors, these reset the cached flags, as does every function that replaces the faces.
+             */
+            mutable std::optional<ContentFlags> m_contentFlags;
         public:
             Brush();
 
@@ -86,6 +97,14 @@ namespace TrenchBroom {
 
             bool closed() const;
             bool fullySpecified() const;
+        public: // content flags
+            /**
+             * Indicates whether the faces of this brush have different content flags.
+             */
+            bool hasMixedContentFlags() const;
+        private:
+            const ContentFlags& contentFlags() const;
+            void invalidateContentFlags();
         public: // clone face attributes from matching faces of other brushes
             void cloneFaceAttributesFrom(const Brush& brush);
             void cloneInvertedFaceAttributesFrom(const Brush& brush);
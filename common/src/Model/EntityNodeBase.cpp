@@ -366,6 +366,7 @@ namespace TrenchBroom {
                     }
                 }
                 m_linkTargets.erase(rem, std::end(m_linkTargets));
+                linksDidChange();
             }
         }
 
@@ -385,6 +386,7 @@ namespace TrenchBroom {
                     }
                 }
                 m_killTargets.erase(rem, std::end(m_killTargets));
+                linksDidChange();
             }
         }
 
@@ -432,7 +434,7 @@ namespace TrenchBroom {
                 target->addLinkSource(this);
                 m_linkTargets.push_back(target);
             }
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addKillTargets(const std::vector<EntityNodeBase*>& targets) {
@@ -441,7 +443,7 @@ namespace TrenchBroom {
                 target->addKillSource(this);
                 m_killTargets.push_back(target);
             }
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addLinkSources(const std::vector<EntityNodeBase*>& sources) {
@@ -450,7 +452,7 @@ namespace TrenchBroom {
                 linkSource->addLinkTarget(this);
                 m_linkSources.push_back(linkSource);
             }
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addKillSources(const std::vector<EntityNodeBase*>& sources) {
@@ -459,35 +461,35 @@ namespace TrenchBroom {
                 killSource->addKillTarget(this);
                 m_killSources.push_back(killSource);
             }
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeAllLinkSources() {
             for (EntityNodeBase* linkSource : m_linkSources)
                 linkSource->removeLinkTarget(this);
             m_linkSources.clear();
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeAllLinkTargets() {
             for (EntityNodeBase* linkTarget : m_linkTargets)
                 linkTarget->removeLinkSource(this);
             m_linkTargets.clear();
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeAllKillSources() {
             for (EntityNodeBase* killSource : m_killSources)
                 killSource->removeKillTarget(this);
             m_killSources.clear();
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeAllKillTargets() {
             for (EntityNodeBase* killTarget : m_killTargets)
                 killTarget->removeKillSource(this);
             m_killTargets.clear();
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeAllLinks() {
@@ -521,43 +523,43 @@ namespace TrenchBroom {
         void EntityNodeBase::addLinkSource(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_linkSources.push_back(node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addLinkTarget(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_linkTargets.push_back(node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addKillSource(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_killSources.push_back(node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::addKillTarget(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_killTargets.push_back(node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeLinkSource(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_linkSources = kdl::vec_erase(std::move(m_linkSources), node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeLinkTarget(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_linkTargets = kdl::vec_erase(std::move(m_linkTargets), node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         void EntityNodeBase::removeKillSource(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_killSources = kdl::vec_erase(std::move(m_killSources), node);
-            invalidateIssues();
+            linksDidChange();
         }
 
         EntityNodeBase::EntityNodeBase() :
@@ -570,6 +572,12 @@ namespace TrenchBroom {
         void EntityNodeBase::removeKillTarget(EntityNodeBase* node) {
             ensure(node != nullptr, "node is null");
             m_killTargets = kdl::vec_erase(std::move(m_killTargets), node);
+            linksDidChange();
+        }
+
+        void EntityNodeBase::linksDidChange() {
+            invalidateIssues();
+            entityLinksDidChange(this);
         }
 
         bool operator==(const EntityNodeBase& lhs, const EntityNodeBase& rhs) {
@@ -134,6 +134,11 @@ namespace TrenchBroom {
             void removeLinkTarget(EntityNodeBase* node);
             void removeKillSource(EntityNodeBase* node);
             void removeKillTarget(EntityNodeBase* node);
+
+            /**
+             * Invalidates the issues of this node and notifies its ancestors that its links have changed.
+             */
+            void linksDidChange();
         protected:
             EntityNodeBase();
         private: // implemenation of node interface
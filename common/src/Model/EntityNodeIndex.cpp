@@ -25,8 +25,15 @@
 #include "Model/EntityProperties.h"
 
 #include <kdl/compact_trie.h>
+#include <kdl/string_compare.h>
+#include <kdl/vector_set.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <list>
 #include <string>
 #include <vector>
@@ -49,23 +56,32 @@ namespace TrenchBroom {
             return EntityNodeIndexQuery(Type_Any);
         }
 
-        std::set<EntityNodeBase*> EntityNodeIndexQuery::execute(const EntityNodeStringIndex& index) const {
-            std::set<EntityNodeBase*> result;
+        /**
+         * Returns the values of all keys in the given index that match the given pattern as a sorted posting list.
+         * Collecting the values in a vector and sorting it once is much faster than inserting them into a node based
+         * set one by one.
+         */
+        static kdl::vector_set<EntityNodeBase*> findMatches(const EntityNodeStringIndex& index, const std::string& pattern) {
+            std::vector<EntityNodeBase*> matches;
+            index.find_matches(pattern, std::back_inserter(matches));
+
+            kdl::vector_set<EntityNodeBase*> result;
+            result = std::move(matches);
+            return result;
+        }
+
+        kdl::vector_set<EntityNodeBase*> EntityNodeIndexQuery::execute(const EntityNodeStringIndex& index) const {
             switch (m_type) {
                 case Type_Exact:
-                    index.find_matches(m_pattern, std::inserter(result, std::end(result)));
-                    break;
+                    return findMatches(index, m_pattern);
                 case Type_Prefix:
-                    index.find_matches(m_pattern + "*", std::inserter(result, std::end(result)));
-                    break;
+                    return findMatches(index, m_pattern + "*");
                 case Type_Numbered:
-                    index.find_matches(m_pattern + "%*", std::inserter(result, std::end(result)));
-                    break;
+                    return findMatches(index, m_pattern + "%*");
                 case Type_Any:
-                    break;
+                    return {};
                 switchDefault()
             }
-            return result;
         }
 
         bool EntityNodeIndexQuery::execute(const EntityNodeBase* node, const std::string& value) const {
@@ -97,16 +113,42 @@ namespace TrenchBroom {
             }
         }
 
+        bool EntityNodeIndexQuery::matchesKey(const std::string& key) const {
+            switch (m_type) {
+                case Type_Exact:
+                    return kdl::cs::str_matches_glob(key, m_pattern);
+                case Type_Prefix:
+                    return kdl::cs::str_matches_glob(key, m_pattern + "*");
+                case Type_Numbered:
+                    return kdl::cs::str_matches_glob(key, m_pattern + "%*");
+                case Type_Any:
+                    return true;
+                switchDefault()
+            }
+        }
+
         EntityNodeIndexQuery::EntityNodeIndexQuery(const Type type, const std::string& pattern) :
         m_type(type),
         m_pattern(pattern) {}
 
         EntityNodeIndex::EntityNodeIndex() :
             m_keyIndex(std::make_unique<EntityNodeStringIndex>()),
-            m_valueIndex(std::make_unique<EntityNodeStringIndex>()) {}
+            m_valueIndex(std::make_unique<EntityNodeStringIndex>()),
+            m_batchDepth(0u) {}
 
         EntityNodeIndex::~EntityNodeIndex() = default;
 
+        void EntityNodeIndex::beginBatch() {
+            ++m_batchDepth;
+        }
+
+        void EntityNodeIndex::endBatch() {
+            assert(m_batchDepth > 0u);
+            if (--m_batchDepth == 0u) {
+                applyPendingUpdates();
+            }
+        }
+
         void EntityNodeIndex::addEntityNode(EntityNodeBase* node) {
             for (const EntityProperty& property : node->entity().properties())
                 addProperty(node, property.key(), property.value());
@@ -118,25 +160,86 @@ namespace TrenchBroom {
         }
 
         void EntityNodeIndex::addProperty(EntityNodeBase* node, const std::string& key, const std::string& value) {
-            m_keyIndex->insert(key, node);
-            m_valueIndex->insert(value, node);
+            if (m_batchDepth > 0u) {
+                addPendingUpdate(node, key, value, 1);
+            } else {
+                m_keyIndex->insert(key, node);
+                m_valueIndex->insert(value, node);
+            }
         }
 
         void EntityNodeIndex::removeProperty(EntityNodeBase* node, const std::string& key, const std::string& value) {
-            m_keyIndex->remove(key, node);
-            m_valueIndex->remove(value, node);
+            if (m_batchDepth > 0u) {
+                addPendingUpdate(node, key, value, -1);
+            } else {
+                m_keyIndex->remove(key, node);
+                m_valueIndex->remove(value, node);
+            }
+        }
+
+        /**
+         * Intersects the given sorted posting lists. If one of them is much shorter than the other, each of its nodes
+         * is searched in the longer list by galloping, i.e., by doubling the step width until the node is overtaken and
+         * then searching the last step with a binary search. The cost is then logarithmic in the length of the longer
+         * list instead of linear.
+         */
+        static std::vector<EntityNodeBase*> intersect(const kdl::vector_set<EntityNodeBase*>& lhs, const kdl::vector_set<EntityNodeBase*>& rhs) {
+            const auto& shorter = lhs.size() <= rhs.size() ? lhs : rhs;
+            const auto& longer = lhs.size() <= rhs.size() ? rhs : lhs;
+            const auto cmp = std::less<EntityNodeBase*>();
+
+            std::vector<EntityNodeBase*> result;
+            if (shorter.empty()) {
+                return result;
+            }
+
+            if (longer.size() / shorter.size() < 8u) {
+                std::set_intersection(std::begin(shorter), std::end(shorter), std::begin(longer), std::end(longer), std::back_inserter(result), cmp);
+                return result;
+            }
+
+            auto it = std::begin(longer);
+            const auto end = std::end(longer);
+            for (auto* node : shorter) {
+                const auto remaining = static_cast<size_t>(std::distance(it, end));
+                size_t step = 1u;
+                while (step < remaining && cmp(*std::next(it, static_cast<std::ptrdiff_t>(step)), node)) {
+                    step *= 2u;
+                }
+
+                const auto first = std::next(it, static_cast<std::ptrdiff_t>(step / 2u));
+                const auto last = std::next(it, static_cast<std::ptrdiff_t>(std::min(step + 1u, remaining)));
+                it = std::lower_bound(first, last, node, cmp);
+                if (it == end) {
+                    break;
+                }
+                if (*it == node) {
+                    result.push_back(node);
+                    ++it;
+                }
+            }
+
+            return result;
         }
 
         std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(const EntityNodeIndexQuery& keyQuery, const std::string& value) const {
-            const std::set<EntityNodeBase*> nameResult = keyQuery.execute(*m_keyIndex);
+            if (hasPendingUpdates(keyQuery, value)) {
+                applyPendingUpdates();
+            }
 
-            std::set<EntityNodeBase*> valueResult;
-            m_valueIndex->find_matches(value, std::inserter(valueResult, std::end(valueResult)));
-            if (nameResult.empty() || valueResult.empty()) {
+            // the value usually matches far fewer nodes than the key, so look it up first to avoid collecting the
+            // nodes of the key if there is no match at all
+            const auto valueResult = findMatches(*m_valueIndex, value);
+            if (valueResult.empty()) {
                 return {};
             }
 
-            std::vector<EntityNodeBase*> result = kdl::set_intersection(nameResult, valueResult);
+            const auto nameResult = keyQuery.execute(*m_keyIndex);
+            if (nameResult.empty()) {
+                return {};
+            }
+
+            std::vector<EntityNodeBase*> result = intersect(valueResult, nameResult);
 
             auto it = std::begin(result);
             while (it != std::end(result)) {
@@ -151,15 +254,19 @@ namespace TrenchBroom {
         }
 
         std::vector<std::string> EntityNodeIndex::allKeys() const {
+            applyPendingUpdates();
+
             std::vector<std::string> result;
             m_keyIndex->get_keys(std::back_inserter(result));
             return result;
         }
 
         std::vector<std::string> EntityNodeIndex::allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const {
+            applyPendingUpdates();
+
             std::vector<std::string> result;
 
-            const std::set<EntityNodeBase*> nameResult = keyQuery.execute(*m_keyIndex);
+            const auto nameResult = keyQuery.execute(*m_keyIndex);
             for (const auto node : nameResult) {
                 const auto matchingProperties = keyQuery.execute(node);
                 for (const auto& property : matchingProperties) {
@@ -169,5 +276,91 @@ namespace TrenchBroom {
 
             return result;
         }
+
+        void EntityNodeIndex::addPendingUpdate(EntityNodeBase* node, const std::string& key, const std::string& value, const int delta) {
+            // the deque never moves its elements when appending, so the value can be referenced by the lookup table
+            const auto& update = m_pendingUpdates.emplace_back(PendingUpdate{node, key, value, delta});
+            m_pendingUpdatesByValue.emplace(update.value, &update);
+        }
+
+        bool EntityNodeIndex::hasPendingUpdates() const {
+            return !m_pendingUpdates.empty();
+        }
+
+        bool EntityNodeIndex::hasPendingUpdates(const EntityNodeIndexQuery& keyQuery, const std::string& value) const {
+            if (m_pendingUpdates.empty()) {
+                return false;
+            }
+
+            // the value is matched as a glob pattern, so the lookup table cannot be used if it contains wildcards
+            if (value.find_first_of("*?%\\") != std::string::npos) {
+                return true;
+            }
+
+            // Only an update of a property with the given value can add a node to the result or remove one from it.
+            // Nodes whose other properties are updated are still checked against their entities.
+            const auto [first, last] = m_pendingUpdatesByValue.equal_range(value);
+            return std::any_of(first, last, [&](const auto& entry) {
+                return keyQuery.matchesKey(entry.second->key);
+            });
+        }
+
+        void EntityNodeIndex::applyPendingUpdates() const {
+            if (m_pendingUpdates.empty()) {
+                return;
+            }
+
+            std::vector<const PendingUpdate*> updates;
+            updates.reserve(m_pendingUpdates.size());
+            for (const auto& update : m_pendingUpdates) {
+                updates.push_back(&update);
+            }
+
+            applyPendingUpdates(*m_keyIndex, updates, &PendingUpdate::key);
+            applyPendingUpdates(*m_valueIndex, updates, &PendingUpdate::value);
+
+            m_pendingUpdatesByValue.clear();
+            m_pendingUpdates.clear();
+        }
+
+        void EntityNodeIndex::applyPendingUpdates(EntityNodeStringIndex& index, std::vector<const PendingUpdate*>& updates, std::string PendingUpdate::*member) {
+            // sort the updates by the indexed string and node so that the updates of each node cancel each other out
+            // and every string is only looked up once
+            std::sort(std::begin(updates), std::end(updates), [&](const auto* lhs, const auto* rhs) {
+                const int cmp = (lhs->*member).compare(rhs->*member);
+                return cmp < 0 || (cmp == 0 && std::less<EntityNodeBase*>()(lhs->node, rhs->node));
+            });
+
+            std::vector<EntityNodeBase*> removedNodes;
+            std::vector<EntityNodeBase*> addedNodes;
+
+            auto it = std::begin(updates);
+            const auto end = std::end(updates);
+            while (it != end) {
+                const std::string& str = (*it)->*member;
+                removedNodes.clear();
+                addedNodes.clear();
+
+                while (it != end && (*it)->*member == str) {
+                    auto* node = (*it)->node;
+                    int delta = 0;
+                    while (it != end && (*it)->node == node && (*it)->*member == str) {
+                        delta += (*it)->delta;
+                        ++it;
+                    }
+
+                    for (; delta < 0; ++delta) {
+                        removedNodes.push_back(node);
+                    }
+                    for (; delta > 0; --delta) {
+                        addedNodes.push_back(node);
+                    }
+                }
+
+                // removals never depend on additions in the same batch, so they can safely be applied first
+                index.remove(str, std::begin(removedNodes), std::end(removedNodes));
+                index.insert(str, std::begin(addedNodes), std::end(addedNodes));
+            }
+        }
     }
 }
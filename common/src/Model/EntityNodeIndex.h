@@ -20,10 +20,13 @@
 #pragma once
 
 #include <kdl/compact_trie_forward.h>
+#include <kdl/vector_set_forward.h>
 
+#include <deque>
 #include <memory>
-#include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -50,30 +53,81 @@ namespace TrenchBroom {
             static EntityNodeIndexQuery numbered(const std::string& pattern);
             static EntityNodeIndexQuery any();
 
-            std::set<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
+            /**
+             * Returns the nodes whose keys match this query, sorted by their addresses.
+             */
+            kdl::vector_set<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
             bool execute(const EntityNodeBase* node, const std::string& value) const;
             std::vector<Model::EntityProperty> execute(const EntityNodeBase* node) const;
+
+            /**
+             * Indicates whether the given property key matches this query.
+             */
+            bool matchesKey(const std::string& key) const;
         private:
             explicit EntityNodeIndexQuery(Type type, const std::string& pattern = "");
         };
 
         class EntityNodeIndex {
         private:
+            struct PendingUpdate {
+                EntityNodeBase* node;
+                std::string key;
+                std::string value;
+                int delta;
+            };
+
             std::unique_ptr<EntityNodeStringIndex> m_keyIndex;
             std::unique_ptr<EntityNodeStringIndex> m_valueIndex;
+
+            size_t m_batchDepth;
+            mutable std::deque<PendingUpdate> m_pendingUpdates;
+            mutable std::unordered_multimap<std::string_view, const PendingUpdate*> m_pendingUpdatesByValue;
         public:
             EntityNodeIndex();
             ~EntityNodeIndex();
 
+            /**
+             * Starts a batch of updates. Until the matching call to endBatch, added and removed properties are
+             * collected instead of being applied to the index one at a time. When the batch ends, the collected
+             * updates are sorted so that each key and value is only looked up once.
+             *
+             * Queries return the same results while a batch is active, but they might apply the collected updates
+             * early if any of them could change the result. Calls can be nested, and the nodes whose properties were
+             * updated must not be deleted before the batch ends.
+             */
+            void beginBatch();
+            void endBatch();
+
             void addEntityNode(EntityNodeBase* node);
             void removeEntityNode(EntityNodeBase* node);
 
             void addProperty(EntityNodeBase* node, const std::string& key, const std::string& value);
             void removeProperty(EntityNodeBase* node, const std::string& key, const std::string& value);
 
+            /**
+             * Indicates whether updates collected by an active batch were not applied to the index yet.
+             */
+            bool hasPendingUpdates() const;
+
+            /**
+             * Applies the updates collected by an active batch to the index. Queries apply the updates themselves if
+             * necessary, which modifies the index, so this must be called before the index is queried by several
+             * threads at once.
+             */
+            void applyPendingUpdates() const;
+
+            /**
+             * Queries may apply pending updates, see applyPendingUpdates, so they must not be called by several
+             * threads at once while updates are pending.
+             */
             std::vector<EntityNodeBase*> findEntityNodes(const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
             std::vector<std::string> allKeys() const;
             std::vector<std::string> allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const;
+        private:
+            void addPendingUpdate(EntityNodeBase* node, const std::string& key, const std::string& value, int delta);
+            bool hasPendingUpdates(const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
+            static void applyPendingUpdates(EntityNodeStringIndex& index, std::vector<const PendingUpdate*>& updates, std::string PendingUpdate::*member);
         };
     }
 }
@@ -253,7 +253,7 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(entity);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger, textureManager.compressedTextureCache());
             textureLoader.loadTextures(paths, textureManager);
         }
 
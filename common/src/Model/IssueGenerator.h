@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "Model/IssueType.h"
 
+#include <vecmath/bbox.h>
+
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -50,6 +54,16 @@ namespace TrenchBroom {
             const std::string& description() const;
             const IssueQuickFixList& quickFixes() const;
 
+            /**
+             * Returns the bounds which contain the logical bounds of every node for which this generator doesn't
+             * generate any issues, or nothing if this generator doesn't check the bounds of nodes. A generator that
+             * returns bounds here must only generate issues for brushes and entities.
+             *
+             * When many nodes are validated, the world only applies such a generator to the nodes that it finds with a
+             * single query against its spatial index rather than to every node.
+             */
+            std::optional<vm::bbox3> validBounds() const;
+
             void generate(WorldNode* worldNode,   IssueList& issues) const;
             void generate(LayerNode* layerNode,   IssueList& issues) const;
             void generate(GroupNode* groupNode,   IssueList& issues) const;
@@ -59,6 +73,8 @@ namespace TrenchBroom {
             IssueGenerator(IssueType type, const std::string& description);
             void addQuickFix(IssueQuickFix* quickFix);
         private:
+            virtual std::optional<vm::bbox3> doGetValidBounds() const;
+
             virtual void doGenerate(WorldNode* worldNode,           IssueList& issues) const;
             virtual void doGenerate(LayerNode* layerNode,           IssueList& issues) const;
             virtual void doGenerate(GroupNode* groupNode,           IssueList& issues) const;
@@ -19,13 +19,11 @@
 
 #include "MixedBrushContentsIssueGenerator.h"
 
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
-#include "Model/BrushFace.h"
 #include "Model/Issue.h"
 
-#include <cassert>
 #include <string>
-#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -53,19 +51,8 @@ namespace TrenchBroom {
         IssueGenerator(MixedBrushContentsIssue::Type, "Mixed brush content flags") {}
 
         void MixedBrushContentsIssueGenerator::doGenerate(BrushNode* brushNode, IssueList& issues) const {
-            const Brush& brush = brushNode->brush();
-            const auto& faces = brush.faces();
-            auto it = std::begin(faces);
-            auto end = std::end(faces);
-            assert(it != end);
-
-            const int contentFlags = it->attributes().surfaceContents();
-            ++it;
-            while (it != end) {
-                if (it->attributes().surfaceContents() != contentFlags) {
-                    issues.push_back(new MixedBrushContentsIssue(brushNode));
-                }
-                ++it;
+            if (brushNode->brush().hasMixedContentFlags()) {
+                issues.push_back(new MixedBrushContentsIssue(brushNode));
             }
         }
     }
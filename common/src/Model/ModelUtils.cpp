@@ -34,6 +34,7 @@
 #include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -159,65 +160,114 @@ namespace TrenchBroom {
         }
 
         /**
-         * Recursively collect brushes and entities from the given vector of node trees such that
-         * the returned nodes match the given predicate. A matching brush is only returned if it
-         * isn't in the given vector brushes. A node matches the given predicate if there is a brush
-         * in the given vector of brushes such that the predicate evaluates to true for that pair of
-         * node and brush.
+         * Returns whether the given node is contained in a group that is not open.
+         */
+        static bool isInClosedGroup(const Node* node) {
+            for (const auto* parent = node->parent(); parent != nullptr; parent = parent->parent()) {
+                const auto closedGroup = parent->accept(kdl::overload(
+                    [] (const WorldNode*)       { return false; },
+                    [] (const LayerNode*)       { return false; },
+                    [] (const GroupNode* group) { return !group->opened(); },
+                    [] (const EntityNode*)      { return false; },
+                    [] (const BrushNode*)       { return false; }
+                ));
+                if (closedGroup) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Returns the outermost groups in the given world that are not open.
+         */
+        static std::vector<GroupNode*> collectClosedGroups(WorldNode* world) {
+            auto result = std::vector<GroupNode*>{};
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* worldNode) { worldNode->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group) {
+                    if (group->opened()) {
+                        group->visitChildren(thisLambda);
+                    } else {
+                        result.push_back(group);
+                    }
+                },
+                [] (EntityNode*) {},
+                [] (BrushNode*)  {}
+            ));
+            return result;
+        }
+
+        /**
+         * Collects brushes, entities and closed groups from the given world such that the returned nodes match the given
+         * predicate. A matching brush is only returned if it isn't in the given vector brushes. A node matches the given
+         * predicate if there is a brush in the given vector of brushes such that the predicate evaluates to true for that
+         * pair of node and brush.
+         *
+         * Brushes and entities are only considered if they are returned by a spatial query for the bounds of each brush.
+         * Closed groups are matched by their own bounds like before, but since groups aren't contained in the spatial
+         * index, every outermost closed group is tested.
          *
-         * The given predicate must be a function that maps a node and a brush to true or false.
+         * The given predicate must be a function that maps a node and a brush to true or false. It must only be true if
+         * the bounds of the node and the brush intersect.
          */
         template <typename P>
-        static std::vector<Node*> collectMatchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes, const P& predicate) {
+        static std::vector<Node*> collectMatchingNodes(WorldNode* world, const std::vector<BrushNode*>& brushes, const P& predicate) {
             auto result = std::vector<Model::Node*>{};
+            auto matched = std::unordered_set<Model::Node*>{};
+            const auto queryBrushes = std::unordered_set<const Model::BrushNode*>(std::begin(brushes), std::end(brushes));
 
-            const auto collectIfMatching = [&](auto* node) {
-                for (const auto* brush : brushes) {
-                    if (predicate(node, brush)) {
-                        result.push_back(node);
-                        return;
-                    }
+            const auto collectIfMatching = [&](auto* node, const auto* brush) {
+                if (matched.count(node) == 0u && predicate(node, brush)) {
+                    matched.insert(node);
+                    result.push_back(node);
                 }
             };
 
-            for (auto* node : nodes) {
-                node->accept(kdl::overload(
-                    [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group) { 
-                        if (group->opened()) {
-                            group->visitChildren(thisLambda);
-                        } else {
-                            collectIfMatching(group);
-                        }
-                    },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { 
-                        if (entity->hasChildren()) {
-                            entity->visitChildren(thisLambda);
-                        } else {
-                            collectIfMatching(entity);
-                        }
-                    },
-                    [&](Model::BrushNode* brush)  { 
-                        // if `brush` is one of the search query nodes, don't count it as touching
-                        if (!kdl::vec_contains(brushes, brush)) {
-                            collectIfMatching(brush);
-                        }
+            const auto closedGroups = collectClosedGroups(world);
+            for (const auto* brush : brushes) {
+                for (auto* group : closedGroups) {
+                    collectIfMatching(group, brush);
+                }
+
+                for (auto* node : world->findNodesIntersecting(brush->logicalBounds())) {
+                    if (isInClosedGroup(node)) {
+                        // matched by its group above
+                        continue;
                     }
-                ));
+
+                    node->accept(kdl::overload(
+                        [] (Model::WorldNode*) {},
+                        [] (Model::LayerNode*) {},
+                        [] (Model::GroupNode*) {},
+                        [&](Model::EntityNode* entity) {
+                            // brush entities are matched by their brushes
+                            if (!entity->hasChildren()) {
+                                collectIfMatching(entity, brush);
+                            }
+                        },
+                        [&](Model::BrushNode* brushNode) {
+                            // if `brushNode` is one of the search query nodes, don't count it as touching
+                            if (queryBrushes.count(brushNode) == 0u) {
+                                collectIfMatching(brushNode, brush);
+                            }
+                        }
+                    ));
+                }
             }
 
             return result;
         }
 
-        std::vector<Node*> collectTouchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes) {
-            return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
+        std::vector<Node*> collectTouchingNodes(WorldNode* world, const std::vector<BrushNode*>& brushes) {
+            return collectMatchingNodes(world, brushes, [](const auto* node, const auto* brush) {
                 return brush->intersects(node);
             });
         }
 
-        std::vector<Node*> collectContainedNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes) {
-            return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
+        std::vector<Node*> collectContainedNodes(WorldNode* world, const std::vector<BrushNode*>& brushes) {
+            return collectMatchingNodes(world, brushes, [](const auto* node, const auto* brush) {
                 return brush->contains(node);
             });
         }
@@ -33,6 +33,7 @@ namespace TrenchBroom {
         class EditorContext;
         class LayerNode;
         class Node;
+        class WorldNode;
 
         LayerNode* findContainingLayer(Node* node);
 
@@ -55,8 +56,13 @@ namespace TrenchBroom {
 
         std::vector<Node*> collectNodes(const std::vector<Node*>& nodes);
 
-        std::vector<Node*> collectTouchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
-        std::vector<Node*> collectContainedNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
+        /**
+         * Collects the brushes, entities and closed groups in the given world that touch or are contained in any of the
+         * given brushes. The candidates are found using the world's spatial index, so only nodes whose bounds intersect
+         * the bounds of one of the given brushes are tested exactly. The given brushes themselves are never returned.
+         */
+        std::vector<Node*> collectTouchingNodes(WorldNode* world, const std::vector<BrushNode*>& brushes);
+        std::vector<Node*> collectContainedNodes(WorldNode* world, const std::vector<BrushNode*>& brushes);
 
         std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 
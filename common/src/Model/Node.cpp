@@ -623,15 +623,22 @@ namespace TrenchBroom {
             }
         }
 
-        void Node::invalidateIssues() const {
+        void Node::invalidateIssues() {
             clearIssues();
-            m_issuesValid = false;
+            if (m_issuesValid) {
+                m_issuesValid = false;
+                issuesWereInvalidated(this);
+            }
         }
 
         void Node::clearIssues() const {
             kdl::vec_clear_and_delete(m_issues);
         }
 
+        void Node::issuesWereInvalidated(Node* node) {
+            doIssuesWereInvalidated(node);
+        }
+
         void Node::findEntityNodesWithProperty(const std::string& key, const std::string& value, std::vector<EntityNodeBase*>& result) const {
             return doFindEntityNodesWithProperty(key, value, result);
         }
@@ -648,6 +655,10 @@ namespace TrenchBroom {
             doRemoveFromIndex(node, key, value);
         }
 
+        void Node::entityLinksDidChange(EntityNodeBase* node) {
+            doEntityLinksDidChange(node);
+        }
+
         Node* Node::doCloneRecursively(const vm::bbox3& worldBounds) const {
             Node* clone = Node::clone(worldBounds);
             clone->addChildren(Node::cloneRecursively(worldBounds, children()));
@@ -698,5 +709,15 @@ namespace TrenchBroom {
             if (m_parent != nullptr)
                 m_parent->removeFromIndex(node, key, value);
         }
+
+        void Node::doEntityLinksDidChange(EntityNodeBase* node) {
+            if (m_parent != nullptr)
+                m_parent->entityLinksDidChange(node);
+        }
+
+        void Node::doIssuesWereInvalidated(Node* node) {
+            if (m_parent != nullptr)
+                m_parent->issuesWereInvalidated(node);
+        }
     }
 }
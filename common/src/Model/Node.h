@@ -298,10 +298,11 @@ namespace TrenchBroom {
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
-            void invalidateIssues() const;
+            void invalidateIssues();
         private:
             void validateIssues(const std::vector<IssueGenerator*>& issueGenerators);
             void clearIssues() const;
+            void issuesWereInvalidated(Node* node);
         public: // visitors
             /**
              * Visit this node with the given lambda and return the lambda's return value or nothing
@@ -411,6 +412,11 @@ namespace TrenchBroom {
 
             void addToIndex(EntityNodeBase* node, const std::string& key, const std::string& value);
             void removeFromIndex(EntityNodeBase* node, const std::string& key, const std::string& value);
+
+            /**
+             * Notifies the ancestors of this node that links were added to or removed from the given entity node.
+             */
+            void entityLinksDidChange(EntityNodeBase* node);
         private: // subclassing interface
             virtual const std::string& doGetName() const = 0;
             virtual const vm::bbox3& doGetLogicalBounds() const = 0;
@@ -456,6 +462,7 @@ namespace TrenchBroom {
             virtual void doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) = 0;
 
             virtual void doGenerateIssues(const IssueGenerator* generator, std::vector<Issue*>& issues) = 0;
+            virtual void doIssuesWereInvalidated(Node* node);
 
             virtual void doAccept(NodeVisitor& visitor) = 0;
             virtual void doAccept(ConstNodeVisitor& visitor) const = 0;
@@ -465,6 +472,7 @@ namespace TrenchBroom {
 
             virtual void doAddToIndex(EntityNodeBase* node, const std::string& key, const std::string& value);
             virtual void doRemoveFromIndex(EntityNodeBase* node, const std::string& key, const std::string& value);
+            virtual void doEntityLinksDidChange(EntityNodeBase* node);
         };
     }
 }
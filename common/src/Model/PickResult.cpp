@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "Model/CompareHits.h"
 #include "Model/Hit.h"
+#include "Model/HitFilter.h"
 #include "Model/HitQuery.h"
 
 #include <vecmath/scalar.h>
@@ -30,6 +31,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace TrenchBroom {
     namespace Model {
@@ -41,13 +43,16 @@ namespace TrenchBroom {
             bool operator()(const Hit& lhs, const Hit& rhs) const { return m_compare->compare(lhs, rhs) < 0; }
         };
 
-        PickResult::PickResult(const EditorContext& editorContext, std::shared_ptr<CompareHits> compare) :
+        PickResult::PickResult(const EditorContext& editorContext, std::shared_ptr<CompareHits> compare, std::shared_ptr<const HitFilter> nearestFilter) :
         m_editorContext(&editorContext),
-        m_compare(std::move(compare)) {}
+        m_compare(std::move(compare)),
+        m_nearestFilter(std::move(nearestFilter)),
+        m_maxDistance(std::numeric_limits<FloatType>::max()) {}
 
         PickResult::PickResult() :
         m_editorContext(nullptr),
-        m_compare(std::make_shared<CompareHitsByDistance>()) {}
+        m_compare(std::make_shared<CompareHitsByDistance>()),
+        m_maxDistance(std::numeric_limits<FloatType>::max()) {}
 
         PickResult::~PickResult() = default;
 
@@ -61,6 +66,13 @@ namespace TrenchBroom {
             return PickResult(editorContext, std::make_shared<CompareHitsBySize>(axis));
         }
 
+        PickResult PickResult::nearestByDistance(const EditorContext& editorContext, std::unique_ptr<HitFilter> filter) {
+            ensure(filter != nullptr, "filter is null");
+            return PickResult(editorContext, std::make_shared<CombineCompareHits>(
+                std::make_unique<CompareHitsByDistance>(),
+                std::make_unique<CompareHitsByType>()), std::move(filter));
+        }
+
         bool PickResult::empty() const {
             return m_hits.empty();
         }
@@ -78,6 +90,14 @@ namespace TrenchBroom {
             ensure(m_compare.get() != nullptr, "compare is null");
             auto pos = std::upper_bound(std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
             m_hits.insert(pos, hit);
+
+            if (m_nearestFilter != nullptr && hit.distance() < m_maxDistance && m_nearestFilter->matches(hit)) {
+                m_maxDistance = hit.distance();
+            }
+        }
+
+        FloatType PickResult::maxDistance() const {
+            return m_maxDistance;
         }
 
         const std::vector<Hit>& PickResult::all() const {
@@ -92,6 +112,7 @@ namespace TrenchBroom {
 
         void PickResult::clear() {
             m_hits.clear();
+            m_maxDistance = std::numeric_limits<FloatType>::max();
         }
     }
 }
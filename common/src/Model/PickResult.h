@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "Macros.h"
 #include "Model/Hit.h"
 
@@ -31,6 +32,7 @@ namespace TrenchBroom {
     namespace Model {
         class CompareHits;
         class EditorContext;
+        class HitFilter;
         class HitQuery;
 
         class PickResult {
@@ -38,9 +40,11 @@ namespace TrenchBroom {
             const EditorContext* m_editorContext;
             std::vector<Hit> m_hits;
             std::shared_ptr<CompareHits> m_compare;
+            std::shared_ptr<const HitFilter> m_nearestFilter;
+            FloatType m_maxDistance;
             class CompareWrapper;
         public:
-            PickResult(const EditorContext& editorContext, std::shared_ptr<CompareHits> compare);
+            PickResult(const EditorContext& editorContext, std::shared_ptr<CompareHits> compare, std::shared_ptr<const HitFilter> nearestFilter = nullptr);
             PickResult();
 
             defineCopyAndMove(PickResult)
@@ -50,11 +54,28 @@ namespace TrenchBroom {
             static PickResult byDistance(const EditorContext& editorContext);
             static PickResult bySize(const EditorContext& editorContext, vm::axis::type axis);
 
+            /**
+             * Returns a pick result that orders hits by distance and that is only interested in the nearest hit matching
+             * the given filter. Once such a hit has been added, hits further away can no longer affect the result, and
+             * pickers may skip any objects that lie beyond maxDistance().
+             *
+             * Only use this if the result is queried for the first hit matching the given filter. Queries for other hits
+             * may not find hits that are further away than the nearest matching hit.
+             */
+            static PickResult nearestByDistance(const EditorContext& editorContext, std::unique_ptr<HitFilter> filter);
+
             bool empty() const;
             size_t size() const;
 
             void addHit(const Hit& hit);
 
+            /**
+             * Returns the distance beyond which hits cannot affect this pick result. This is the distance of the nearest
+             * hit matching the filter passed to nearestByDistance(), and the maximum float value for all other pick
+             * results or if no such hit has been added yet.
+             */
+            FloatType maxDistance() const;
+
             const std::vector<Hit>& all() const;
             HitQuery query() const;
 
@@ -29,6 +29,7 @@
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
 
+#include <cstddef>
 #include <initializer_list>
 #include <limits>
 #include <optional>
@@ -101,6 +102,12 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Vertex(const vm::vec<T,3>& position);
         public:
+            /**
+             * Allocates and frees vertices using a Polyhedron_Pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr, std::size_t size);
+
             /**
              * Returns the position of this vertex.
              */
@@ -235,6 +242,12 @@ namespace TrenchBroom {
              */
             Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
         public:
+            /**
+             * Allocates and frees edges using a Polyhedron_Pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr, std::size_t size);
+
             /**
              * Returns the origin of the first half edge.
              */
@@ -513,6 +526,12 @@ namespace TrenchBroom {
              */
             Polyhedron_HalfEdge(Vertex* origin);
         public:
+            /**
+             * Allocates and frees half edges using a Polyhedron_Pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr, std::size_t size);
+
             /**
              * Returns the origin vertex of this half edge.
              */
@@ -718,6 +737,12 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T,3>& plane);
         public:
+            /**
+             * Allocates and frees faces using a Polyhedron_Pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr, std::size_t size);
+
             /**
              * Returns the circular list of half edges that make up the boundary of this face.
              */
@@ -1123,6 +1148,12 @@ namespace TrenchBroom {
              * Move assignment operator.
              */
             Polyhedron<T,FP,VP>& operator=(Polyhedron<T,FP,VP>&& other);
+        public: // memory management
+            /**
+             * Returns the memory of the pools of vertices, edges, half edges and faces which is not used by any
+             * polyhedron of this type to the heap. See Polyhedron_Pool::releaseFreeSlabs.
+             */
+            static void releaseUnusedMemory();
         private: // Copy helper
             class Copy;
         public: // swap function, must be implemented here because it's a public template
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Polyhedron.h"
+#include "Polyhedron_Pool.h"
 #include "Macros.h"
 
 #include <vecmath/vec.h>
@@ -40,6 +41,16 @@ namespace TrenchBroom {
             return edge->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Edge<T,FP,VP>::operator new(const std::size_t size) {
+            return Polyhedron_allocate<Polyhedron_Edge<T,FP,VP>>(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Edge<T,FP,VP>::operator delete(void* ptr, const std::size_t size) {
+            Polyhedron_deallocate<Polyhedron_Edge<T,FP,VP>>(ptr, size);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Edge<T,FP,VP>::Polyhedron_Edge(HalfEdge* first, HalfEdge* second) :
             m_first(first),
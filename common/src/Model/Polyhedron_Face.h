@@ -22,6 +22,7 @@
 #include "Macros.h"
 
 #include "Polyhedron.h"
+#include "Polyhedron_Pool.h"
 
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
@@ -45,6 +46,16 @@ namespace TrenchBroom {
             return face->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Face<T,FP,VP>::operator new(const std::size_t size) {
+            return Polyhedron_allocate<Polyhedron_Face<T,FP,VP>>(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Face<T,FP,VP>::operator delete(void* ptr, const std::size_t size) {
+            Polyhedron_deallocate<Polyhedron_Face<T,FP,VP>>(ptr, size);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Face<T,FP,VP>::Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T,3>& plane) :
             m_boundary(std::move(boundary)),
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Polyhedron.h"
+#include "Polyhedron_Pool.h"
 
 namespace TrenchBroom {
     namespace Model {
@@ -33,6 +34,16 @@ namespace TrenchBroom {
             return halfEdge->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_HalfEdge<T,FP,VP>::operator new(const std::size_t size) {
+            return Polyhedron_allocate<Polyhedron_HalfEdge<T,FP,VP>>(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_HalfEdge<T,FP,VP>::operator delete(void* ptr, const std::size_t size) {
+            Polyhedron_deallocate<Polyhedron_HalfEdge<T,FP,VP>>(ptr, size);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_HalfEdge<T,FP,VP>::Polyhedron_HalfEdge(Vertex* origin) :
             m_origin(origin),
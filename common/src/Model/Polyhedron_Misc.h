@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Polyhedron.h"
+#include "Polyhedron_Pool.h"
 
 #include <kdl/vector_utils.h>
 
@@ -221,6 +222,14 @@ namespace TrenchBroom {
         template <typename T, typename FP, typename VP>
         Polyhedron<T,FP,VP>& Polyhedron<T,FP,VP>::operator=(Polyhedron<T,FP,VP>&& other) = default;
 
+        template <typename T, typename FP, typename VP>
+        void Polyhedron<T,FP,VP>::releaseUnusedMemory() {
+            Polyhedron_releaseFreeSlabs<Vertex>();
+            Polyhedron_releaseFreeSlabs<Edge>();
+            Polyhedron_releaseFreeSlabs<HalfEdge>();
+            Polyhedron_releaseFreeSlabs<Face>();
+        }
+
         /**
          * Copies a polyhedron.
          */
@@ -275,6 +284,9 @@ namespace TrenchBroom {
              */
             Copy(const FaceList& originalFaces, const EdgeList& originalEdges, const VertexList& originalVertices, Polyhedron& destination, const CopyCallback& callback) :
                 m_destination(destination) {
+                m_vertexMap.reserve(originalVertices.size());
+                m_halfEdgeMap.reserve(2u * originalEdges.size());
+
                 copyVertices(originalVertices, callback);
                 copyFaces(originalFaces, callback);
                 copyEdges(originalEdges);
@@ -0,0 +1,297 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * A slab allocator for the vertices, edges, half edges and faces of polyhedra.
+         *
+         * Polyhedra consist of many small objects which are created and destroyed in large numbers whenever a brush is
+         * built, copied, clipped or destroyed. Allocating each of them individually from the heap is expensive, so this
+         * pool allocates memory in slabs of many slots and hands out individual slots. Freed slots are put into a free
+         * list and reused by later allocations, which turns allocating and freeing a slot into a few pointer operations.
+         *
+         * Every thread caches a free list of its own, so allocation and deallocation do not require any synchronization
+         * most of the time. The caches exchange slots with a shared free list in batches of SlabSize slots: a thread whose
+         * cache runs empty takes a batch from the shared list, and a thread whose cache grows beyond MaxCachedSlots gives
+         * a batch back. When a thread ends, all slots in its cache are returned to the shared list. Therefore slots freed
+         * on short lived worker threads are reused by other threads, and a slot that was allocated by one thread can be
+         * freed by any other thread.
+         *
+         * The slabs are only returned to the heap by releaseFreeSlabs, which releases the slabs whose slots are all in the
+         * shared free list. Until then, the memory used by the pool is bounded by the peak number of slots that were in
+         * use at the same time, plus the slots cached by the threads that are alive.
+         *
+         * Objects with the same size and alignment share a pool.
+         *
+         * @tparam Size the size of the slots
+         * @tparam Alignment the alignment of the slots
+         */
+        template <std::size_t Size, std::size_t Alignment>
+        class Polyhedron_Pool {
+        private:
+            union Slot {
+                Slot* next;
+                alignas(Alignment) unsigned char storage[Size];
+            };
+
+            /**
+             * A singly linked list of free slots.
+             */
+            struct FreeList {
+                Slot* first = nullptr;
+                std::size_t count = 0u;
+            };
+
+            static constexpr std::size_t SlabSize = 1024u;
+            static constexpr std::size_t MaxCachedSlots = 2u * SlabSize;
+
+            /**
+             * The slabs and the batches of free slots that are not cached by any thread.
+             */
+            struct Shared {
+                std::mutex mutex;
+                std::vector<std::unique_ptr<Slot[]>> slabs;
+                std::vector<FreeList> batches;
+            };
+
+            /**
+             * The free list cached by a thread. Its slots are returned to the shared free list when the thread ends.
+             */
+            struct ThreadCache {
+                FreeList freeList;
+
+                ~ThreadCache() {
+                    if (freeList.first != nullptr) {
+                        putBatch(freeList);
+                    }
+                }
+            };
+        public:
+            /**
+             * Returns a slot of memory suitable to hold an object of the pool's size.
+             */
+            static void* allocate() {
+                FreeList& freeList = threadCache().freeList;
+                if (freeList.first == nullptr) {
+                    freeList = takeBatch();
+                }
+
+                Slot* slot = freeList.first;
+                freeList.first = slot->next;
+                --freeList.count;
+                return slot;
+            }
+
+            /**
+             * Returns the given slot to the calling thread's free list. The given pointer must have been returned by a
+             * call to allocate, but not necessarily on the same thread.
+             *
+             * @param ptr the slot to free
+             */
+            static void deallocate(void* ptr) {
+                if (ptr != nullptr) {
+                    FreeList& freeList = threadCache().freeList;
+                    Slot* slot = static_cast<Slot*>(ptr);
+                    slot->next = freeList.first;
+                    freeList.first = slot;
+                    ++freeList.count;
+
+                    if (freeList.count > MaxCachedSlots) {
+                        putBatch(splitBatch(freeList));
+                    }
+                }
+            }
+
+            /**
+             * Returns the slabs whose slots are all free to the heap. This is meant to be called after many objects
+             * were destroyed, e.g. when a document is cleared.
+             *
+             * The slots cached by the calling thread are returned to the shared free list first, but the slots cached
+             * by other threads are not considered, so their slabs are kept.
+             */
+            static void releaseFreeSlabs() {
+                FreeList& freeList = threadCache().freeList;
+                if (freeList.first != nullptr) {
+                    putBatch(std::exchange(freeList, FreeList{}));
+                }
+
+                auto& instance = shared();
+                const auto lock = std::lock_guard<std::mutex>(instance.mutex);
+
+                // sort the slabs by address so that the slab of a slot can be found by binary search
+                std::sort(std::begin(instance.slabs), std::end(instance.slabs), [](const auto& lhs, const auto& rhs) {
+                    return std::less<const Slot*>()(lhs.get(), rhs.get());
+                });
+                const auto findSlab = [&](const Slot* slot) {
+                    const auto it = std::upper_bound(std::begin(instance.slabs), std::end(instance.slabs), slot, [](const Slot* s, const auto& slab) {
+                        return std::less<const Slot*>()(s, slab.get());
+                    });
+                    assert(it != std::begin(instance.slabs));
+                    return static_cast<std::size_t>(std::distance(std::begin(instance.slabs), it)) - 1u;
+                };
+
+                auto freeSlotCounts = std::vector<std::size_t>(instance.slabs.size(), 0u);
+                for (const auto& batch : instance.batches) {
+                    for (const Slot* slot = batch.first; slot != nullptr; slot = slot->next) {
+                        ++freeSlotCounts[findSlab(slot)];
+                    }
+                }
+
+                // collect the free slots of the slabs which are kept into new batches
+                auto batches = std::vector<FreeList>{};
+                for (const auto& batch : instance.batches) {
+                    Slot* slot = batch.first;
+                    while (slot != nullptr) {
+                        Slot* next = slot->next;
+                        if (freeSlotCounts[findSlab(slot)] < SlabSize) {
+                            if (batches.empty() || batches.back().count == SlabSize) {
+                                batches.push_back(FreeList{});
+                            }
+                            slot->next = batches.back().first;
+                            batches.back().first = slot;
+                            ++batches.back().count;
+                        }
+                        slot = next;
+                    }
+                }
+                instance.batches = std::move(batches);
+
+                auto slabs = std::vector<std::unique_ptr<Slot[]>>{};
+                for (std::size_t i = 0u; i < instance.slabs.size(); ++i) {
+                    if (freeSlotCounts[i] < SlabSize) {
+                        slabs.push_back(std::move(instance.slabs[i]));
+                    }
+                }
+                instance.slabs = std::move(slabs);
+            }
+
+            /**
+             * Returns the number of slabs allocated by this pool.
+             */
+            static std::size_t slabCount() {
+                auto& instance = shared();
+                const auto lock = std::lock_guard<std::mutex>(instance.mutex);
+                return instance.slabs.size();
+            }
+        private:
+            static ThreadCache& threadCache() {
+                thread_local ThreadCache cache;
+                return cache;
+            }
+
+            static Shared& shared() {
+                // never destroyed because threads may return their slots while the program ends
+                static auto* instance = new Shared();
+                return *instance;
+            }
+
+            /**
+             * Removes the first SlabSize slots from the given free list and returns them.
+             */
+            static FreeList splitBatch(FreeList& freeList) {
+                assert(freeList.count > SlabSize);
+
+                auto result = FreeList{ freeList.first, SlabSize };
+                Slot* last = freeList.first;
+                for (std::size_t i = 1u; i < SlabSize; ++i) {
+                    last = last->next;
+                }
+
+                freeList.first = last->next;
+                freeList.count -= SlabSize;
+                last->next = nullptr;
+                return result;
+            }
+
+            static void putBatch(const FreeList& batch) {
+                auto& instance = shared();
+                const auto lock = std::lock_guard<std::mutex>(instance.mutex);
+                instance.batches.push_back(batch);
+            }
+
+            /**
+             * Returns a batch of free slots from the shared free list, or a new slab if the shared free list is empty.
+             */
+            static FreeList takeBatch() {
+                auto& instance = shared();
+                const auto lock = std::lock_guard<std::mutex>(instance.mutex);
+                if (!instance.batches.empty()) {
+                    const auto result = instance.batches.back();
+                    instance.batches.pop_back();
+                    return result;
+                }
+
+                auto slab = std::make_unique<Slot[]>(SlabSize);
+                for (std::size_t i = 0u; i < SlabSize - 1u; ++i) {
+                    slab[i].next = &slab[i + 1u];
+                }
+                slab[SlabSize - 1u].next = nullptr;
+
+                const auto result = FreeList{ slab.get(), SlabSize };
+                instance.slabs.push_back(std::move(slab));
+                return result;
+            }
+        };
+
+        /**
+         * Allocates memory for an object of type Item from its pool. If the requested size differs from the size of Item,
+         * which can only happen for classes derived from Item, the memory is allocated from the heap.
+         */
+        template <typename Item>
+        void* Polyhedron_allocate(const std::size_t size) {
+            if (size != sizeof(Item)) {
+                return ::operator new(size);
+            }
+            return Polyhedron_Pool<sizeof(Item), alignof(Item)>::allocate();
+        }
+
+        /**
+         * Frees memory that was allocated by a call to Polyhedron_allocate with the same size.
+         */
+        template <typename Item>
+        void Polyhedron_deallocate(void* ptr, const std::size_t size) {
+            if (size != sizeof(Item)) {
+                ::operator delete(ptr);
+            } else {
+                Polyhedron_Pool<sizeof(Item), alignof(Item)>::deallocate(ptr);
+            }
+        }
+
+        /**
+         * Returns the slabs of the pool of the given type whose slots are all free to the heap.
+         */
+        template <typename Item>
+        void Polyhedron_releaseFreeSlabs() {
+            Polyhedron_Pool<sizeof(Item), alignof(Item)>::releaseFreeSlabs();
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Polyhedron.h"
+#include "Polyhedron_Pool.h"
 
 #include <kdl/intrusive_circular_list.h>
 
@@ -35,6 +36,16 @@ namespace TrenchBroom {
             return vertex->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Vertex<T,FP,VP>::operator new(const std::size_t size) {
+            return Polyhedron_allocate<Polyhedron_Vertex<T,FP,VP>>(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Vertex<T,FP,VP>::operator delete(void* ptr, const std::size_t size) {
+            Polyhedron_deallocate<Polyhedron_Vertex<T,FP,VP>>(ptr, size);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Vertex<T,FP,VP>::Polyhedron_Vertex(const vm::vec<T,3>& position) :
             m_position(position),
@@ -29,6 +29,7 @@
 
 #include <kdl/memory_utils.h>
 
+#include <limits>
 #include <optional>
 #include <string>
 
@@ -70,6 +71,18 @@ namespace TrenchBroom {
             addQuickFix(new SoftMapBoundsIssueQuickFix());
         }
 
+        std::optional<vm::bbox3> SoftMapBoundsIssueGenerator::doGetValidBounds() const {
+            if (kdl::mem_expired(m_game)) {
+                return std::nullopt;
+            }
+
+            auto game = kdl::mem_lock(m_game);
+            const Game::SoftMapBounds bounds = game->extractSoftMapBounds(m_world->entity());
+
+            // without soft map bounds, every node is valid
+            return bounds.bounds.value_or(vm::bbox3(std::numeric_limits<FloatType>::max()));
+        }
+
         void SoftMapBoundsIssueGenerator::generateInternal(Node* node, IssueList& issues) const {
             auto game = kdl::mem_lock(m_game);
             const Game::SoftMapBounds bounds = game->extractSoftMapBounds(m_world->entity());
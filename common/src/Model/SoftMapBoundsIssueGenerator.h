@@ -25,6 +25,7 @@
 #include <vecmath/bbox.h>
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -43,6 +44,7 @@ namespace TrenchBroom {
         public:
             explicit SoftMapBoundsIssueGenerator(std::weak_ptr<Game> game, const WorldNode* world);
         private:
+            std::optional<vm::bbox3> doGetValidBounds() const override;
             void generateInternal(Node* node, IssueList& issues) const;
             void doGenerate(EntityNode* brush, IssueList& issues) const override;
             void doGenerate(BrushNode* brush, IssueList& issues) const override;
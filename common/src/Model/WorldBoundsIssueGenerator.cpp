@@ -65,6 +65,10 @@ namespace TrenchBroom {
             addQuickFix(new WorldBoundsIssueQuickFix());
         }
 
+        std::optional<vm::bbox3> WorldBoundsIssueGenerator::doGetValidBounds() const {
+            return m_bounds;
+        }
+
         void WorldBoundsIssueGenerator::doGenerate(EntityNode* entity, IssueList& issues) const {
             if (!m_bounds.contains(entity->logicalBounds()))
                 issues.push_back(new WorldBoundsIssue(entity));
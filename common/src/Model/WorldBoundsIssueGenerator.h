@@ -24,6 +24,7 @@
 
 #include <vecmath/bbox.h>
 
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -37,6 +38,7 @@ namespace TrenchBroom {
         public:
             explicit WorldBoundsIssueGenerator(const vm::bbox3& bounds);
         private:
+            std::optional<vm::bbox3> doGetValidBounds() const override;
             void doGenerate(EntityNode* brush, IssueList& issues) const override;
             void doGenerate(BrushNode* brush, IssueList& issues) const override;
         };
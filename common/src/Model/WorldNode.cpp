@@ -29,16 +29,24 @@
 #include "Model/IssueGenerator.h"
 #include "Model/IssueGeneratorRegistry.h"
 #include "Model/LayerNode.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox_io.h>
 
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -49,11 +57,13 @@ namespace TrenchBroom {
         m_entityNodeIndex(std::make_unique<EntityNodeIndex>()),
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_nodeTreeBatchDepth(0u) {
             entity.addOrUpdateProperty(PropertyKeys::Classname, PropertyValues::WorldspawnClassname);
             entity.setPointEntity(false);
             setEntity(std::move(entity));
             createDefaultLayer();
+            m_invalidIssueNodes.insert(this);
         }
 
         WorldNode::~WorldNode() = default;
@@ -139,6 +149,26 @@ namespace TrenchBroom {
             return *m_entityNodeIndex;
         }
 
+        void WorldNode::beginEntityNodeIndexBatch() {
+            m_entityNodeIndex->beginBatch();
+        }
+
+        void WorldNode::endEntityNodeIndexBatch() {
+            m_entityNodeIndex->endBatch();
+        }
+
+        WorldNode::EntityLinkChanges WorldNode::takeEntityLinkChanges() {
+            auto result = EntityLinkChanges{
+                std::vector<EntityNodeBase*>(std::begin(m_removedLinkNodes), std::end(m_removedLinkNodes)),
+                std::vector<EntityNodeBase*>(std::begin(m_changedLinkNodes), std::end(m_changedLinkNodes))
+            };
+
+            m_removedLinkNodes.clear();
+            m_changedLinkNodes.clear();
+            m_addedLinkNodes.clear();
+            return result;
+        }
+
         const std::vector<IssueGenerator*>& WorldNode::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry->registeredGenerators();
         }
@@ -157,6 +187,103 @@ namespace TrenchBroom {
             invalidateAllIssues();
         }
 
+        WorldNode::IssueChanges WorldNode::validateIssues() {
+            // querying the spatial index and spawning threads is only worth it if there are many nodes to validate
+            static const auto ManyNodesThreshold = size_t(512);
+
+            auto changes = IssueChanges{
+                std::vector<Node*>(std::begin(m_removedIssueNodes), std::end(m_removedIssueNodes)),
+                std::vector<Node*>(std::begin(m_invalidIssueNodes), std::end(m_invalidIssueNodes))
+            };
+
+            const auto& nodes = changes.validatedNodes;
+            if (nodes.size() < ManyNodesThreshold) {
+                const auto& issueGenerators = registeredIssueGenerators();
+                for (auto* node : nodes) {
+                    node->issues(issueGenerators);
+                }
+            } else {
+                validateIssuesOfManyNodes(nodes);
+            }
+
+            m_invalidIssueNodes.clear();
+            m_removedIssueNodes.clear();
+            m_addedIssueNodes.clear();
+            return changes;
+        }
+
+        void WorldNode::validateIssuesOfManyNodes(const std::vector<Node*>& nodes) {
+            // Generators which only check the bounds of nodes are applied to the nodes that the spatial index finds to
+            // be out of bounds, so their cost depends on the number of offending nodes. All other generators are
+            // applied to every node.
+            auto nodeIssueGenerators = std::vector<IssueGenerator*>{};
+            auto boundsIssueGenerators = std::vector<std::tuple<IssueGenerator*, std::unordered_set<const Node*>>>{};
+            for (auto* generator : registeredIssueGenerators()) {
+                const auto validBounds = m_updateNodeTree ? generator->validBounds() : std::nullopt;
+                if (validBounds) {
+                    const auto outOfBounds = findNodesNotContainedBy(*validBounds);
+                    boundsIssueGenerators.emplace_back(generator, std::unordered_set<const Node*>(std::begin(outOfBounds), std::end(outOfBounds)));
+                } else {
+                    nodeIssueGenerators.push_back(generator);
+                }
+            }
+
+            const auto validateNode = [&](Node* node) {
+                const auto isOutOfBounds = [&](const auto& boundsIssueGenerator) { return std::get<1>(boundsIssueGenerator).count(node) > 0u; };
+                if (std::none_of(std::begin(boundsIssueGenerators), std::end(boundsIssueGenerators), isOutOfBounds)) {
+                    node->issues(nodeIssueGenerators);
+                } else {
+                    auto issueGenerators = nodeIssueGenerators;
+                    for (const auto& boundsIssueGenerator : boundsIssueGenerators) {
+                        if (isOutOfBounds(boundsIssueGenerator)) {
+                            issueGenerators.push_back(std::get<0>(boundsIssueGenerator));
+                        }
+                    }
+                    node->issues(issueGenerators);
+                }
+            };
+
+            // The world is validated up front because its generators query the game, e.g. to check the mod
+            // directories.
+            if (m_invalidIssueNodes.count(this) > 0u) {
+                validateNode(this);
+            }
+
+            // Every node is validated by exactly one thread. The generators only read the nodes, but the link
+            // generators query the entity node index, which applies the updates of an active batch when it is queried.
+            // Applying them up front makes the queries read only.
+            m_entityNodeIndex->applyPendingUpdates();
+            assert(!m_entityNodeIndex->hasPendingUpdates());
+
+            // exceptions thrown by the lambda would be swallowed by parallel_for
+            auto exception = std::exception_ptr{};
+            auto exceptionMutex = std::mutex{};
+            kdl::parallel_for(nodes.size(), [&](const size_t i) {
+                try {
+                    validateNode(nodes[i]);
+                } catch (...) {
+                    const auto lock = std::lock_guard<std::mutex>{exceptionMutex};
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                }
+            });
+
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        std::vector<Node*> WorldNode::findNodesIntersecting(const vm::bbox3& bounds) const {
+            refitNodeTree();
+            return m_nodeTree->findIntersectors(bounds);
+        }
+
+        std::vector<Node*> WorldNode::findNodesNotContainedBy(const vm::bbox3& bounds) const {
+            refitNodeTree();
+            return m_nodeTree->findNotContainedBy(bounds);
+        }
+
         void WorldNode::disableNodeTreeUpdates() {
             m_updateNodeTree = false;
         }
@@ -181,9 +308,21 @@ namespace TrenchBroom {
                 [&](BrushNode* brush)                      { addNode(brush); }
             ));
 
+            m_nodesToRefit.clear();
             m_nodeTree->clearAndBuild(nodes, [](const auto* node){ return node->physicalBounds(); });
         }
 
+        void WorldNode::beginNodeTreeBatch() {
+            ++m_nodeTreeBatchDepth;
+        }
+
+        void WorldNode::endNodeTreeBatch() {
+            assert(m_nodeTreeBatchDepth > 0u);
+            if (--m_nodeTreeBatchDepth == 0u) {
+                refitNodeTree();
+            }
+        }
+
         void WorldNode::invalidateAllIssues() {
             accept([](auto&& thisLambda, Node* node) {
                 node->invalidateIssues();
@@ -266,6 +405,31 @@ namespace TrenchBroom {
                 ));
             }
 
+            node->accept([&](auto&& thisLambda, Node* descendant) {
+                m_invalidIssueNodes.insert(descendant);
+                // a node which was removed and added again, or another node at its address, is not removed anymore
+                if (m_removedIssueNodes.erase(descendant) == 0u) {
+                    m_addedIssueNodes.insert(descendant);
+                }
+                descendant->visitChildren(thisLambda);
+            });
+
+            node->accept(kdl::overload(
+                [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
+                [&](EntityNode* entity) {
+                    // a node which was removed and added again, or another node at its address, is reported as changed
+                    // so that its links are collected again
+                    if (m_removedLinkNodes.erase(entity) > 0u) {
+                        m_changedLinkNodes.insert(entity);
+                    } else {
+                        m_addedLinkNodes.insert(entity);
+                    }
+                },
+                [&](BrushNode*) {}
+            ));
+
             const auto updatePersistentId = [&](auto* persistentNode) {
                 if (const auto persistentNodeId = persistentNode->persistentId()) {
                     ensure(*persistentNodeId < std::numeric_limits<IdType>::max(), "Persistent ID available");
@@ -287,6 +451,7 @@ namespace TrenchBroom {
         void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */) {
             if (m_updateNodeTree) {
                 const auto doRemove = [&](auto* nodeToRemove) {
+                m_nodesToRefit.erase(nodeToRemove);
                 if (!m_nodeTree->remove(nodeToRemove)) {
                     auto str = std::stringstream();
                     str << "Node not found with bounds " << nodeToRemove->physicalBounds() << ": " << nodeToRemove;
@@ -304,15 +469,54 @@ namespace TrenchBroom {
             }
         }
 
+        void WorldNode::doDescendantWasRemoved(Node* /* oldParent */, Node* node, const size_t /* depth */) {
+            node->accept([&](auto&& thisLambda, Node* descendant) {
+                m_invalidIssueNodes.erase(descendant);
+                // the issues of nodes which were added since the last validation were never reported
+                if (m_addedIssueNodes.erase(descendant) == 0u) {
+                    m_removedIssueNodes.insert(descendant);
+                }
+                descendant->visitChildren(thisLambda);
+            });
+
+            // removing an entity node removes its links, so it must have been recorded as changed
+            node->accept(kdl::overload(
+                [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
+                [&](EntityNode* entity) {
+                    // the links of nodes which were added since the changes were last taken were never reported
+                    const auto changed = m_changedLinkNodes.erase(entity) > 0u;
+                    const auto added = m_addedLinkNodes.erase(entity) > 0u;
+                    if (changed && !added) {
+                        m_removedLinkNodes.insert(entity);
+                    }
+                },
+                [&](BrushNode*) {}
+            ));
+        }
+
         void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node) {
             if (m_updateNodeTree) {
                 node->accept(kdl::overload(
                     [] (WorldNode*) {},
                     [] (LayerNode*) {},
                     [] (GroupNode*) {},
-                    [&](EntityNode* entity) { m_nodeTree->update(entity->physicalBounds(), entity); },
-                    [&](BrushNode* brush)   { m_nodeTree->update(brush->physicalBounds(), brush); }
+                    [&](EntityNode* entity) { m_nodesToRefit.insert(entity); },
+                    [&](BrushNode* brush)   { m_nodesToRefit.insert(brush); }
                 ));
+
+                if (m_nodeTreeBatchDepth == 0u) {
+                    refitNodeTree();
+                }
+            }
+        }
+
+        void WorldNode::refitNodeTree() const {
+            if (!m_nodesToRefit.empty()) {
+                // refitting keeps the structure of the tree intact, the tree rebuilds itself if its quality degrades too much
+                m_nodeTree->refit(m_nodesToRefit, [](const auto* n){ return n->physicalBounds(); });
+                m_nodesToRefit.clear();
             }
         }
 
@@ -321,12 +525,21 @@ namespace TrenchBroom {
         }
 
         void WorldNode::doPick(const vm::ray3& ray, PickResult& pickResult) {
-            for (auto* node : m_nodeTree->findIntersectors(ray)) {
+            refitNodeTree();
+
+            // Nodes are visited front to back, and since every hit lies within the bounds of its node, we can stop as soon
+            // as the pick result is no longer interested in hits beyond the entry distance of the next node.
+            m_nodeTree->findIntersectorsByDistance(ray, [&](Node* node, const FloatType entryDistance) {
+                if (entryDistance > pickResult.maxDistance()) {
+                    return false;
+                }
                 node->pick(ray, pickResult);
-            }
+                return true;
+            });
         }
 
         void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
+            refitNodeTree();
             for (auto* node : m_nodeTree->findContainers(point)) {
                 node->findNodesContaining(point, result);
             }
@@ -336,6 +549,10 @@ namespace TrenchBroom {
             generator->generate(this, issues);
         }
 
+        void WorldNode::doIssuesWereInvalidated(Node* node) {
+            m_invalidIssueNodes.insert(node);
+        }
+
         void WorldNode::doAccept(NodeVisitor& visitor) {
             visitor.visit(this);
         }
@@ -362,6 +579,10 @@ namespace TrenchBroom {
             m_entityNodeIndex->removeProperty(node, key, value);
         }
 
+        void WorldNode::doEntityLinksDidChange(EntityNodeBase* node) {
+            m_changedLinkNodes.insert(node);
+        }
+
         void WorldNode::doPropertiesDidChange(const vm::bbox3& /* oldBounds */) {}
 
         vm::vec3 WorldNode::doGetLinkSourceAnchor() const {
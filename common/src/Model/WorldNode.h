@@ -30,6 +30,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -55,6 +56,34 @@ namespace TrenchBroom {
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
 
+            /**
+             * The nodes whose bounds changed during a node tree batch, see beginNodeTreeBatch. The node tree is refitted
+             * once for all of them when the batch ends or when the node tree is queried.
+             */
+            size_t m_nodeTreeBatchDepth;
+            mutable std::unordered_set<Node*> m_nodesToRefit;
+
+            /**
+             * The nodes in this world whose issues were invalidated and the nodes that were removed from this world
+             * since validateIssues was last called. Only nodes which were in this world when validateIssues was last
+             * called are recorded as removed, because the issues of other nodes were never reported. This keeps the
+             * removed nodes bounded if validateIssues is not called for a long time, and a node which is added again
+             * is no longer recorded as removed.
+             */
+            std::unordered_set<Node*> m_invalidIssueNodes;
+            std::unordered_set<Node*> m_removedIssueNodes;
+            std::unordered_set<Node*> m_addedIssueNodes;
+
+            /**
+             * The entity nodes in this world whose links were added or removed and the entity nodes that were removed
+             * from this world since takeEntityLinkChanges was last called. Like the removed issue nodes, only entity
+             * nodes which were in this world when takeEntityLinkChanges was last called are recorded as removed, so
+             * that the removed nodes remain bounded if nothing takes the changes for a long time.
+             */
+            std::unordered_set<EntityNodeBase*> m_changedLinkNodes;
+            std::unordered_set<EntityNodeBase*> m_removedLinkNodes;
+            std::unordered_set<EntityNodeBase*> m_addedLinkNodes;
+
             IdType m_nextPersistentId = 1;
         public:
             WorldNode(Entity entity, MapFormat mapFormat);
@@ -109,18 +138,89 @@ namespace TrenchBroom {
             void createDefaultLayer();
         public: // index
             const EntityNodeIndex& entityNodeIndex() const;
+
+            /**
+             * Collects the changes to the entity node index until the matching call to endEntityNodeIndexBatch and
+             * applies them in bulk then. Use this when the properties of many entities are added, removed or changed
+             * at once. Calls can be nested.
+             *
+             * @see EntityNodeIndex::beginBatch
+             */
+            void beginEntityNodeIndexBatch();
+            void endEntityNodeIndexBatch();
+        public: // entity links
+            struct EntityLinkChanges {
+                /**
+                 * The entity nodes whose links were removed because they were removed from this world. These nodes
+                 * may have been deleted already and must not be dereferenced.
+                 */
+                std::vector<EntityNodeBase*> removedNodes;
+                /**
+                 * The entity nodes in this world whose links were added or removed. The links are stored at the nodes
+                 * themselves, see EntityNodeBase::linkTargets and EntityNodeBase::killTargets.
+                 */
+                std::vector<EntityNodeBase*> changedNodes;
+            };
+
+            /**
+             * Returns the entity nodes whose links have changed since the last call and forgets them. Together with the
+             * links stored at the entity nodes, this allows keeping a copy of the link graph up to date without
+             * visiting every entity node.
+             */
+            EntityLinkChanges takeEntityLinkChanges();
         public: // selection
             // issue generator registration
             const std::vector<IssueGenerator*>& registeredIssueGenerators() const;
             std::vector<IssueQuickFix*> quickFixes(IssueType issueTypes) const;
             void registerIssueGenerator(IssueGenerator* issueGenerator);
             void unregisterAllIssueGenerators();
+        public: // issue validation
+            struct IssueChanges {
+                /**
+                 * The nodes that were removed from this world. These nodes may have been deleted already and must not
+                 * be dereferenced.
+                 */
+                std::vector<Node*> removedNodes;
+                /**
+                 * The nodes whose issues were generated again. Their previous issues were deleted.
+                 */
+                std::vector<Node*> validatedNodes;
+            };
+
+            /**
+             * Generates the issues of every node in this world whose issues were invalidated since the last call using
+             * the registered issue generators, and returns which nodes were validated or removed in the meantime. If
+             * many nodes must be validated, the issues are generated in parallel, and generators which check the bounds
+             * of nodes are only applied to the nodes which the spatial index finds to be out of bounds.
+             */
+            IssueChanges validateIssues();
+        public: // spatial queries
+            /**
+             * Returns every brush and entity whose physical bounds intersect the given bounds. Groups are not contained in
+             * the spatial index and are never returned.
+             */
+            std::vector<Node*> findNodesIntersecting(const vm::bbox3& bounds) const;
+
+            /**
+             * Returns every brush and entity whose physical bounds are not contained in the given bounds. Groups are not
+             * contained in the spatial index and are never returned.
+             */
+            std::vector<Node*> findNodesNotContainedBy(const vm::bbox3& bounds) const;
         public: // node tree bulk updating
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Collects the nodes whose bounds change until the matching call to endNodeTreeBatch and refits the node tree
+             * once for all of them then. Use this when many nodes are transformed at once. Calls can be nested.
+             */
+            void beginNodeTreeBatch();
+            void endNodeTreeBatch();
         private:
+            void validateIssuesOfManyNodes(const std::vector<Node*>& nodes);
             void invalidateAllIssues();
+            void refitNodeTree() const;
         private: // implement Node interface
             const vm::bbox3& doGetLogicalBounds() const override;
             const vm::bbox3& doGetPhysicalBounds() const override;
@@ -133,18 +233,21 @@ namespace TrenchBroom {
 
             void doDescendantWasAdded(Node* node, size_t depth) override;
             void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+            void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
             void doDescendantPhysicalBoundsDidChange(Node* node) override;
 
             bool doSelectable() const override;
             void doPick(const vm::ray3& ray, PickResult& pickResult) override;
             void doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) override;
             void doGenerateIssues(const IssueGenerator* generator, std::vector<Issue*>& issues) override;
+            void doIssuesWereInvalidated(Node* node) override;
             void doAccept(NodeVisitor& visitor) override;
             void doAccept(ConstNodeVisitor& visitor) const override;
             void doFindEntityNodesWithProperty(const std::string& name, const std::string& value, std::vector<EntityNodeBase*>& result) const override;
             void doFindEntityNodesWithNumberedProperty(const std::string& prefix, const std::string& value, std::vector<EntityNodeBase*>& result) const override;
             void doAddToIndex(EntityNodeBase* node, const std::string& key, const std::string& value) override;
             void doRemoveFromIndex(EntityNodeBase* node, const std::string& key, const std::string& value) override;
+            void doEntityLinksDidChange(EntityNodeBase* node) override;
         private: // implement EntityNodeBase interface
             void doPropertiesDidChange(const vm::bbox3& oldBounds) override;
             vm::vec3 doGetLinkSourceAnchor() const override;
@@ -131,6 +131,11 @@ namespace TrenchBroom {
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
 
+        Preference<float> EntityModelLodDistance(IO::Path("Renderer/Entity model LOD distance"), 4096.0f);
+        Preference<bool> LazyTextureLoading(IO::Path("Renderer/Lazy texture loading"), true);
+        Preference<bool> TextureArrays(IO::Path("Renderer/Texture arrays"), false);
+        Preference<bool> TextureCompression(IO::Path("Renderer/Texture compression"), false);
+
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
@@ -294,6 +299,10 @@ namespace TrenchBroom {
                 &GridColor2D,
                 &TextureMinFilter,
                 &TextureMagFilter,
+                &EntityModelLodDistance,
+                &LazyTextureLoading,
+                &TextureArrays,
+                &TextureCompression,
                 &TextureLock,
                 &UVLock,
                 &RendererFontPath(),
@@ -124,6 +124,30 @@ namespace TrenchBroom {
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
 
+        /**
+         * Entity models farther away from the 3D camera than this are rendered as their bounding boxes. A value of 0
+         * disables this.
+         */
+        extern Preference<float> EntityModelLodDistance;
+
+        /**
+         * If enabled, only the names and dimensions of textures are read when a map is loaded, and the texture data is
+         * read once a texture is used or shown in the texture browser.
+         */
+        extern Preference<bool> LazyTextureLoading;
+
+        /**
+         * If enabled and supported by the graphics driver, textures with the same dimensions are also copied into
+         * texture arrays so that brush faces can be rendered with fewer draw calls, at the cost of more texture memory.
+         */
+        extern Preference<bool> TextureArrays;
+
+        /**
+         * If enabled, image textures are compressed to reduce the texture memory they use, at the cost of some quality.
+         * The compressed textures are cached on disk so that they don't have to be decoded and compressed again.
+         */
+        extern Preference<bool> TextureCompression;
+
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
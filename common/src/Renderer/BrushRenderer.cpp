@@ -21,6 +21,7 @@
 
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "Assets/Texture.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
@@ -29,10 +30,17 @@
 #include "Model/TagAttribute.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/Camera.h"
 #include "Renderer/RenderContext.h"
 
+#include <kdl/parallel.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -133,7 +141,8 @@ namespace TrenchBroom {
         m_showOccludedEdges(false),
         m_forceTransparent(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_retainVboSnapshots(true) {
             clear();
         }
 
@@ -172,8 +181,8 @@ namespace TrenchBroom {
             m_invalidBrushes = m_allBrushes;
 
             assert(m_brushInfo.empty());
-            assert(m_transparentFaces->empty());
-            assert(m_opaqueFaces->empty());
+            assert(m_brushesByTexture.empty());
+            assert(m_chunks.empty());
         }
 
         void BrushRenderer::invalidateBrushes(const std::vector<Model::BrushNode*>& brushes) {
@@ -191,23 +200,35 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::invalidateBrushesWithTextures(const std::vector<const Assets::Texture*>& textures) {
+            // collect the brushes first because removing them from the VBO updates the index
+            auto brushes = std::vector<const Model::BrushNode*>{};
+            for (const auto* texture : textures) {
+                const auto it = m_brushesByTexture.find(texture);
+                if (it != std::end(m_brushesByTexture)) {
+                    brushes.insert(std::end(brushes), std::begin(it->second), std::end(it->second));
+                }
+            }
+
+            for (const auto* brush : brushes) {
+                // brushes in the VBO are valid, but a brush is found once for every matching texture
+                if (m_invalidBrushes.insert(brush).second) {
+                    removeBrushFromVbo(brush);
+                }
+            }
+        }
+
         bool BrushRenderer::valid() const {
             return m_invalidBrushes.empty();
         }
 
         void BrushRenderer::clear() {
             m_brushInfo.clear();
+            m_brushesByTexture.clear();
             m_allBrushes.clear();
             m_invalidBrushes.clear();
 
-            m_vertexArray = std::make_shared<BrushVertexArray>();
-            m_edgeIndices = std::make_shared<BrushIndexArray>();
-            m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-            m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_chunks.clear();
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
@@ -263,6 +284,20 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setRetainVboSnapshots(const bool retainVboSnapshots) {
+            m_retainVboSnapshots = retainVboSnapshots;
+            for (auto& [position, chunk] : m_chunks) {
+                chunk.vertexArray->setRetainSnapshot(m_retainVboSnapshots);
+                chunk.edgeIndices->setRetainSnapshot(m_retainVboSnapshots);
+                for (auto& [batchKey, indexArray] : *chunk.opaqueFaces) {
+                    indexArray->setRetainSnapshot(m_retainVboSnapshots);
+                }
+                for (auto& [batchKey, indexArray] : *chunk.transparentFaces) {
+                    indexArray->setRetainSnapshot(m_retainVboSnapshots);
+                }
+            }
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
@@ -273,11 +308,13 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
-                if (renderContext.showFaces()) {
-                    renderOpaqueFaces(renderBatch);
-                }
-                if (renderContext.showEdges() || m_showEdges) {
-                    renderEdges(renderBatch);
+                for (auto* chunk : visibleChunks(renderContext)) {
+                    if (renderContext.showFaces()) {
+                        renderOpaqueFaces(*chunk, renderBatch);
+                    }
+                    if (renderContext.showEdges() || m_showEdges) {
+                        renderEdges(*chunk, renderBatch);
+                    }
                 }
             }
         }
@@ -288,31 +325,45 @@ namespace TrenchBroom {
                     validate();
                 }
                 if (renderContext.showFaces()) {
-                    renderTransparentFaces(renderBatch);
+                    for (auto* chunk : visibleChunks(renderContext)) {
+                        renderTransparentFaces(*chunk, renderBatch);
+                    }
                 }
             }
         }
 
-        void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
-            m_opaqueFaceRenderer.setGrayscale(m_grayscale);
-            m_opaqueFaceRenderer.setTint(m_tint);
-            m_opaqueFaceRenderer.setTintColor(m_tintColor);
-            m_opaqueFaceRenderer.render(renderBatch);
+        void BrushRenderer::renderOpaqueFaces(Chunk& chunk, RenderBatch& renderBatch) {
+            chunk.opaqueFaceRenderer.setGrayscale(m_grayscale);
+            chunk.opaqueFaceRenderer.setTint(m_tint);
+            chunk.opaqueFaceRenderer.setTintColor(m_tintColor);
+            chunk.opaqueFaceRenderer.render(renderBatch);
         }
 
-        void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
-            m_transparentFaceRenderer.setGrayscale(m_grayscale);
-            m_transparentFaceRenderer.setTint(m_tint);
-            m_transparentFaceRenderer.setTintColor(m_tintColor);
-            m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
-            m_transparentFaceRenderer.render(renderBatch);
+        void BrushRenderer::renderTransparentFaces(Chunk& chunk, RenderBatch& renderBatch) {
+            chunk.transparentFaceRenderer.setGrayscale(m_grayscale);
+            chunk.transparentFaceRenderer.setTint(m_tint);
+            chunk.transparentFaceRenderer.setTintColor(m_tintColor);
+            chunk.transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+            chunk.transparentFaceRenderer.render(renderBatch);
         }
 
-        void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+        void BrushRenderer::renderEdges(Chunk& chunk, RenderBatch& renderBatch) {
             if (m_showOccludedEdges) {
-                m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+                chunk.edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+            }
+            chunk.edgeRenderer.render(renderBatch, m_edgeColor);
+        }
+
+        std::vector<BrushRenderer::Chunk*> BrushRenderer::visibleChunks(const RenderContext& renderContext) {
+            const Camera& camera = renderContext.camera();
+
+            auto result = std::vector<Chunk*>{};
+            for (auto& [position, chunk] : m_chunks) {
+                if (camera.intersectsFrustum(chunk.bounds)) {
+                    result.push_back(&chunk);
+                }
             }
-            m_edgeRenderer.render(renderBatch, m_edgeColor);
+            return result;
         }
 
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
@@ -338,18 +389,101 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * The indices of the marked faces of a brush that have the same texture and are rendered in the same pass.
+         * Faces whose textures share a texture array have the same batch key, but they are still staged separately.
+         */
+        struct BrushRenderer::StagedFaceIndices {
+            FaceBatchKey batchKey;
+            bool transparent;
+            size_t indicesBegin;
+            size_t indicesEnd;
+        };
+
+        /**
+         * The ranges of a brush's edge indices and face indices in a staging buffer. The indices are relative to the
+         * first vertex of the brush because the brush's vertices have not been allocated in the vertex array yet.
+         */
+        struct BrushRenderer::StagedBrush {
+            const Model::BrushNode* brush;
+            size_t edgeIndicesBegin;
+            size_t edgeIndicesEnd;
+            size_t faceIndicesBegin;
+            size_t faceIndicesEnd;
+        };
+
+        /**
+         * Holds the staged indices of a range of brushes. Every worker thread fills its own staging buffer.
+         */
+        struct BrushRenderer::StagingBuffer {
+            std::vector<StagedBrush> brushes;
+            std::vector<StagedFaceIndices> faceIndices;
+            std::vector<GLuint> indices;
+        };
+
+        /**
+         * Validation is done in three steps:
+         *
+         * 1. The filter is evaluated for every invalid brush. Filters access the editor context and the preferences,
+         *    so this is done on the calling thread.
+         * 2. The brushes are split into ranges, and for every range, the vertex caches of the brushes are validated and
+         *    their indices are computed into a staging buffer on a worker thread.
+         * 3. The staged brushes are allocated in and copied into the VBO holders on the calling thread.
+         */
         void BrushRenderer::validate() {
             assert(!valid());
 
+            static constexpr auto BrushesPerStagingBuffer = size_t(512);
+
+            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+
+            auto brushesToStage = std::vector<std::tuple<const Model::BrushNode*, Filter::EdgeRenderPolicy>>{};
+            brushesToStage.reserve(m_invalidBrushes.size());
             for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
+                assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
+                assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
+
+                // evaluate filter. only evaluate the filter once per brush.
+                const auto [facePolicy, edgePolicy] = wrapper.markFaces(brush);
+                if (facePolicy != Filter::FaceRenderPolicy::RenderNone ||
+                    edgePolicy != Filter::EdgeRenderPolicy::RenderNone) {
+                    brushesToStage.emplace_back(brush, edgePolicy);
+                }
+                // NOTE: brushes that are not rendered are not inserted into m_brushInfo
             }
             m_invalidBrushes.clear();
             assert(valid());
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            const auto bufferCount = (brushesToStage.size() + BrushesPerStagingBuffer - 1u) / BrushesPerStagingBuffer;
+            auto buffers = std::vector<StagingBuffer>(bufferCount);
+
+            const auto stageBuffer = [&](const size_t bufferIndex) {
+                const auto first = bufferIndex * BrushesPerStagingBuffer;
+                const auto last = std::min(first + BrushesPerStagingBuffer, brushesToStage.size());
+                for (size_t i = first; i < last; ++i) {
+                    const auto& [brush, edgePolicy] = brushesToStage[i];
+                    stageBrush(brush, edgePolicy, buffers[bufferIndex]);
+                }
+            };
+
+            // spawning threads is not worth it for a small number of brushes
+            if (bufferCount > 1u) {
+                kdl::parallel_for(bufferCount, stageBuffer);
+            } else if (bufferCount == 1u) {
+                stageBuffer(0u);
+            }
+
+            for (const auto& buffer : buffers) {
+                for (const auto& stagedBrush : buffer.brushes) {
+                    commitBrush(stagedBrush, buffer);
+                }
+            }
+
+            for (auto& [position, chunk] : m_chunks) {
+                chunk.opaqueFaceRenderer = FaceRenderer(chunk.vertexArray, chunk.opaqueFaces, m_faceColor);
+                chunk.transparentFaceRenderer = FaceRenderer(chunk.vertexArray, chunk.transparentFaces, m_faceColor);
+                chunk.edgeRenderer = IndexedEdgeRenderer(chunk.vertexArray, chunk.edgeIndices);
+            }
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -384,38 +518,30 @@ namespace TrenchBroom {
             }
         }
 
-        static size_t countMarkedEdgeIndices(const Model::BrushNode* brush, const BrushRenderer::Filter::EdgeRenderPolicy policy) {
+        static void addMarkedEdgeIndices(const Model::BrushNode* brush,
+                                         const BrushRenderer::Filter::EdgeRenderPolicy policy,
+                                         std::vector<GLuint>& dest) {
             using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
 
             if (policy == EdgeRenderPolicy::RenderNone) {
-                return 0;
+                return;
             }
 
-            size_t indexCount = 0;
             for (const auto& edge : brush->brushRendererBrushCache().cachedEdges()) {
                 if (shouldRenderEdge(edge, policy)) {
-                    indexCount += 2;
+                    dest.push_back(static_cast<GLuint>(edge.vertexIndex1RelativeToBrush));
+                    dest.push_back(static_cast<GLuint>(edge.vertexIndex2RelativeToBrush));
                 }
             }
-            return indexCount;
         }
 
-        static void getMarkedEdgeIndices(const Model::BrushNode* brush,
-                                         const BrushRenderer::Filter::EdgeRenderPolicy policy,
-                                         const GLuint brushVerticesStartIndex,
-                                         GLuint* dest) {
-            using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
-
-            if (policy == EdgeRenderPolicy::RenderNone) {
-                return;
-            }
-
-            size_t i = 0;
-            for (const auto& edge : brush->brushRendererBrushCache().cachedEdges()) {
-                if (shouldRenderEdge(edge, policy)) {
-                    dest[i++] = static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex1RelativeToBrush);
-                    dest[i++] = static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex2RelativeToBrush);
-                }
+        static void copyIndices(const std::vector<GLuint>& indices,
+                                const size_t first,
+                                const size_t last,
+                                const GLuint brushVerticesStartIndex,
+                                GLuint* dest) {
+            for (size_t i = first; i < last; ++i) {
+                *(dest++) = brushVerticesStartIndex + indices[i];
             }
         }
 
@@ -438,45 +564,105 @@ namespace TrenchBroom {
             return false;
         }
 
-        void BrushRenderer::validateBrush(const Model::BrushNode* brush) {
-            assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
-            assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
-            assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
+        /**
+         * Validates the vertex cache of the given brush and adds its edge indices and the indices of its marked faces to
+         * the given staging buffer. This only modifies the given brush and staging buffer, so it can be called on
+         * worker threads.
+         */
+        void BrushRenderer::stageBrush(const Model::BrushNode* brush, const Filter::EdgeRenderPolicy edgePolicy, StagingBuffer& buffer) const {
+            auto& brushCache = brush->brushRendererBrushCache();
+            brushCache.validateVertexCache(brush);
+            ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
 
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+            auto& indices = buffer.indices;
 
-            // evaluate filter. only evaluate the filter once per brush.
-            const auto settings = wrapper.markFaces(brush);
-            const auto [facePolicy, edgePolicy] = settings;
+            // stage edge indices
+            const auto edgeIndicesBegin = indices.size();
+            addMarkedEdgeIndices(brush, edgePolicy, indices);
+            const auto edgeIndicesEnd = indices.size();
 
-            if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
-                edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
-                return;
+            // stage face indices
+            const auto faceIndicesBegin = buffer.faceIndices.size();
+
+            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const size_t facesSortedByTexSize = facesSortedByTex.size();
+
+            size_t nextI;
+            for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
+                const Assets::Texture* texture = facesSortedByTex[i].texture;
+
+                // find the i value for the next texture
+                for (nextI = i + 1; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {}
+
+                // process all faces with this texture (they'll be consecutive), once for each pass
+                for (const bool transparent : { true, false }) {
+                    const auto indicesBegin = indices.size();
+                    for (size_t j = i; j < nextI; ++j) {
+                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, *cache.face) == transparent) {
+                            assert(cache.texture == texture);
+
+                            const auto offset = indices.size();
+                            indices.resize(offset + triIndicesCountForPolygon(cache.vertexCount));
+                            addTriIndicesForPolygon(indices.data() + offset,
+                                                    static_cast<GLuint>(cache.indexOfFirstVertexRelativeToBrush),
+                                                    cache.vertexCount);
+                        }
+                    }
+
+                    if (indices.size() > indicesBegin) {
+                        buffer.faceIndices.push_back(StagedFaceIndices{FaceBatchKey::forTexture(texture), transparent, indicesBegin, indices.size()});
+                    }
+                }
             }
 
+            buffer.brushes.push_back(StagedBrush{brush, edgeIndicesBegin, edgeIndicesEnd, faceIndicesBegin, buffer.faceIndices.size()});
+        }
+
+        /**
+         * Allocates the vertices and indices of the given staged brush in the VBO holders and copies them there.
+         */
+        void BrushRenderer::commitBrush(const StagedBrush& stagedBrush, const StagingBuffer& buffer) {
+            const auto* brush = stagedBrush.brush;
+            assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
+
             BrushInfo& info = m_brushInfo[brush];
 
-            // collect vertices
-            auto& brushCache = brush->brushRendererBrushCache();
-            brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+            Chunk& chunk = findOrCreateChunk(brush);
+            info.chunk = &chunk;
 
-            assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+            // insert vertices into VBO
+            const auto& cachedVertices = brush->brushRendererBrushCache().cachedVertices();
+
+            auto [vertBlock, dest] = chunk.vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
             std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
             info.vertexHolderKey = vertBlock;
 
+            // the third texture coordinate of the vertices of faces whose textures are in a texture array is the layer
+            for (const auto& cachedFace : brush->brushRendererBrushCache().cachedFacesSortedByTexture()) {
+                // the faces are sorted by texture, so every texture is only added once
+                if (cachedFace.texture != nullptr && (info.textures.empty() || info.textures.back() != cachedFace.texture)) {
+                    info.textures.push_back(cachedFace.texture);
+                    m_brushesByTexture[cachedFace.texture].insert(brush);
+                }
+                if (cachedFace.texture != nullptr && cachedFace.texture->textureArray() != nullptr) {
+                    const auto layer = static_cast<float>(cachedFace.texture->textureArrayLayer());
+                    for (size_t i = 0; i < cachedFace.vertexCount; ++i) {
+                        auto& texCoords = dest[cachedFace.indexOfFirstVertexRelativeToBrush + i].rest.rest.attr;
+                        texCoords[2] = layer;
+                    }
+                }
+            }
+
             const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
 
             // insert edge indices into VBO
             {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
+                const size_t edgeIndexCount = stagedBrush.edgeIndicesEnd - stagedBrush.edgeIndicesBegin;
                 if (edgeIndexCount > 0) {
-                    auto [key, insertDest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
+                    auto [key, insertDest] = chunk.edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
                     info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, insertDest);
+                    copyIndices(buffer.indices, stagedBrush.edgeIndicesBegin, stagedBrush.edgeIndicesEnd, brushVerticesStartIndex, insertDest);
                 } else {
                     // it's possible to have no edges to render
                     // e.g. select all faces of a brush, and the unselected brush renderer
@@ -485,88 +671,71 @@ namespace TrenchBroom {
                 }
             }
 
-            // insert face indices
-
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
-            const size_t facesSortedByTexSize = facesSortedByTex.size();
+            // insert face indices into VBO
+            for (size_t i = stagedBrush.faceIndicesBegin; i < stagedBrush.faceIndicesEnd; ++i) {
+                const StagedFaceIndices& faceIndices = buffer.faceIndices[i];
+                const FaceBatchKey& batchKey = faceIndices.batchKey;
 
-            size_t nextI;
-            for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
-                const Assets::Texture* texture = facesSortedByTex[i].texture;
-
-                size_t opaqueIndexCount = 0;
-                size_t transparentIndexCount = 0;
-
-                // find the i value for the next texture
-                for (nextI = i + 1; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {}
-
-                // process all faces with this texture (they'll be consecutive)
-                for (size_t j = i; j < nextI; ++j) {
-                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                    if (cache.face->isMarked()) {
-                        assert(cache.texture == texture);
-                        if (shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-                        } else {
-                            opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
+                TextureToBrushIndicesMap& faceVboMap = faceIndices.transparent ? *chunk.transparentFaces : *chunk.opaqueFaces;
+                auto& holderPtr = faceVboMap[batchKey];
+                if (holderPtr == nullptr) {
+                    // inserts into map!
+                    holderPtr = std::make_shared<BrushIndexArray>();
+                    holderPtr->setRetainSnapshot(m_retainVboSnapshots);
                 }
 
-                if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
-                    }
+                auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(faceIndices.indicesEnd - faceIndices.indicesBegin);
+                if (faceIndices.transparent) {
+                    info.transparentFaceIndicesKeys.push_back({batchKey, key});
+                } else {
+                    info.opaqueFaceIndicesKeys.push_back({batchKey, key});
+                }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
+                copyIndices(buffer.indices, faceIndices.indicesBegin, faceIndices.indicesEnd, brushVerticesStartIndex, insertDest);
+            }
+        }
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+        /**
+         * Returns the first chunk with room for another brush in the grid cell that contains the center of the given
+         * brush, and adds the brush's bounds to the chunk's bounds.
+         */
+        BrushRenderer::Chunk& BrushRenderer::findOrCreateChunk(const Model::BrushNode* brush) {
+            static constexpr auto ChunkSize = FloatType(2048);
+            static constexpr auto MaxChunkBrushCount = size_t(1024);
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (insertDest + transparentIndexCount));
-                }
+            const auto& bounds = brush->physicalBounds();
+            const auto center = bounds.center();
+            const auto position = vm::vec3(
+                std::floor(center.x() / ChunkSize),
+                std::floor(center.y() / ChunkSize),
+                std::floor(center.z() / ChunkSize));
 
-                if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
-                    }
+            // skip the full chunks of the cell, the chunks are ordered by their index within the cell
+            auto it = m_chunks.lower_bound({position, 0u});
+            auto index = size_t(0);
+            while (it != std::end(m_chunks) && it->first.first == position && it->second.brushCount >= MaxChunkBrushCount) {
+                index = it->first.second + 1u;
+                ++it;
+            }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+            if (it == std::end(m_chunks) || it->first.first != position) {
+                it = m_chunks.emplace_hint(it, std::piecewise_construct, std::forward_as_tuple(position, index), std::forward_as_tuple());
+                it->second.key = it->first;
+                it->second.brushCount = 0u;
+                it->second.vertexArray = std::make_shared<BrushVertexArray>();
+                it->second.edgeIndices = std::make_shared<BrushIndexArray>();
+                it->second.vertexArray->setRetainSnapshot(m_retainVboSnapshots);
+                it->second.edgeIndices->setRetainSnapshot(m_retainVboSnapshots);
+                it->second.transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
+                it->second.opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+            }
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+            Chunk& chunk = it->second;
+            // the bounds are never shrunk while the chunk has brushes, so they might be larger than necessary
+            chunk.bounds = chunk.brushCount == 0u ? vm::bbox3f(bounds) : vm::merge(chunk.bounds, vm::bbox3f(bounds));
+            ++chunk.brushCount;
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (insertDest + opaqueIndexCount));
-                }
-            }
+            return chunk;
         }
 
         void BrushRenderer::addBrush(const Model::BrushNode* brush) {
@@ -595,39 +764,58 @@ namespace TrenchBroom {
             auto it = m_brushInfo.find(brush);
 
             if (it == std::end(m_brushInfo)) {
-                // This means BrushRenderer::validateBrush skipped rendering the brush, so it was never
+                // This means BrushRenderer::validate skipped rendering the brush, so it was never
                 // uploaded to the VBO's
                 return;
             }
 
             const BrushInfo& info = it->second;
+            Chunk& chunk = *info.chunk;
 
             // update Vbo's
-            m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+            chunk.vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
-                m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+                chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
             }
 
-            for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
+            for (const auto& [batchKey, opaqueKey] : info.opaqueFaceIndicesKeys) {
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.opaqueFaces->at(batchKey);
                 faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_opaqueFaces->erase(texture);
+                    chunk.opaqueFaces->erase(batchKey);
                 }
             }
-            for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
+            for (const auto& [batchKey, transparentKey] : info.transparentFaceIndicesKeys) {
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.transparentFaces->at(batchKey);
                 faceIndexHolder->zeroElementsWithKey(transparentKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_transparentFaces->erase(texture);
+                    chunk.transparentFaces->erase(batchKey);
+                }
+            }
+
+            for (const auto* texture : info.textures) {
+                auto textureIt = m_brushesByTexture.find(texture);
+                assert(textureIt != std::end(m_brushesByTexture));
+                textureIt->second.erase(brush);
+                if (textureIt->second.empty()) {
+                    m_brushesByTexture.erase(textureIt);
                 }
             }
 
+            assert(chunk.brushCount > 0u);
+            --chunk.brushCount;
+
             m_brushInfo.erase(it);
+
+            if (chunk.brushCount == 0u) {
+                // the chunk is empty, so release its arrays
+                assert(chunk.opaqueFaces->empty() && chunk.transparentFaces->empty());
+                m_chunks.erase(chunk.key);
+            }
         }
     }
 }
@@ -20,15 +20,21 @@
 #pragma once
 
 #include "Color.h"
+#include "FloatType.h"
 #include "Model/BrushGeometry.h"
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <map>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -117,11 +123,48 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<Filter> m_filter;
 
+            using TextureToBrushIndicesMap = std::unordered_map<FaceBatchKey, std::shared_ptr<BrushIndexArray>, FaceBatchKeyHash>;
+
+            /**
+             * The brushes are grouped into chunks by their location so that the chunks which are not in the view
+             * frustum can be skipped when rendering. Every chunk has its own vertex array, index arrays and renderers,
+             * so adding or removing a brush only marks a part of its chunk's VBO blocks as dirty, and only that part
+             * is uploaded again when the chunk is rendered next.
+             *
+             * A chunk is removed together with its arrays when its last brush is removed. Brushes are only removed
+             * in response to document changes and never while rendering, so the render batch, which only lives
+             * during a frame, cannot refer to the renderers of a removed chunk.
+             */
+            struct Chunk {
+                std::pair<vm::vec3, size_t> key;
+                vm::bbox3f bounds;
+                size_t brushCount;
+
+                std::shared_ptr<BrushVertexArray> vertexArray;
+                std::shared_ptr<BrushIndexArray> edgeIndices;
+                std::shared_ptr<TextureToBrushIndicesMap> transparentFaces;
+                std::shared_ptr<TextureToBrushIndicesMap> opaqueFaces;
+
+                FaceRenderer opaqueFaceRenderer;
+                FaceRenderer transparentFaceRenderer;
+                IndexedEdgeRenderer edgeRenderer;
+            };
+
+            /**
+             * The chunks by the position of their cells in a grid of ChunkSize units and their index within the cell.
+             * A cell is split into several chunks if it contains more than MaxChunkBrushCount brushes so that the VBO
+             * blocks of a chunk stay small.
+             */
+            std::map<std::pair<vm::vec3, size_t>, Chunk> m_chunks;
+
             struct BrushInfo {
+                Chunk* chunk;
                 AllocationTracker::Block* vertexHolderKey;
                 AllocationTracker::Block* edgeIndicesKey;
-                std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
-                std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> transparentFaceIndicesKeys;
+                std::vector<std::pair<FaceBatchKey, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
+                std::vector<std::pair<FaceBatchKey, AllocationTracker::Block*>> transparentFaceIndicesKeys;
+                // the textures of the brush's faces when it was added to the VBO, see m_brushesByTexture
+                std::vector<const Assets::Texture*> textures;
             };
             /**
              * Tracks all brushes that are stored in the VBO, with the information necessary to remove them
@@ -129,6 +172,12 @@ namespace TrenchBroom {
              */
             std::unordered_map<const Model::BrushNode*, BrushInfo> m_brushInfo;
 
+            /**
+             * The brushes in the VBO by the textures of their faces. Used to find the brushes which must be uploaded
+             * again when the texture array layers of some textures change.
+             */
+            std::unordered_map<const Assets::Texture*, std::unordered_set<const Model::BrushNode*>> m_brushesByTexture;
+
             /**
              * If a brush is in the VBO, it's always valid.
              * If a brush is valid, it might not be in the VBO if it was hidden by the Filter.
@@ -138,17 +187,6 @@ namespace TrenchBroom {
             std::unordered_set<const Model::BrushNode*> m_allBrushes;
             std::unordered_set<const Model::BrushNode*> m_invalidBrushes;
 
-            std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<BrushIndexArray> m_edgeIndices;
-
-            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-            std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-            std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
-
-            FaceRenderer m_opaqueFaceRenderer;
-            FaceRenderer m_transparentFaceRenderer;
-            IndexedEdgeRenderer m_edgeRenderer;
-
             Color m_faceColor;
             bool m_showEdges;
             Color m_edgeColor;
@@ -161,6 +199,7 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
 
             bool m_showHiddenBrushes;
+            bool m_retainVboSnapshots;
         public:
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
@@ -171,7 +210,8 @@ namespace TrenchBroom {
             m_showOccludedEdges(false),
             m_forceTransparent(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_retainVboSnapshots(true) {
                 clear();
             }
 
@@ -194,11 +234,18 @@ namespace TrenchBroom {
              *
              * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the Brush object for modification.
              *
-             * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces, and m_opaqueFaces
-             * maps will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
+             * Additionally, calling `invalidate()` guarantees the m_brushInfo map and the transparentFaces and opaqueFaces
+             * maps of all chunks will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
              */
             void invalidate();
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Invalidates the brushes in the VBO which have faces with one of the given textures. This is necessary when
+             * the textures were added to or removed from a texture array, because the texture array layers of the faces
+             * are only read when the brushes are staged.
+             */
+            void invalidateBrushesWithTextures(const std::vector<const Assets::Texture*>& textures);
             bool valid() const;
 
             /**
@@ -265,14 +312,26 @@ namespace TrenchBroom {
              * Specifies whether or not brushes which are currently hidden should be rendered regardless.
              */
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Specifies whether or not the local copies of the vertices and indices are kept after they have been
+             * uploaded to the VBOs. Dropping them roughly halves the memory used by this renderer, but makes changes
+             * more expensive, so this should only be disabled for renderers whose brushes rarely change.
+             */
+            void setRetainVboSnapshots(bool retainVboSnapshots);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
-            void renderOpaqueFaces(RenderBatch& renderBatch);
-            void renderTransparentFaces(RenderBatch& renderBatch);
-            void renderEdges(RenderBatch& renderBatch);
+            void renderOpaqueFaces(Chunk& chunk, RenderBatch& renderBatch);
+            void renderTransparentFaces(Chunk& chunk, RenderBatch& renderBatch);
+            void renderEdges(Chunk& chunk, RenderBatch& renderBatch);
+
+            /**
+             * Returns the chunks that intersect the view frustum of the given render context's camera.
+             */
+            std::vector<Chunk*> visibleChunks(const RenderContext& renderContext);
 
         public:
             /**
@@ -280,8 +339,14 @@ namespace TrenchBroom {
              */
             void validate();
         private:
+            struct StagedFaceIndices;
+            struct StagedBrush;
+            struct StagingBuffer;
+
             bool shouldDrawFaceInTransparentPass(const Model::BrushNode* brush, const Model::BrushFace& face) const;
-            void validateBrush(const Model::BrushNode* brush);
+            void stageBrush(const Model::BrushNode* brush, Filter::EdgeRenderPolicy edgePolicy, StagingBuffer& buffer) const;
+            void commitBrush(const StagedBrush& stagedBrush, const StagingBuffer& buffer);
+            Chunk& findOrCreateChunk(const Model::BrushNode* brush);
             void addBrush(const Model::BrushNode* brush);
             void removeBrush(const Model::BrushNode* brush);
 
@@ -22,6 +22,7 @@
 #include <cassert>
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <stdexcept>
 
 namespace TrenchBroom {
@@ -31,11 +32,16 @@ namespace TrenchBroom {
 
         // DirtyRangeTracker
 
-        DirtyRangeTracker::DirtyRangeTracker(const size_t initial_capacity)
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(initial_capacity) {}
+        bool DirtyRangeTracker::Range::operator==(const Range& other) const {
+            return pos == other.pos
+                   && size == other.size;
+        }
+
+        DirtyRangeTracker::DirtyRangeTracker(const size_t initial_capacity, const size_t mergeDistance)
+                : m_capacity(initial_capacity), m_mergeDistance(mergeDistance) {}
 
         DirtyRangeTracker::DirtyRangeTracker()
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(0) {}
+                : m_capacity(0), m_mergeDistance(DefaultMergeDistance) {}
 
         void DirtyRangeTracker::expand(const size_t newcap) {
             if (newcap <= m_capacity) {
@@ -51,21 +57,65 @@ namespace TrenchBroom {
             return m_capacity;
         }
 
+        void DirtyRangeTracker::setMergeDistance(const size_t mergeDistance) {
+            m_mergeDistance = mergeDistance;
+        }
+
+        size_t DirtyRangeTracker::mergeDistance() const {
+            return m_mergeDistance;
+        }
+
         void DirtyRangeTracker::markDirty(const size_t pos, const size_t size) {
             // bounds check
             if (pos + size > m_capacity) {
                 throw std::invalid_argument("markDirty provided range out of bounds");
             }
+            if (size == 0) {
+                return;
+            }
+
+            // the ranges are disjoint and sorted, so their ends are sorted too; find the first range that ends close
+            // enough to the new range to be merged with it
+            auto first = std::lower_bound(std::begin(m_ranges), std::end(m_ranges), pos, [&](const Range& range, const size_t p) {
+                return range.pos + range.size + m_mergeDistance < p;
+            });
 
-            const size_t newPos = std::min(pos, m_dirtyPos);
-            const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
+            size_t newPos = pos;
+            size_t newEnd = pos + size;
 
-            m_dirtyPos = newPos;
-            m_dirtySize = newEnd - newPos;
+            auto last = first;
+            while (last != std::end(m_ranges) && last->pos <= newEnd + m_mergeDistance) {
+                newPos = std::min(newPos, last->pos);
+                newEnd = std::max(newEnd, last->pos + last->size);
+                ++last;
+            }
+
+            if (first == last) {
+                m_ranges.insert(first, Range{newPos, newEnd - newPos});
+            } else {
+                *first = Range{newPos, newEnd - newPos};
+                m_ranges.erase(std::next(first), last);
+            }
         }
 
         bool DirtyRangeTracker::clean() const {
-            return m_dirtySize == 0;
+            return m_ranges.empty();
+        }
+
+        void DirtyRangeTracker::clear() {
+            m_ranges.clear();
+        }
+
+        const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::ranges() const {
+            return m_ranges;
+        }
+
+        size_t DirtyRangeTracker::dirtySize() const {
+            size_t result = 0;
+            for (const auto& range : m_ranges) {
+                result += range.size;
+            }
+            return result;
         }
 
         // IndexHolder
@@ -85,6 +135,7 @@ namespace TrenchBroom {
             const GLvoid *renderOffset = reinterpret_cast<GLvoid *>(m_vbo->offset() + sizeof(Index) * offset);
 
             glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
+            glCountDrawCall();
         }
 
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
@@ -131,6 +182,10 @@ namespace TrenchBroom {
             m_indexHolder.zeroRange(pos, size);
         }
 
+        void BrushIndexArray::setRetainSnapshot(const bool retainSnapshot) {
+            m_indexHolder.setRetainSnapshot(retainSnapshot);
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
             m_indexHolder.render(primType, 0, m_indexHolder.size());
@@ -188,6 +243,10 @@ namespace TrenchBroom {
             // us to re-use the space later
         }
 
+        void BrushVertexArray::setRetainSnapshot(const bool retainSnapshot) {
+            m_vertexHolder.setRetainSnapshot(retainSnapshot);
+        }
+
         bool BrushVertexArray::setupVertices() {
             return m_vertexHolder.setupVertices();
         }
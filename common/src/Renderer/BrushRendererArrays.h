@@ -37,15 +37,32 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        struct DirtyRangeTracker {
-            size_t m_dirtyPos;
-            size_t m_dirtySize;
-            size_t m_capacity;
+        /**
+         * Tracks the modified ranges of a VBO holder as a sorted set of disjoint ranges.
+         *
+         * Every range uploaded to a VBO costs a call into the driver, so ranges which are closer to each other than the
+         * merge distance are coalesced into one range. Uploading a few unmodified elements between two modified ranges is
+         * cheaper than uploading the ranges separately.
+         */
+        class DirtyRangeTracker {
+        public:
+            static constexpr size_t DefaultMergeDistance = 64u;
 
+            struct Range {
+                size_t pos;
+                size_t size;
+
+                bool operator==(const Range& other) const;
+            };
+        private:
+            std::vector<Range> m_ranges;
+            size_t m_capacity;
+            size_t m_mergeDistance;
+        public:
             /**
              * New trackers are initially clean.
              */
-            explicit DirtyRangeTracker(size_t initial_capacity);
+            explicit DirtyRangeTracker(size_t initial_capacity, size_t mergeDistance = DefaultMergeDistance);
             DirtyRangeTracker();
 
             /**
@@ -53,8 +70,31 @@ namespace TrenchBroom {
              */
             void expand(size_t newcap);
             size_t capacity() const;
+
+            /**
+             * Sets the distance up to which new ranges are coalesced with the existing ranges. A distance of 0 only
+             * coalesces overlapping or adjacent ranges, so that the ranges contain exactly the marked elements.
+             */
+            void setMergeDistance(size_t mergeDistance);
+            size_t mergeDistance() const;
+
             void markDirty(size_t pos, size_t size);
             bool clean() const;
+
+            /**
+             * Marks the entire capacity as clean.
+             */
+            void clear();
+
+            /**
+             * Returns the dirty ranges ordered by their positions.
+             */
+            const std::vector<Range>& ranges() const;
+
+            /**
+             * Returns the total number of dirty elements.
+             */
+            size_t dirtySize() const;
         };
 
         /**
@@ -63,14 +103,24 @@ namespace TrenchBroom {
          * Non-copyable; meant to be held in a std::shared_ptr.
          * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
          *
-         * Currently uses a single range to track the modified region which might upload much more than necessary;
-         * it might be worth mapping the VBO and editing it directly.
+         * The modified regions are tracked as a set of ranges, and only these are uploaded. If most of the buffer was
+         * modified, the buffer is orphaned and uploaded entirely so that the upload does not have to wait for the GPU to
+         * finish drawing from the old contents.
+         *
+         * The local copy of the elements, called the snapshot, can be dropped once it has been uploaded if the
+         * elements rarely change, see setRetainSnapshot(). When elements are written afterwards, the snapshot is only
+         * recreated with the written ranges being valid, and only these ranges are uploaded. If the holder is resized
+         * while the snapshot is incomplete, the missing elements are read back from the VBO. While the snapshot is
+         * incomplete, the dirty ranges are not coalesced, since the elements between two written ranges are not valid
+         * and must neither be uploaded nor be skipped when reading the snapshot back.
          */
         template<typename T>
         class VboHolder {
         protected:
             VboType m_type;
             std::vector<T> m_snapshot;
+            bool m_snapshotComplete;
+            bool m_retainSnapshot;
             DirtyRangeTracker m_dirtyRange;
             VboManager* m_vboManager;
             Vbo* m_vbo;
@@ -89,21 +139,71 @@ namespace TrenchBroom {
                     m_vboManager = &vboManager;
                 }
                 assert(m_vbo == nullptr);
+                assert(m_snapshotComplete);
 
                 m_vbo = m_vboManager->allocateVbo(m_type, m_snapshot.size() * sizeof(T), VboUsage::DynamicDraw);
                 assert(m_vbo != nullptr);
 
                 m_vbo->writeElements(0, m_snapshot);
 
-                m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
-                assert(m_dirtyRange.clean());
+                m_dirtyRange.clear();
                 assert((m_vbo->capacity() / sizeof(T)) == m_dirtyRange.capacity());
             }
 
+            void uploadDirtyRanges() {
+                // orphaning requires uploading the entire buffer, which is only possible if the snapshot is complete
+                if (m_snapshotComplete && m_dirtyRange.dirtySize() >= size() / 2u) {
+                    m_vbo->orphan();
+                    m_vbo->writeElements(0, m_snapshot);
+                } else {
+                    for (const auto& range : m_dirtyRange.ranges()) {
+                        const size_t bytesFromStart = range.pos * sizeof(T);
+                        m_vbo->writeArray(bytesFromStart,
+                                          m_snapshot.data() + range.pos,
+                                          range.size);
+                    }
+                }
+
+                m_dirtyRange.clear();
+            }
+
+            /**
+             * Reads the elements that are missing from an incomplete snapshot back from the VBO. These are the elements
+             * outside of the dirty ranges.
+             */
+            void restoreSnapshot() {
+                if (m_snapshotComplete) {
+                    return;
+                }
+
+                assert(m_vbo != nullptr);
+                m_snapshot.resize(size());
+
+                size_t pos = 0;
+                for (const auto& range : m_dirtyRange.ranges()) {
+                    m_vbo->readArray(pos * sizeof(T), m_snapshot.data() + pos, range.pos - pos);
+                    pos = range.pos + range.size;
+                }
+                m_vbo->readArray(pos * sizeof(T), m_snapshot.data() + pos, size() - pos);
+
+                m_snapshotComplete = true;
+                m_dirtyRange.setMergeDistance(DirtyRangeTracker::DefaultMergeDistance);
+            }
+
+            void dropSnapshot() {
+                assert(prepared());
+                m_snapshot = std::vector<T>();
+                m_snapshotComplete = empty();
+                if (!m_snapshotComplete) {
+                    m_dirtyRange.setMergeDistance(0u);
+                }
+            }
         public:
             explicit VboHolder(const VboType type) :
             m_type(type),
             m_snapshot(),
+            m_snapshotComplete(true),
+            m_retainSnapshot(true),
             m_dirtyRange(0),
             m_vboManager(nullptr),
             m_vbo(nullptr) {}
@@ -114,6 +214,8 @@ namespace TrenchBroom {
             VboHolder(const VboType type, std::vector<T>& elements) :
             m_type(type),
             m_snapshot(),
+            m_snapshotComplete(true),
+            m_retainSnapshot(true),
             m_dirtyRange(elements.size()),
             m_vboManager(nullptr),
             m_vbo(nullptr) {
@@ -137,13 +239,28 @@ namespace TrenchBroom {
                 freeBlock();
             }
 
+            /**
+             * Specifies whether the snapshot is kept after it has been uploaded. Dropping the snapshot saves memory for
+             * elements which rarely change. Takes effect on the next call to prepare().
+             */
+            void setRetainSnapshot(const bool retainSnapshot) {
+                m_retainSnapshot = retainSnapshot;
+            }
+
             void resize(const size_t newSize) {
+                restoreSnapshot();
                 m_snapshot.resize(newSize);
                 m_dirtyRange.expand(newSize);
             }
 
             T* getPointerToWriteElementsTo(const size_t offsetWithinBlock, const size_t elementCount) {
-                assert(offsetWithinBlock + elementCount <= m_snapshot.size());
+                assert(offsetWithinBlock + elementCount <= size());
+
+                if (m_snapshot.size() != size()) {
+                    // the snapshot was dropped, only the written elements will be valid
+                    assert(!m_snapshotComplete);
+                    m_snapshot.resize(size());
+                }
 
                 // mark dirty range
                 m_dirtyRange.markDirty(offsetWithinBlock, elementCount);
@@ -161,47 +278,38 @@ namespace TrenchBroom {
                     assert(prepared());
                     return;
                 }
-                if (prepared()) {
-                    return;
-                }
 
-                // first ever upload?
-                if (m_vbo == nullptr) {
-                    allocateBlock(vboManager);
-                    assert(prepared());
-                    return;
+                if (!prepared()) {
+                    if (m_vbo == nullptr) {
+                        // first ever upload
+                        allocateBlock(vboManager);
+                    } else if (m_dirtyRange.capacity() != (m_vbo->capacity() / sizeof(T))) {
+                        // resize, the snapshot was restored when resizing
+                        freeBlock();
+                        allocateBlock(vboManager);
+                    } else {
+                        // otherwise, it's an incremental update of the dirty ranges.
+                        uploadDirtyRanges();
+                    }
                 }
+                assert(prepared());
 
-                // resize?
-                if (m_dirtyRange.capacity() != (m_vbo->capacity() / sizeof(T))) {
-                    freeBlock();
-                    allocateBlock(vboManager);
-                    assert(prepared());
-                    return;
-                }
-
-                // otherwise, it's an incremental update of the dirty ranges.
-
-                if (!m_dirtyRange.clean()) {
-                    const size_t pos = m_dirtyRange.m_dirtyPos;
-                    const size_t size = m_dirtyRange.m_dirtySize;
-
-                    const size_t bytesFromStart = pos * sizeof(T);
-                    m_vbo->writeArray(bytesFromStart,
-                                      m_snapshot.data() + pos,
-                                      size);
+                if (!m_retainSnapshot) {
+                    dropSnapshot();
+                } else {
+                    restoreSnapshot();
                 }
-
-                m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
-                assert(prepared());
             }
 
             bool empty() const {
-                return m_snapshot.empty();
+                return size() == 0u;
             }
 
+            /**
+             * Returns the number of elements, which is the same as the size of the snapshot unless it was dropped.
+             */
             size_t size() const {
-                return m_snapshot.size();
+                return m_dirtyRange.capacity();
             }
 
             void bindBlock() {
@@ -259,6 +367,11 @@ namespace TrenchBroom {
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Specifies whether the local copy of the indices is kept after they have been uploaded.
+             */
+            void setRetainSnapshot(bool retainSnapshot);
+
             void render(const PrimType primType) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
@@ -314,7 +427,7 @@ namespace TrenchBroom {
          */
         class BrushVertexArray {
         private:
-            using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+            using Vertex = Renderer::GLVertexTypes::P3NT3::Vertex;
 
             VertexHolder<Vertex> m_vertexHolder;
             AllocationTracker m_allocationTracker;
@@ -333,6 +446,11 @@ namespace TrenchBroom {
 
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Specifies whether the local copy of the vertices is kept after they have been uploaded.
+             */
+            void setRetainSnapshot(bool retainSnapshot);
+
             // setting up GL attributes
             bool setupVertices();
             void cleanupVertices();
@@ -85,7 +85,8 @@ namespace TrenchBroom {
                     vertex->setPayload(static_cast<GLuint>(currentIndex));
 
                     const auto& position = vertex->position();
-                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
+                    const auto texCoords = face.textureCoords(position);
+                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), vm::vec3f(texCoords.x(), texCoords.y(), 0.0f));
 
                     current = current->previous();
                 }
@@ -36,7 +36,11 @@ namespace TrenchBroom {
     namespace Renderer {
         class BrushRendererBrushCache {
         public:
-            using VertexSpec = Renderer::GLVertexTypes::P3NT2;
+            /**
+             * The third texture coordinate is the layer of the face's texture in its texture array. It is always 0
+             * here, the BrushRenderer sets it when it copies the vertices into its vertex array.
+             */
+            using VertexSpec = Renderer::GLVertexTypes::P3NT3;
             using Vertex = VertexSpec::Vertex;
 
             struct CachedFace {
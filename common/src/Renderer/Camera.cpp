@@ -21,9 +21,11 @@
 
 #include "Macros.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/ray.h>
 #include <vecmath/distance.h>
 #include <vecmath/intersection.h>
+#include <vecmath/plane.h>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -152,6 +154,24 @@ namespace TrenchBroom {
             doComputeFrustumPlanes(top, right, bottom, left);
         }
 
+        bool Camera::intersectsFrustum(const vm::bbox3f& box) const {
+            vm::plane3f planes[4];
+            frustumPlanes(planes[0], planes[1], planes[2], planes[3]);
+
+            // the plane normals point out of the frustum, so the box is outside of it if the corner of the box that is
+            // furthest behind one of the planes is still above that plane
+            for (const auto& plane : planes) {
+                const auto corner = vm::vec3f(
+                    plane.normal.x() >= 0.0f ? box.min.x() : box.max.x(),
+                    plane.normal.y() >= 0.0f ? box.min.y() : box.max.y(),
+                    plane.normal.z() >= 0.0f ? box.min.z() : box.max.z());
+                if (plane.point_distance(corner) > 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         vm::ray3f Camera::viewRay() const {
             return vm::ray3f(m_position, m_direction);
         }
@@ -107,6 +107,12 @@ namespace TrenchBroom {
             const vm::mat4x4f orthogonalBillboardMatrix() const;
             const vm::mat4x4f verticalBillboardMatrix() const;
             void frustumPlanes(vm::plane3f& topPlane, vm::plane3f& rightPlane, vm::plane3f& bottomPlane, vm::plane3f& leftPlane) const;
+            /**
+             * Checks whether the given box intersects the region bounded by the frustum planes of this camera. The test
+             * is conservative, i.e., it may return true for some boxes that are not visible, but it never returns
+             * false for a visible box. The near and far planes are not considered.
+             */
+            bool intersectsFrustum(const vm::bbox3f& box) const;
 
             vm::ray3f viewRay() const;
             vm::ray3f pickRay(int x, int y) const;
@@ -44,6 +44,7 @@
 #include <vecmath/vec.h>
 
 #include <cassert>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -53,6 +54,7 @@ namespace TrenchBroom {
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
         m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
+        m_cachesLinks(false),
         m_valid(false) {}
 
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
@@ -77,14 +79,62 @@ namespace TrenchBroom {
             m_valid = false;
         }
 
+        void EntityLinkRenderer::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            if (!m_valid) {
+                return;
+            }
+
+            if (!m_cachesLinks) {
+                // only the links of the selected entities are shown, and they are cheap to collect again
+                invalidate();
+                return;
+            }
+
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [](Model::WorldNode*) {},
+                    [](Model::LayerNode*) {},
+                    [](auto&& thisLambda, Model::GroupNode* group) {
+                        group->visitChildren(thisLambda);
+                    },
+                    [&](Model::EntityNode* entity) {
+                        m_invalidEntityNodes.insert(entity);
+                    },
+                    [&](Model::BrushNode* brush) {
+                        if (auto* entity = dynamic_cast<Model::EntityNode*>(brush->parent())) {
+                            m_invalidEntityNodes.insert(entity);
+                        }
+                    }
+                ));
+            }
+        }
+
+        void EntityLinkRenderer::removeNodes(const std::vector<Model::Node*>& nodes) {
+            if (m_invalidEntityNodes.empty()) {
+                return;
+            }
+
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+                    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+                    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+                    [&](Model::EntityNode* entity) { m_invalidEntityNodes.erase(entity); },
+                    [](Model::BrushNode*) {}
+                ));
+            }
+        }
+
         void EntityLinkRenderer::doPrepareVertices(VboManager& vboManager) {
             if (!m_valid) {
                 validate();
-
-                // Upload the VBO's
-                m_entityLinks.prepare(vboManager);
-                m_entityLinkArrows.prepare(vboManager);
+            } else if (!updateInvalidLinks()) {
+                return;
             }
+
+            // Upload the VBO's
+            m_entityLinks.prepare(vboManager);
+            m_entityLinkArrows.prepare(vboManager);
         }
 
         void EntityLinkRenderer::doRender(RenderContext& renderContext) {
@@ -125,17 +175,118 @@ namespace TrenchBroom {
         }
 
         void EntityLinkRenderer::validate() {
-            std::vector<Vertex> links;
-            getLinks(links);
+            m_linksBySource.clear();
+            m_invalidEntityNodes.clear();
+
+            // all links are collected again, so the changes recorded by the world are no longer needed
+            auto document = kdl::mem_lock(m_document);
+            if (auto* world = document->world()) {
+                world->takeEntityLinkChanges();
+            }
+
+            m_cachesLinks = pref(Preferences::EntityLinkMode) == Preferences::entityLinkModeAll();
+            if (m_cachesLinks) {
+                getAllLinks();
+                setCachedLinks();
+            } else {
+                std::vector<Vertex> links;
+                getLinks(links);
+                setLinks(std::move(links));
+            }
 
+            m_valid = true;
+        }
+
+        /**
+         * Collects the links of the entity nodes which were invalidated or whose links were changed, and of the entity
+         * nodes linking to them, and assembles the vertex arrays again. Returns false if nothing has changed.
+         *
+         * Since the number of arrows depends on the length of each link, the vertex arrays cannot be patched in place,
+         * so they are assembled from the cached links and arrows and uploaded entirely. Only the arrows of the updated
+         * links are built again. This is still much cheaper than visiting every entity node in the world.
+         */
+        bool EntityLinkRenderer::updateInvalidLinks() {
+            auto document = kdl::mem_lock(m_document);
+            auto* world = document->world();
+            if (world == nullptr) {
+                return false;
+            }
+
+            const auto changes = world->takeEntityLinkChanges();
+            if (!m_cachesLinks) {
+                if (changes.removedNodes.empty() && changes.changedNodes.empty()) {
+                    return false;
+                }
+
+                validate();
+                return true;
+            }
+
+            if (changes.removedNodes.empty() && changes.changedNodes.empty() && m_invalidEntityNodes.empty()) {
+                return false;
+            }
+
+            // removed nodes may have been deleted already
+            for (auto* node : changes.removedNodes) {
+                m_linksBySource.erase(node);
+                m_invalidEntityNodes.erase(node);
+            }
+
+            auto invalidSources = std::unordered_set<Model::EntityNodeBase*>{};
+            const auto addInvalidSources = [&](Model::EntityNodeBase* node) {
+                invalidSources.insert(node);
+                invalidSources.insert(std::begin(node->linkSources()), std::end(node->linkSources()));
+                invalidSources.insert(std::begin(node->killSources()), std::end(node->killSources()));
+            };
+
+            for (auto* node : changes.changedNodes) {
+                addInvalidSources(node);
+            }
+            for (auto* node : m_invalidEntityNodes) {
+                addInvalidSources(node);
+            }
+            m_invalidEntityNodes.clear();
+
+            // the world's links are not rendered, see getAllLinks
+            invalidSources.erase(world);
+
+            const Model::EditorContext& editorContext = document->editorContext();
+            for (auto* source : invalidSources) {
+                updateLinks(editorContext, source);
+            }
+
+            setCachedLinks();
+            return true;
+        }
+
+        void EntityLinkRenderer::setLinks(std::vector<Vertex> links) {
             // build the arrows before destroying `links`
             std::vector<ArrowVertex> arrows;
             getArrows(arrows, links);
 
             m_entityLinks = VertexArray::move(std::move(links));
             m_entityLinkArrows = VertexArray::move(std::move(arrows));
+        }
 
-            m_valid = true;
+        void EntityLinkRenderer::setCachedLinks() {
+            size_t linkCount = 0u;
+            size_t arrowCount = 0u;
+            for (const auto& [source, sourceLinks] : m_linksBySource) {
+                linkCount += sourceLinks.links.size();
+                arrowCount += sourceLinks.arrows.size();
+            }
+
+            auto links = std::vector<Vertex>{};
+            auto arrows = std::vector<ArrowVertex>{};
+            links.reserve(linkCount);
+            arrows.reserve(arrowCount);
+            for (const auto& [source, sourceLinks] : m_linksBySource) {
+                links.insert(std::end(links), std::begin(sourceLinks.links), std::end(sourceLinks.links));
+                arrows.insert(std::end(arrows), std::begin(sourceLinks.arrows), std::end(sourceLinks.arrows));
+            }
+
+            m_entityLinks = VertexArray::move(std::move(links));
+            m_entityLinkArrows = VertexArray::move(std::move(arrows));
         }
 
         void EntityLinkRenderer::getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links) {
@@ -296,21 +447,31 @@ namespace TrenchBroom {
         void EntityLinkRenderer::getLinks(std::vector<Vertex>& links) const {
             const QString entityLinkMode = pref(Preferences::EntityLinkMode);
 
-            if (entityLinkMode == Preferences::entityLinkModeAll()) {
-                getAllLinks(links);
-            } else if (entityLinkMode == Preferences::entityLinkModeTransitive()) {
+            if (entityLinkMode == Preferences::entityLinkModeTransitive()) {
                 getTransitiveSelectedLinks(links);
             } else if (entityLinkMode == Preferences::entityLinkModeDirect()) {
                 getDirectSelectedLinks(links);
             }
         }
 
-        void EntityLinkRenderer::getAllLinks(std::vector<Vertex>& links) const {
+        void EntityLinkRenderer::updateLinks(const Model::EditorContext& editorContext, Model::EntityNodeBase* source) {
+            std::vector<Vertex> links;
+            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
+            collectLinks.visit(source);
+
+            if (links.empty()) {
+                m_linksBySource.erase(source);
+            } else {
+                std::vector<ArrowVertex> arrows;
+                getArrows(arrows, links);
+                m_linksBySource[source] = SourceLinks{std::move(links), std::move(arrows)};
+            }
+        }
+
+        void EntityLinkRenderer::getAllLinks() {
             auto document = kdl::mem_lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
 
-            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
-
             if (document->world() != nullptr) {
                 document->world()->accept(kdl::overload(
                     [](auto&& thisLambda, Model::WorldNode* world) {
@@ -323,7 +484,7 @@ namespace TrenchBroom {
                         group->visitChildren(thisLambda);
                     },
                     [&](Model::EntityNode* entity) {
-                        collectLinks.visit(entity);
+                        updateLinks(editorContext, entity);
                     },
                     [](Model::BrushNode*) {}
                 ));
@@ -28,9 +28,17 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class EntityNodeBase;
+        class Node;
+    }
+
     namespace View {
         class MapDocument; // FIXME: Renderer should not depend on View
     }
@@ -64,6 +72,21 @@ namespace TrenchBroom {
             VertexArray m_entityLinks;
             VertexArray m_entityLinkArrows;
 
+            struct SourceLinks {
+                std::vector<Vertex> links;
+                std::vector<ArrowVertex> arrows;
+            };
+
+            /**
+             * If all links are shown, the link and arrow vertices are cached for each source entity node. Then only
+             * the links and arrows of entity nodes which were changed, moved or (de)selected, or whose links were
+             * changed according to the world, are built again, and the vertex arrays are assembled from the cached
+             * vertices.
+             */
+            bool m_cachesLinks;
+            std::unordered_map<const Model::EntityNodeBase*, SourceLinks> m_linksBySource;
+            std::unordered_set<Model::EntityNodeBase*> m_invalidEntityNodes;
+
             bool m_valid;
         public:
             EntityLinkRenderer(std::weak_ptr<View::MapDocument> document);
@@ -73,6 +96,20 @@ namespace TrenchBroom {
 
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void invalidate();
+
+            /**
+             * Invalidates the links from and to the given nodes, e.g. because the nodes were changed or their selection
+             * state changed. Brushes invalidate the links of their containing entities, and groups the links of their
+             * entities.
+             */
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Forgets the invalidated entity nodes among the given nodes and their descendants, which were removed from
+             * the world and may be deleted before the links are updated again. The world does not report nodes which
+             * were added since the links were last updated as removed, so they must be forgotten here.
+             */
+            void removeNodes(const std::vector<Model::Node*>& nodes);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
@@ -80,12 +117,16 @@ namespace TrenchBroom {
             void renderArrows(RenderContext& renderContext);
         private:
             void validate();
+            bool updateInvalidLinks();
+            void updateLinks(const Model::EditorContext& editorContext, Model::EntityNodeBase* source);
+            void setLinks(std::vector<Vertex> links);
+            void setCachedLinks();
 
             static void getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links);
             static void addArrow(std::vector<ArrowVertex>& arrows, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir);
 
             void getLinks(std::vector<Vertex>& links) const;
-            void getAllLinks(std::vector<Vertex>& links) const;
+            void getAllLinks();
             void getTransitiveSelectedLinks(std::vector<Vertex>& links) const;
             void getDirectSelectedLinks(std::vector<Vertex>& links) const;
 
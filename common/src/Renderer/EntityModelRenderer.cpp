@@ -23,6 +23,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Assets/AssetUtils.h"
+#include "Assets/EntityDefinition.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityModelManager.h"
 #include "Assets/ModelDefinition.h"
@@ -31,14 +32,23 @@
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/Camera.h"
+#include "Renderer/GLVertexType.h"
+#include "Renderer/PrimType.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
+#include "Renderer/ShaderProgram.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
+#include "Renderer/VertexArray.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -46,6 +56,7 @@ namespace TrenchBroom {
         m_logger(logger),
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_lodBoundsValid(false),
         m_applyTinting(false),
         m_showHiddenEntities(false) {}
 
@@ -62,6 +73,7 @@ namespace TrenchBroom {
             if (renderer != nullptr) {
                 m_entities.insert(std::make_pair(entityNode, renderer));
             }
+            m_lodBoundsValid = false;
         }
 
         void EntityModelRenderer::updateEntity(Model::EntityNode* entityNode) {
@@ -72,6 +84,9 @@ namespace TrenchBroom {
             auto* renderer = m_entityModelManager.renderer(modelSpec);
             EntityMap::iterator it = m_entities.find(entityNode);
 
+            // the bounds or the color of the entity may have changed
+            m_lodBoundsValid = false;
+
             if (renderer == nullptr && it == std::end(m_entities)) {
                 return;
             }
@@ -89,6 +104,10 @@ namespace TrenchBroom {
 
         void EntityModelRenderer::clear() {
             m_entities.clear();
+            m_instances.clear();
+            m_lodEntities.clear();
+            m_lodBoundsRenderer = TriangleRenderer();
+            m_lodBoundsValid = false;
         }
 
         bool EntityModelRenderer::applyTinting() const {
@@ -115,8 +134,83 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
-        void EntityModelRenderer::render(RenderBatch& renderBatch) {
-            renderBatch.add(this);
+        struct BuildLodBoundsVertices {
+            using Vertex = GLVertexTypes::P3NC4::Vertex;
+
+            std::vector<Vertex>& vertices;
+            Color color;
+
+            BuildLodBoundsVertices(std::vector<Vertex>& i_vertices, const Color& i_color) :
+            vertices(i_vertices),
+            color(i_color) {}
+
+            void operator()(const vm::vec3& v1, const vm::vec3& v2, const vm::vec3& v3, const vm::vec3& v4, const vm::vec3& n) {
+                vertices.emplace_back(vm::vec3f(v1), vm::vec3f(n), color);
+                vertices.emplace_back(vm::vec3f(v2), vm::vec3f(n), color);
+                vertices.emplace_back(vm::vec3f(v3), vm::vec3f(n), color);
+                vertices.emplace_back(vm::vec3f(v4), vm::vec3f(n), color);
+            }
+        };
+
+        void EntityModelRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            const auto& camera = renderContext.camera();
+
+            // only use the bounding boxes for the perspective camera, since the 2D one is always very far from the level
+            const auto lodDistance = pref(Preferences::EntityModelLodDistance);
+            const auto useLod = camera.perspectiveProjection() && lodDistance > 0.0f;
+            const auto lodDistance2 = lodDistance * lodDistance;
+
+            m_instances.clear();
+            std::vector<const Model::EntityNode*> lodEntities;
+
+            for (const auto& [entityNode, renderer] : m_entities) {
+                if (!m_showHiddenEntities && !m_editorContext.visible(entityNode)) {
+                    continue;
+                }
+
+                const auto bounds = vm::bbox3f(entityNode->physicalBounds());
+                if (!camera.intersectsFrustum(bounds)) {
+                    continue;
+                }
+
+                if (useLod && vm::squared_length(bounds.center() - camera.position()) > lodDistance2) {
+                    lodEntities.push_back(entityNode);
+                } else {
+                    m_instances[renderer].push_back(vm::mat4x4f(entityNode->entity().modelTransformation()));
+                }
+            }
+
+            validateLodBounds(std::move(lodEntities));
+            if (!m_lodEntities.empty()) {
+                m_lodBoundsRenderer.setApplyTinting(m_applyTinting);
+                m_lodBoundsRenderer.setTintColor(m_tintColor);
+                renderBatch.add(&m_lodBoundsRenderer);
+            }
+
+            if (!m_instances.empty()) {
+                renderBatch.add(this);
+            }
+        }
+
+        void EntityModelRenderer::validateLodBounds(std::vector<const Model::EntityNode*> lodEntities) {
+            if (m_lodBoundsValid && lodEntities == m_lodEntities) {
+                return;
+            }
+
+            std::vector<BuildLodBoundsVertices::Vertex> lodBoundsVertices;
+            lodBoundsVertices.reserve(6u * 4u * lodEntities.size());
+
+            for (const auto* entityNode : lodEntities) {
+                const auto* definition = entityNode->entity().definition();
+                const auto& color = definition != nullptr ? definition->color() : pref(Preferences::UndefinedEntityColor);
+
+                BuildLodBoundsVertices builder(lodBoundsVertices, color);
+                entityNode->modelBounds().for_each_face(builder);
+            }
+
+            m_lodBoundsRenderer = TriangleRenderer(VertexArray::move(std::move(lodBoundsVertices)), PrimType::Quads);
+            m_lodEntities = std::move(lodEntities);
+            m_lodBoundsValid = true;
         }
 
         void EntityModelRenderer::doPrepareVertices(VboManager& vboManager) {
@@ -124,9 +218,79 @@ namespace TrenchBroom {
         }
 
         void EntityModelRenderer::doRender(RenderContext& renderContext) {
-            auto& prefs = PreferenceManager::instance();
+            if (VertexArray::instancingSupported()) {
+                renderInstanced(renderContext);
+            } else {
+                renderInstances(renderContext);
+            }
+        }
+
+        /**
+         * Renders all instances of a model with a single draw call per texture and range. The transformations of the
+         * instances are passed as a per-instance vertex attribute.
+         */
+        void EntityModelRenderer::renderInstanced(RenderContext& renderContext) {
+            ActiveShader shader(renderContext.shaderManager(), Shaders::EntityModelInstancedShader);
+            setupShader(shader, renderContext);
 
+            glAssert(glEnable(GL_TEXTURE_2D));
+            glAssert(glActiveTexture(GL_TEXTURE0));
+
+            // a mat4 attribute occupies four consecutive locations, one for each column
+            const auto location = static_cast<GLuint>(renderContext.shaderManager().currentProgram()->findAttributeLocation("InstanceMatrix"));
+            for (GLuint column = 0u; column < 4u; ++column) {
+                glAssert(glEnableVertexAttribArray(location + column));
+                glAssert(glVertexAttribDivisorARB(location + column, 1u));
+            }
+
+            for (const auto& entry : m_instances) {
+                auto* renderer = entry.first;
+                const auto& instances = entry.second;
+
+                // the matrices are read from client memory, so no buffer must be bound when their pointers are set
+                glAssert(glBindBuffer(GL_ARRAY_BUFFER, 0));
+                for (GLuint column = 0u; column < 4u; ++column) {
+                    glAssert(glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(sizeof(vm::mat4x4f)), instances.front().v[column].v));
+                }
+
+                renderer->renderInstanced(instances.size());
+            }
+
+            for (GLuint column = 0u; column < 4u; ++column) {
+                glAssert(glVertexAttribDivisorARB(location + column, 0u));
+                glAssert(glDisableVertexAttribArray(location + column));
+            }
+        }
+
+        /**
+         * Renders the instances of a model one by one. This is used if the GL context does not support instancing.
+         */
+        void EntityModelRenderer::renderInstances(RenderContext& renderContext) {
             ActiveShader shader(renderContext.shaderManager(), Shaders::EntityModelShader);
+            setupShader(shader, renderContext);
+
+            glAssert(glEnable(GL_TEXTURE_2D));
+            glAssert(glActiveTexture(GL_TEXTURE0));
+
+            auto& transformation = renderContext.transformation();
+            for (const auto& entry : m_instances) {
+                auto* renderer = entry.first;
+                const auto& instances = entry.second;
+
+                // this pushes a model matrix which is replaced by the transformation of each instance
+                MultiplyModelMatrix multMatrix(transformation, vm::mat4x4f::identity());
+
+                renderer->renderInstances(instances.size(), [&](const size_t i) {
+                    transformation.popModelMatrix();
+                    transformation.pushModelMatrix(instances[i]);
+                    shader.set("ModelMatrix", instances[i]);
+                });
+            }
+        }
+
+        void EntityModelRenderer::setupShader(ActiveShader& shader, const RenderContext& renderContext) const {
+            auto& prefs = PreferenceManager::instance();
+
             shader.set("Brightness", prefs.get(Preferences::Brightness));
             shader.set("ApplyTinting", m_applyTinting);
             shader.set("TintColor", m_tintColor);
@@ -139,25 +303,6 @@ namespace TrenchBroom {
                                                        prefs.get(Preferences::SoftMapBoundsColor).g(),
                                                        prefs.get(Preferences::SoftMapBoundsColor).b(),
                                                        0.1f));
-
-            glAssert(glEnable(GL_TEXTURE_2D));
-            glAssert(glActiveTexture(GL_TEXTURE0));
-
-            for (const auto& entry : m_entities) {
-                auto* entityNode = entry.first;
-                if (!m_showHiddenEntities && !m_editorContext.visible(entityNode)) {
-                    continue;
-                }
-
-                auto* renderer = entry.second;
-
-                const auto transformation = entityNode->entity().modelTransformation();
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
-
-                shader.set("ModelMatrix", vm::mat4x4f(transformation));
-
-                renderer->render();
-            }
         }
     }
 }
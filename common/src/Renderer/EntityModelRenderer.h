@@ -21,8 +21,12 @@
 
 #include "Color.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TriangleRenderer.h"
+
+#include <vecmath/mat.h>
 
 #include <map>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
@@ -37,12 +41,22 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class ActiveShader;
         class RenderBatch;
         class TexturedRenderer;
 
+        /**
+         * Renders the models of point entities.
+         *
+         * The entities are grouped by their model renderers, which correspond to model frames, and every group is
+         * rendered with a single setup of its vertices and textures, only changing the transformation for every
+         * instance. Models which are farther away from the camera than the distance configured by the preference
+         * EntityModelLodDistance are rendered as solid bounding boxes instead.
+         */
         class EntityModelRenderer : public DirectRenderable {
         private:
             using EntityMap = std::map<Model::EntityNode*, TexturedRenderer*>;
+            using InstanceMap = std::map<TexturedRenderer*, std::vector<vm::mat4x4f>>;
 
             Logger& m_logger;
 
@@ -51,6 +65,20 @@ namespace TrenchBroom {
 
             EntityMap m_entities;
 
+            /**
+             * The transformations of the models to render in the current frame, grouped by their renderers.
+             */
+            InstanceMap m_instances;
+
+            /**
+             * Renders the bounding boxes of the models which are too far away from the camera in the current frame.
+             * The vertices are only rebuilt if these entities differ from the previous frame or if entities were added
+             * or updated since then.
+             */
+            std::vector<const Model::EntityNode*> m_lodEntities;
+            TriangleRenderer m_lodBoundsRenderer;
+            bool m_lodBoundsValid;
+
             bool m_applyTinting;
             Color m_tintColor;
 
@@ -93,10 +121,14 @@ namespace TrenchBroom {
             bool showHiddenEntities() const;
             void setShowHiddenEntities(bool showHiddenEntities);
 
-            void render(RenderBatch& renderBatch);
+            void render(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
+            void validateLodBounds(std::vector<const Model::EntityNode*> lodEntities);
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
+            void renderInstanced(RenderContext& renderContext);
+            void renderInstances(RenderContext& renderContext);
+            void setupShader(ActiveShader& shader, const RenderContext& renderContext) const;
         };
     }
 }
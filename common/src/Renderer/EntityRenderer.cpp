@@ -203,7 +203,7 @@ namespace TrenchBroom {
                 m_modelRenderer.setApplyTinting(m_tint);
                 m_modelRenderer.setTintColor(m_tintColor);
                 m_modelRenderer.setShowHiddenEntities(m_showHiddenEntities);
-                m_modelRenderer.render(renderBatch);
+                m_modelRenderer.render(renderContext, renderBatch);
             }
         }
 
@@ -22,6 +22,7 @@
 #include "Preferences.h"
 #include "PreferenceManager.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureArray.h"
 #include "Renderer/ActiveShader.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/Camera.h"
@@ -32,8 +33,29 @@
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 namespace TrenchBroom {
     namespace Renderer {
+        FaceBatchKey FaceBatchKey::forTexture(const Assets::Texture* texture) {
+            if (texture != nullptr && texture->textureArray() != nullptr) {
+                return FaceBatchKey{nullptr, texture->textureArray()};
+            } else {
+                return FaceBatchKey{texture, nullptr};
+            }
+        }
+
+        bool operator==(const FaceBatchKey& lhs, const FaceBatchKey& rhs) {
+            return lhs.texture == rhs.texture && lhs.textureArray == rhs.textureArray;
+        }
+
+        size_t FaceBatchKeyHash::operator()(const FaceBatchKey& key) const {
+            // at most one of the members is set
+            return key.texture != nullptr ? std::hash<const void*>()(key.texture) : std::hash<const void*>()(key.textureArray);
+        }
+
         struct FaceRenderer::RenderFunc : public TextureRenderFunc {
             ActiveShader& shader;
             bool applyTexture;
@@ -47,7 +69,8 @@ namespace TrenchBroom {
             void before(const Assets::Texture* texture) override {
                 if (texture != nullptr) {
                     texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
+                    // textures that have not been uploaded yet are rendered using their average color
+                    shader.set("ApplyTexture", applyTexture && texture->isPrepared());
                     shader.set("Color", texture->averageColor());
                 } else {
                     shader.set("ApplyTexture", false);
@@ -151,65 +174,107 @@ namespace TrenchBroom {
                 return;
 
             if (m_vertexArray->setupVertices()) {
-                ShaderManager& shaderManager = context.shaderManager();
-                ActiveShader shader(shaderManager, Shaders::FaceShader);
-                PreferenceManager& prefs = PreferenceManager::instance();
-
-                const bool applyTexture = context.showTextures();
-                const bool shadeFaces = context.shadeFaces();
-                const bool showFog = context.showFog();
-
                 glAssert(glEnable(GL_TEXTURE_2D));
                 glAssert(glActiveTexture(GL_TEXTURE0));
-                shader.set("Brightness", prefs.get(Preferences::Brightness));
-                shader.set("RenderGrid", context.showGrid());
-                shader.set("GridSize", static_cast<float>(context.gridSize()));
-                shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-                shader.set("ApplyTexture", applyTexture);
-                shader.set("Texture", 0);
-                shader.set("ApplyTinting", m_tint);
-                if (m_tint)
-                    shader.set("TintColor", m_tintColor);
-                shader.set("GrayScale", m_grayscale);
-                shader.set("CameraPosition", context.camera().position());
-                shader.set("ShadeFaces", shadeFaces);
-                shader.set("ShowFog", showFog);
-                shader.set("Alpha", m_alpha);
-                shader.set("EnableMasked", false);
-                shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
-                shader.set("SoftMapBoundsMin", context.softMapBounds().min);
-                shader.set("SoftMapBoundsMax", context.softMapBounds().max);
-                shader.set("SoftMapBoundsColor", vm::vec4f(prefs.get(Preferences::SoftMapBoundsColor).r(),
-                                                           prefs.get(Preferences::SoftMapBoundsColor).g(),
-                                                           prefs.get(Preferences::SoftMapBoundsColor).b(),
-                                                           0.1f));
-
-                RenderFunc func(shader, applyTexture, m_faceColor);
+
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_FALSE));
                 }
-                for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                    if (!brushIndexHolderPtr->hasValidIndices()) {
-                        continue;
-                    }
-
-                    const bool enableMasked = texture != nullptr && texture->masked();
-                    
-                    // set any per-texture uniforms
-                    shader.set("GridColor", gridColorForTexture(texture));
-                    shader.set("EnableMasked", enableMasked);
-
-                    func.before(texture);
-                    brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
-                    brushIndexHolderPtr->cleanupIndices();
-                    func.after(texture);
-                }
+                renderTextureBatches(context);
+                renderTextureArrayBatches(context);
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_TRUE));
                 }
                 m_vertexArray->cleanupVertices();
             }
         }
+
+        void FaceRenderer::renderTextureBatches(RenderContext& context) {
+            const auto hasBatches = std::any_of(std::begin(*m_indexArrayMap), std::end(*m_indexArrayMap), [](const auto& pair) {
+                return pair.first.textureArray == nullptr && pair.second->hasValidIndices();
+            });
+            if (!hasBatches) {
+                return;
+            }
+
+            ActiveShader shader(context.shaderManager(), Shaders::FaceShader);
+            setUniforms(shader, context);
+
+            RenderFunc func(shader, context.showTextures(), m_faceColor);
+            for (const auto& [key, brushIndexHolderPtr] : *m_indexArrayMap) {
+                if (key.textureArray != nullptr || !brushIndexHolderPtr->hasValidIndices()) {
+                    continue;
+                }
+
+                const auto* texture = key.texture;
+                const bool enableMasked = texture != nullptr && texture->masked();
+
+                // set any per-texture uniforms
+                shader.set("GridColor", gridColorForTexture(texture));
+                shader.set("EnableMasked", enableMasked);
+
+                func.before(texture);
+                brushIndexHolderPtr->setupIndices();
+                brushIndexHolderPtr->render(PrimType::Triangles);
+                brushIndexHolderPtr->cleanupIndices();
+                func.after(texture);
+            }
+        }
+
+        /**
+         * Renders the faces of all textures in a texture array with one draw call. The layer of each face's texture is
+         * taken from the third texture coordinate, and the shader derives the average color and the grid color from
+         * the smallest mipmap of the layer, so no uniforms need to be set per texture.
+         */
+        void FaceRenderer::renderTextureArrayBatches(RenderContext& context) {
+            const auto hasBatches = std::any_of(std::begin(*m_indexArrayMap), std::end(*m_indexArrayMap), [](const auto& pair) {
+                return pair.first.textureArray != nullptr && pair.second->hasValidIndices();
+            });
+            if (!hasBatches) {
+                return;
+            }
+
+            ActiveShader shader(context.shaderManager(), Shaders::FaceArrayShader);
+            setUniforms(shader, context);
+
+            for (const auto& [key, brushIndexHolderPtr] : *m_indexArrayMap) {
+                if (key.textureArray == nullptr || !brushIndexHolderPtr->hasValidIndices()) {
+                    continue;
+                }
+
+                key.textureArray->activate();
+                brushIndexHolderPtr->setupIndices();
+                brushIndexHolderPtr->render(PrimType::Triangles);
+                brushIndexHolderPtr->cleanupIndices();
+                key.textureArray->deactivate();
+            }
+        }
+
+        void FaceRenderer::setUniforms(ActiveShader& shader, RenderContext& context) const {
+            PreferenceManager& prefs = PreferenceManager::instance();
+
+            shader.set("Brightness", prefs.get(Preferences::Brightness));
+            shader.set("RenderGrid", context.showGrid());
+            shader.set("GridSize", static_cast<float>(context.gridSize()));
+            shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
+            shader.set("ApplyTexture", context.showTextures());
+            shader.set("Texture", 0);
+            shader.set("ApplyTinting", m_tint);
+            if (m_tint)
+                shader.set("TintColor", m_tintColor);
+            shader.set("GrayScale", m_grayscale);
+            shader.set("CameraPosition", context.camera().position());
+            shader.set("ShadeFaces", context.shadeFaces());
+            shader.set("ShowFog", context.showFog());
+            shader.set("Alpha", m_alpha);
+            shader.set("EnableMasked", false);
+            shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
+            shader.set("SoftMapBoundsMin", context.softMapBounds().min);
+            shader.set("SoftMapBoundsMax", context.softMapBounds().max);
+            shader.set("SoftMapBoundsColor", vm::vec4f(prefs.get(Preferences::SoftMapBoundsColor).r(),
+                                                       prefs.get(Preferences::SoftMapBoundsColor).g(),
+                                                       prefs.get(Preferences::SoftMapBoundsColor).b(),
+                                                       0.1f));
+        }
     }
 }
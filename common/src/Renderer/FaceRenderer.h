@@ -25,24 +25,44 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 
 namespace TrenchBroom {
     namespace Assets {
         class Texture;
+        class TextureArray;
     }
 
     namespace Renderer {
+        class ActiveShader;
         class BrushIndexArray;
         class BrushVertexArray;
         class RenderBatch;
 
+        /**
+         * Identifies a batch of faces which are rendered with one draw call. Faces whose textures are stored in a
+         * texture array are batched by that array, and all other faces are batched by their texture, which may be null.
+         */
+        struct FaceBatchKey {
+            const Assets::Texture* texture;
+            const Assets::TextureArray* textureArray;
+
+            static FaceBatchKey forTexture(const Assets::Texture* texture);
+        };
+
+        bool operator==(const FaceBatchKey& lhs, const FaceBatchKey& rhs);
+
+        struct FaceBatchKeyHash {
+            size_t operator()(const FaceBatchKey& key) const;
+        };
+
         class FaceRenderer : public IndexedRenderable {
         private:
             struct RenderFunc;
 
-            using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+            using TextureToBrushIndicesMap = const std::unordered_map<FaceBatchKey, std::shared_ptr<BrushIndexArray>, FaceBatchKeyHash>;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
@@ -69,6 +89,9 @@ namespace TrenchBroom {
         private:
             void prepareVerticesAndIndices(VboManager& vboManager) override;
             void doRender(RenderContext& context) override;
+            void renderTextureBatches(RenderContext& context);
+            void renderTextureArrayBatches(RenderContext& context);
+            void setUniforms(ActiveShader& shader, RenderContext& context) const;
         };
 
         void swap(FaceRenderer& left, FaceRenderer& right);
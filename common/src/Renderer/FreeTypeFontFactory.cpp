@@ -57,8 +57,8 @@ namespace TrenchBroom {
             auto font = buildFont(face, fontDescriptor.minChar(), fontDescriptor.charCount());
             FT_Done_Face(face);
 
-            // NOTE: bufferedReader is returned from loadFont() just to keep the buffer from
-            // being deallocated until after we call FT_Done_Face
+            // NOTE: bufferedReader is returned from loadFont() just to keep the buffer or the
+            // file mapping from being released until after we call FT_Done_Face
             unused(bufferedReader);
 
             return font;
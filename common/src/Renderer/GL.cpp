@@ -110,4 +110,14 @@ namespace TrenchBroom {
                 return "Unknown OpenGL enum";
         }
     }
+
+    static size_t drawCallCount = 0;
+
+    void glCountDrawCall() {
+        ++drawCallCount;
+    }
+
+    size_t glGetDrawCallCount() {
+        return drawCallCount;
+    }
 }
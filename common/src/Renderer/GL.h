@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,18 @@ namespace TrenchBroom {
     GLenum glGetEnum(const std::string& name);
     std::string glGetEnumName(GLenum _enum);
 
+    /**
+     * Counts a draw call. Must be called for every call to glDrawArrays, glDrawElements and their variants so that the
+     * number of draw calls per frame can be reported. Draw calls are only issued on the main thread, so the counter is
+     * not synchronized.
+     */
+    void glCountDrawCall();
+
+    /**
+     * Returns the number of draw calls that were counted since the program started.
+     */
+    size_t glGetDrawCallCount();
+
 // #define GL_DEBUG 1
 // #define GL_LOG 1
 
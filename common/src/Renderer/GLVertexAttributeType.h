@@ -181,6 +181,7 @@ namespace TrenchBroom {
             using P3  = GLVertexAttributePosition<GL_FLOAT, 3>;
             using N   = GLVertexAttributeNormal<GL_FLOAT, 3>;
             using T02 = GLVertexAttributeTexCoord0<GL_FLOAT, 2>;
+            using T03 = GLVertexAttributeTexCoord0<GL_FLOAT, 3>;
             using C4  = GLVertexAttributeColor<GL_FLOAT, 4>;
         }
     }
@@ -147,6 +147,12 @@ namespace TrenchBroom {
             }
         }
 
+        void IndexRangeMap::renderInstanced(VertexArray& vertexArray, const size_t instanceCount) const {
+            forEachPrimitive([&](const PrimType primType, const size_t index, const size_t count) {
+                vertexArray.renderInstanced(primType, static_cast<GLint>(index), static_cast<GLsizei>(count), static_cast<GLsizei>(instanceCount));
+            });
+        }
+
         void IndexRangeMap::forEachPrimitive(std::function<void(PrimType, size_t, size_t)> func) const {
             for (const auto& primType : PrimTypeValues) {
                 const auto& indicesAndCounts = m_data->get(primType);
@@ -275,6 +275,9 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+
+            // unselected brushes rarely change, so there is no need to keep a copy of their VBO data
+            renderer.setRetainBrushVboSnapshots(false);
         }
 
         void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer) {
@@ -317,6 +320,7 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
+            renderer.setRetainBrushVboSnapshots(false);
         }
 
         void MapRenderer::setupEntityLinkRenderer() {
@@ -392,7 +396,6 @@ namespace TrenchBroom {
                                              lockedNodes.entities,
                                              lockedNodes.brushes);
             }
-            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -442,6 +445,7 @@ namespace TrenchBroom {
             document->brushFacesDidChangeNotifier.addObserver(this, &MapRenderer::brushFacesDidChange);
             document->selectionDidChangeNotifier.addObserver(this, &MapRenderer::selectionDidChange);
             document->textureCollectionsWillChangeNotifier.addObserver(this, &MapRenderer::textureCollectionsWillChange);
+            document->textureArrayLayersDidChangeNotifier.addObserver(this, &MapRenderer::textureArrayLayersDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapRenderer::entityDefinitionsDidChange);
             document->modsDidChangeNotifier.addObserver(this, &MapRenderer::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapRenderer::editorContextDidChange);
@@ -466,6 +470,7 @@ namespace TrenchBroom {
                 document->brushFacesDidChangeNotifier.removeObserver(this, &MapRenderer::brushFacesDidChange);
                 document->selectionDidChangeNotifier.removeObserver(this, &MapRenderer::selectionDidChange);
                 document->textureCollectionsWillChangeNotifier.removeObserver(this, &MapRenderer::textureCollectionsWillChange);
+                document->textureArrayLayersDidChangeNotifier.removeObserver(this, &MapRenderer::textureArrayLayersDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapRenderer::entityDefinitionsDidChange);
                 document->modsDidChangeNotifier.removeObserver(this, &MapRenderer::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapRenderer::editorContextDidChange);
@@ -488,29 +493,34 @@ namespace TrenchBroom {
             updateRenderers(Renderer_All);
         }
 
-        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
             updateRenderers(Renderer_All);
+            m_entityLinkRenderer->removeNodes(nodes);
         }
 
-        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>& nodes) {
             invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+            m_entityLinkRenderer->invalidateNodes(nodes);
         }
 
         void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>&) {
             invalidateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>&) {
             updateRenderers(Renderer_Default_Locked);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasOpened(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasClosed(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
@@ -519,6 +529,7 @@ namespace TrenchBroom {
 
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
             updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
+            m_entityLinkRenderer->invalidateNodes(kdl::vec_concat(selection.selectedNodes(), selection.deselectedNodes()));
 
             // selecting faces needs to invalidate the brushes
             if (!selection.selectedBrushFaces().empty()
@@ -536,6 +547,13 @@ namespace TrenchBroom {
             invalidateRenderers(Renderer_All);
         }
 
+        void MapRenderer::textureArrayLayersDidChange(const std::vector<const Assets::Texture*>& textures) {
+            // the texture array and the layer of a face's texture are only read when the face is staged
+            m_defaultRenderer->invalidateBrushesWithTextures(textures);
+            m_selectionRenderer->invalidateBrushesWithTextures(textures);
+            m_lockedRenderer->invalidateBrushesWithTextures(textures);
+        }
+
         void MapRenderer::entityDefinitionsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
@@ -28,6 +28,10 @@
 namespace TrenchBroom {
     class Color;
 
+    namespace Assets {
+        class Texture;
+    }
+
     namespace IO {
         class Path;
     }
@@ -140,6 +144,7 @@ namespace TrenchBroom {
             void selectionDidChange(const View::Selection& selection);
 
             void textureCollectionsWillChange();
+            void textureArrayLayersDidChange(const std::vector<const Assets::Texture*>& textures);
             void entityDefinitionsDidChange();
             void modsDidChange();
 
@@ -39,6 +39,10 @@ namespace TrenchBroom {
             m_brushRenderer.invalidateBrushes(brushes);
         }
 
+        void ObjectRenderer::invalidateBrushesWithTextures(const std::vector<const Assets::Texture*>& textures) {
+            m_brushRenderer.invalidateBrushesWithTextures(textures);
+        }
+
         void ObjectRenderer::clear() {
             m_groupRenderer.clear();
             m_entityRenderer.clear();
@@ -131,6 +135,10 @@ namespace TrenchBroom {
             m_brushRenderer.setEdgeColor(brushEdgeColor);
         }
 
+        void ObjectRenderer::setRetainBrushVboSnapshots(const bool retainBrushVboSnapshots) {
+            m_brushRenderer.setRetainVboSnapshots(retainBrushVboSnapshots);
+        }
+
         void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects) {
             m_entityRenderer.setShowHiddenEntities(showHiddenObjects);
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
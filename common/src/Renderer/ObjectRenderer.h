@@ -31,6 +31,7 @@ namespace TrenchBroom {
 
     namespace Assets {
         class EntityModelManager;
+        class Texture;
     }
 
     namespace Model {
@@ -59,6 +60,7 @@ namespace TrenchBroom {
             void setObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes);
             void invalidate();
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
+            void invalidateBrushesWithTextures(const std::vector<const Assets::Texture*>& textures);
             void clear();
             void reloadModels();
         public: // configuration
@@ -87,6 +89,7 @@ namespace TrenchBroom {
             void setShowBrushEdges(bool showBrushEdges);
             void setBrushFaceColor(const Color& brushFaceColor);
             void setBrushEdgeColor(const Color& brushEdgeColor);
+            void setRetainBrushVboSnapshots(bool retainBrushVboSnapshots);
 
             void setShowHiddenObjects(bool showHiddenObjects);
         public: // rendering
@@ -19,6 +19,7 @@
 
 #include "RenderContext.h"
 #include "Renderer/Camera.h"
+#include "Renderer/GL.h"
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -43,7 +44,8 @@ namespace TrenchBroom {
         m_gridSize(4),
         m_hideSelection(false),
         m_tintSelection(true),
-        m_showSelectionGuide(ShowSelectionGuide::Hide) {}
+        m_showSelectionGuide(ShowSelectionGuide::Hide),
+        m_drawCallCountAtStart(glGetDrawCallCount()) {}
 
         bool RenderContext::render2D() const {
             return m_renderMode == RenderMode::Render2D;
@@ -217,6 +219,10 @@ namespace TrenchBroom {
             setShowSelectionGuide(ShowSelectionGuide::ForceHide);
         }
 
+        size_t RenderContext::drawCallCount() const {
+            return glGetDrawCallCount() - m_drawCallCountAtStart;
+        }
+
         void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide) {
             switch (showSelectionGuide) {
                 case ShowSelectionGuide::Show:
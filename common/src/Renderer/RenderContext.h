@@ -24,6 +24,8 @@
 
 #include <vecmath/bbox.h>
 
+#include <cstddef>
+
 namespace TrenchBroom {
     namespace Renderer {
         class Camera;
@@ -76,6 +78,9 @@ namespace TrenchBroom {
 
             ShowSelectionGuide m_showSelectionGuide;
             vm::bbox3f m_sofMapBounds;
+
+            // statistics
+            size_t m_drawCallCountAtStart;
         public:
             RenderContext(RenderMode renderMode, const Camera& camera, FontManager& fontManager, ShaderManager& shaderManager);
 
@@ -140,6 +145,11 @@ namespace TrenchBroom {
             void setHideSelectionGuide();
             void setForceShowSelectionGuide();
             void setForceHideSelectionGuide();
+
+            /**
+             * Returns the number of draw calls that were issued since this render context was created.
+             */
+            size_t drawCallCount() const;
         private:
             void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
         private:
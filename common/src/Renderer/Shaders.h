@@ -29,7 +29,9 @@ namespace TrenchBroom {
             extern const ShaderConfig VaryingPUniformCShader;
             extern const ShaderConfig MiniMapEdgeShader;
             extern const ShaderConfig EntityModelShader;
+            extern const ShaderConfig EntityModelInstancedShader;
             extern const ShaderConfig FaceShader;
+            extern const ShaderConfig FaceArrayShader;
             extern const ShaderConfig EdgeShader;
             extern const ShaderConfig ColoredTextShader;
             extern const ShaderConfig TextBackgroundShader;
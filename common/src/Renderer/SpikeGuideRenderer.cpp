@@ -20,6 +20,7 @@
 #include "SpikeGuideRenderer.h"
 
 #include "Model/Hit.h"
+#include "Model/HitFilter.h"
 #include "Model/HitQuery.h"
 #include "Model/BrushNode.h"
 #include "Model/PickResult.h"
@@ -48,7 +49,12 @@ namespace TrenchBroom {
         }
 
         void SpikeGuideRenderer::add(const vm::ray3& ray, const FloatType length, std::shared_ptr<View::MapDocument> document) {
-            Model::PickResult pickResult = Model::PickResult::byDistance(document->editorContext());
+            auto pickResult = Model::PickResult::nearestByDistance(document->editorContext(),
+                std::make_unique<Model::HitFilterChain>(
+                    std::make_unique<Model::ContextHitFilter>(document->editorContext()),
+                    std::make_unique<Model::HitFilterChain>(
+                        std::make_unique<Model::TypedHitFilter>(Model::BrushNode::BrushHitType),
+                        std::make_unique<Model::MinDistanceHitFilter>(1.0))));
             document->pick(ray, pickResult);
 
             const Model::Hit& hit = pickResult.query().pickable().type(Model::BrushNode::BrushHitType).occluded().minDistance(1.0).first();
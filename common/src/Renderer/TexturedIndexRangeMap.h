@@ -21,6 +21,7 @@
 
 #include "Renderer/IndexRangeMap.h"
 
+#include <functional>
 #include <map>
 
 namespace TrenchBroom {
@@ -168,6 +169,31 @@ namespace TrenchBroom {
              */
             void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+            /**
+             * Renders the primitives stored in this index range map once for each of the given number of instances
+             * using the vertices in the given vertex array. Before the primitives of an instance are rendered, the given
+             * setup function is called with the index of the instance, e.g. to set up its transformation.
+             *
+             * The primitives are batched by their associated textures, so that each texture is only bound once for all
+             * instances.
+             *
+             * @param vertexArray the vertex array to render with
+             * @param instanceCount the number of instances to render
+             * @param setupInstance the function to call before rendering an instance
+             */
+            void renderInstances(VertexArray& vertexArray, size_t instanceCount, const std::function<void(size_t)>& setupInstance);
+
+            /**
+             * Renders the primitives stored in this index range map for each of the given number of instances using
+             * the vertices in the given vertex array, with a single draw call per texture and range for all instances.
+             * The attributes of the instances, e.g. their transformations, must be set up by the caller as vertex
+             * attributes with a divisor of 1. Requires instancing support, see VertexArray::instancingSupported.
+             *
+             * @param vertexArray the vertex array to render with
+             * @param instanceCount the number of instances to render
+             */
+            void renderInstanced(VertexArray& vertexArray, size_t instanceCount);
+
             /**
              * Invokes the given function for each primitive stored in this map.
              *
@@ -57,6 +57,20 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, const std::function<void(size_t)>& setupInstance) {
+            if (instanceCount > 0 && m_vertexArray.setup()) {
+                m_indexRange.renderInstances(m_vertexArray, instanceCount, setupInstance);
+                m_vertexArray.cleanup();
+            }
+        }
+
+        void TexturedIndexRangeRenderer::renderInstanced(const size_t instanceCount) {
+            if (instanceCount > 0 && m_vertexArray.setup()) {
+                m_indexRange.renderInstanced(m_vertexArray, instanceCount);
+                m_vertexArray.cleanup();
+            }
+        }
+
         MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers) :
         m_renderers(std::move(renderers)) {}
 
@@ -88,5 +102,17 @@ namespace TrenchBroom {
                 renderer->render(func);
             }
         }
+
+        void MultiTexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, const std::function<void(size_t)>& setupInstance) {
+            for (auto& renderer : m_renderers) {
+                renderer->renderInstances(instanceCount, setupInstance);
+            }
+        }
+
+        void MultiTexturedIndexRangeRenderer::renderInstanced(const size_t instanceCount) {
+            for (auto& renderer : m_renderers) {
+                renderer->renderInstanced(instanceCount);
+            }
+        }
     }
 }
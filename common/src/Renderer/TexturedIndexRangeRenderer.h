@@ -22,6 +22,7 @@
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/VertexArray.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -43,6 +44,23 @@ namespace TrenchBroom {
             virtual void prepare(VboManager& vboManager) = 0;
             virtual void render() = 0;
             virtual void render(TextureRenderFunc& func) = 0;
+
+            /**
+             * Renders the given number of instances. The vertices are set up only once, and the given function is called
+             * with the index of each instance before it is rendered.
+             *
+             * @param instanceCount the number of instances to render
+             * @param setupInstance the function to call before rendering an instance
+             */
+            virtual void renderInstances(size_t instanceCount, const std::function<void(size_t)>& setupInstance) = 0;
+
+            /**
+             * Renders the given number of instances with a single draw call per texture and range. The attributes of
+             * the instances must be set up by the caller, see TexturedIndexRangeMap::renderInstanced.
+             *
+             * @param instanceCount the number of instances to render
+             */
+            virtual void renderInstanced(size_t instanceCount) = 0;
         };
 
         class TexturedIndexRangeRenderer : public TexturedRenderer {
@@ -60,6 +78,8 @@ namespace TrenchBroom {
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, const std::function<void(size_t)>& setupInstance) override;
+            void renderInstanced(size_t instanceCount) override;
         };
 
         class MultiTexturedIndexRangeRenderer : public TexturedRenderer {
@@ -74,6 +94,8 @@ namespace TrenchBroom {
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, const std::function<void(size_t)>& setupInstance) override;
+            void renderInstanced(size_t instanceCount) override;
         };
     }
 }
@@ -27,7 +27,8 @@ namespace TrenchBroom {
     namespace Renderer {
         Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage) :
         m_type(type),
-        m_capacity(capacity) {
+        m_capacity(capacity),
+        m_usage(usage) {
             assert(m_type == GL_ELEMENT_ARRAY_BUFFER
                    || m_type == GL_ARRAY_BUFFER);
 
@@ -63,5 +64,11 @@ namespace TrenchBroom {
             assert(m_bufferId != 0);
             glAssert(glBindBuffer(m_type, 0));
         }
+
+        void Vbo::orphan() {
+            assert(m_bufferId != 0);
+            glAssert(glBindBuffer(m_type, m_bufferId));
+            glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, m_usage));
+        }
     }
 }
@@ -39,6 +39,7 @@ namespace TrenchBroom {
              */
             GLenum m_type;
             size_t m_capacity;
+            GLenum m_usage;
             GLuint m_bufferId;
 
             /**
@@ -65,6 +66,15 @@ namespace TrenchBroom {
             void bind();
             void unbind();
 
+            /**
+             * Detaches the current storage from this buffer and allocates new storage of the same capacity. The contents
+             * are unspecified afterwards.
+             *
+             * The driver keeps the old storage alive until the GPU has finished using it, so writing to the buffer after
+             * orphaning it does not have to wait for pending draw calls. Use this before overwriting the entire buffer.
+             */
+            void orphan();
+
             template <typename T>
             size_t writeElements(const size_t address, const std::vector<T>& elements) {
                 return writeArray(address, elements.data(), elements.size());
@@ -100,6 +110,33 @@ namespace TrenchBroom {
 
                 return size;
             }
+
+            /**
+             * Reads elements from the VBO block into a C array. This waits until the GPU has finished writing to the
+             * buffer, so it should be used sparingly.
+             *
+             * @tparam T        element type
+             * @param address   byte offset from the start of the block to read from
+             * @param array     array to read into
+             * @param count     number of elements to read
+             * @return          number of bytes read
+             */
+            template <typename T>
+            size_t readArray(const size_t address, T* array, const size_t count) const {
+                const size_t size = count * sizeof(T);
+                assert(address + size <= m_capacity);
+
+                static_assert(std::is_trivially_copyable<T>::value);
+                static_assert(std::is_standard_layout<T>::value);
+
+                GLvoid* ptr = static_cast<GLvoid*>(array);
+                const GLintptr offset = static_cast<GLintptr>(address);
+                const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
+                glAssert(glBindBuffer(m_type, m_bufferId));
+                glAssert(glGetBufferSubData(m_type, offset, sizei, ptr));
+
+                return size;
+            }
         };
     }
 }
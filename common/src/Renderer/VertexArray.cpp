@@ -83,10 +83,12 @@ namespace TrenchBroom {
             if (!m_setup) {
                 if (setup()) {
                     glAssert(glDrawArrays(toGL(primType), index, count));
+                    glCountDrawCall();
                     cleanup();
                 }
             } else {
                 glAssert(glDrawArrays(toGL(primType), index, count));
+                glCountDrawCall();
             }
         }
 
@@ -97,12 +99,14 @@ namespace TrenchBroom {
                     const auto* indexArray = indices.data();
                     const auto* countArray = counts.data();
                     glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+                    glCountDrawCall();
                     cleanup();
                 }
             } else {
                 const auto* indexArray = indices.data();
                 const auto* countArray = counts.data();
                 glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+                glCountDrawCall();
             }
 
         }
@@ -113,14 +117,35 @@ namespace TrenchBroom {
                 if (setup()) {
                     const auto* indexArray = indices.data();
                     glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+                    glCountDrawCall();
                     cleanup();
                 }
             } else {
                 const auto* indexArray = indices.data();
                 glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+                glCountDrawCall();
             }
         }
 
+        void VertexArray::renderInstanced(const PrimType primType, const GLint index, const GLsizei count, const GLsizei instanceCount) {
+            assert(prepared());
+            assert(instancingSupported());
+            if (!m_setup) {
+                if (setup()) {
+                    glAssert(glDrawArraysInstancedARB(toGL(primType), index, count, instanceCount));
+                    glCountDrawCall();
+                    cleanup();
+                }
+            } else {
+                glAssert(glDrawArraysInstancedARB(toGL(primType), index, count, instanceCount));
+                glCountDrawCall();
+            }
+        }
+
+        bool VertexArray::instancingSupported() {
+            return GLEW_ARB_draw_instanced != GL_FALSE && GLEW_ARB_instanced_arrays != GL_FALSE;
+        }
+
         VertexArray::VertexArray(std::shared_ptr<BaseHolder> holder) :
         m_holder(std::move(holder)),
         m_prepared(false),
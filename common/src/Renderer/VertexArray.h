@@ -286,7 +286,25 @@ namespace TrenchBroom {
              * @param count the number of vertices to render
              */
             void render(PrimType primType, const GLIndices& indices, GLsizei count);
+
+            /**
+             * Renders the given number of instances of a range of primitives of the given type with a single draw call.
+             * The vertex attributes which differ between the instances must be set up by the caller with a divisor of
+             * 1. Requires instancing support, see instancingSupported().
+             *
+             * @param primType the primitive type to render
+             * @param index the index of the first vertex in this vertex array to render
+             * @param count the number of vertices to render
+             * @param instanceCount the number of instances to render
+             */
+            void renderInstanced(PrimType primType, GLint index, GLsizei count, GLsizei instanceCount);
             void cleanup();
+
+            /**
+             * Indicates whether the current GL context supports rendering instances with a single draw call, which
+             * requires the GL_ARB_draw_instanced and GL_ARB_instanced_arrays extensions.
+             */
+            static bool instancingSupported();
         private:
             explicit VertexArray(std::shared_ptr<BaseHolder> holder);
         };
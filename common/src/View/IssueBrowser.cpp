@@ -106,19 +106,19 @@ namespace TrenchBroom {
         }
 
         void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>&) {
-            m_view->reload();
+            m_view->refresh();
         }
 
         void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>&) {
-            m_view->reload();
+            m_view->refresh();
         }
 
         void IssueBrowser::nodesDidChange(const std::vector<Model::Node*>&) {
-            m_view->reload();
+            m_view->refresh();
         }
 
         void IssueBrowser::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
-            m_view->reload();
+            m_view->refresh();
         }
 
         void IssueBrowser::issueIgnoreChanged(Model::Issue*) {
@@ -34,6 +34,10 @@
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <unordered_set>
 #include <vector>
 
 #include <QHBoxLayout>
@@ -49,7 +53,9 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_reloadAll(true),
+        m_world(nullptr) {
             createGui();
             bindEvents();
         }
@@ -79,15 +85,20 @@ namespace TrenchBroom {
             if (hiddenGenerators == m_hiddenGenerators)
                 return;
             m_hiddenGenerators = hiddenGenerators;
-            invalidate();
+            reload();
         }
 
         void IssueBrowserView::setShowHiddenIssues(const bool show) {
             m_showHiddenIssues = show;
-            invalidate();
+            reload();
         }
 
         void IssueBrowserView::reload() {
+            m_reloadAll = true;
+            invalidate();
+        }
+
+        void IssueBrowserView::refresh() {
             invalidate();
         }
 
@@ -115,29 +126,64 @@ namespace TrenchBroom {
 
         void IssueBrowserView::updateIssues() {
             auto document = kdl::mem_lock(m_document);
-            if (document->world() != nullptr) {
-                const auto& issueGenerators = document->world()->registeredIssueGenerators();
-                
-                auto issues = std::vector<Model::Issue*>{};
-                const auto collectIssues = [&](auto* node) {
-                    for (auto* issue : node->issues(issueGenerators)) {
-                        if (m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0)) {
-                            issues.push_back(issue);
-                        }
+            if (auto* world = document->world()) {
+                const auto changes = world->validateIssues();
+                if (m_reloadAll || world != m_world) {
+                    reloadIssues(*world);
+                } else {
+                    refreshIssues(*world, changes.removedNodes, changes.validatedNodes);
+                }
+
+                m_reloadAll = false;
+                m_world = world;
+            }
+        }
+
+        void IssueBrowserView::reloadIssues(Model::WorldNode& world) {
+            const auto& issueGenerators = world.registeredIssueGenerators();
+
+            auto issues = std::vector<Model::Issue*>{};
+            const auto collectIssues = [&](auto* node) {
+                for (auto* issue : node->issues(issueGenerators)) {
+                    if (showIssue(issue)) {
+                        issues.push_back(issue);
+                    }
+                }
+            };
+
+            world.accept(kdl::overload(
+                [&](auto&& thisLambda, Model::WorldNode* worldNode) { collectIssues(worldNode); worldNode->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::LayerNode* layer)     { collectIssues(layer); layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::GroupNode* group)     { collectIssues(group); group->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::EntityNode* entity)   { collectIssues(entity); entity->visitChildren(thisLambda); },
+                [&](Model::BrushNode* brush)                        { collectIssues(brush); }
+            ));
+
+            issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); });
+            m_tableModel->setIssues(std::move(issues));
+        }
+
+        void IssueBrowserView::refreshIssues(const Model::WorldNode& world, const std::vector<Model::Node*>& removedNodes, const std::vector<Model::Node*>& validatedNodes) {
+            // the issues of the validated nodes were replaced, so their old issues must be removed, too
+            auto changedNodes = std::unordered_set<const Model::Node*>(std::begin(removedNodes), std::end(removedNodes));
+            changedNodes.insert(std::begin(validatedNodes), std::end(validatedNodes));
+            m_tableModel->removeIssues(changedNodes);
+
+            const auto& issueGenerators = world.registeredIssueGenerators();
+
+            auto issues = std::vector<Model::Issue*>{};
+            for (auto* node : validatedNodes) {
+                for (auto* issue : node->issues(issueGenerators)) {
+                    if (showIssue(issue)) {
+                        issues.push_back(issue);
                     }
-                };
-
-                document->world()->accept(kdl::overload(
-                    [&](auto&& thisLambda, Model::WorldNode* world)   { collectIssues(world); world->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::LayerNode* layer)   { collectIssues(layer); layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group)   { collectIssues(group); group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { collectIssues(entity); entity->visitChildren(thisLambda); },
-                    [&](Model::BrushNode* brush)                      { collectIssues(brush); }
-                ));
-
-                issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); });
-                m_tableModel->setIssues(std::move(issues));
+                }
             }
+            m_tableModel->addIssues(std::move(issues));
+        }
+
+        bool IssueBrowserView::showIssue(const Model::Issue* issue) const {
+            return m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0);
         }
 
         void IssueBrowserView::applyQuickFix(const Model::IssueQuickFix* quickFix) {
@@ -199,7 +245,7 @@ namespace TrenchBroom {
                 document->setIssueHidden(issue, !show);
             }
 
-            invalidate();
+            reload();
         }
 
         QList<QModelIndex> IssueBrowserView::getSelection() const {
@@ -273,14 +319,83 @@ namespace TrenchBroom {
 
         IssueBrowserModel::IssueBrowserModel(QObject* parent)
         : QAbstractTableModel(parent),
-          m_issues() {}
+          m_issues(),
+          m_nodes() {}
 
         void IssueBrowserModel::setIssues(std::vector<Model::Issue*> issues) {
             beginResetModel();
             m_issues = std::move(issues);
+            m_nodes = kdl::vec_transform(m_issues, [](const auto* issue) -> const Model::Node* { return issue->node(); });
             endResetModel();
         }
 
+        void IssueBrowserModel::removeIssues(const std::unordered_set<const Model::Node*>& nodes) {
+            // if the rows to remove are scattered, resetting the model is cheaper than removing every range of rows
+            static const auto MaxRemovedRanges = size_t(32);
+
+            // find the ranges of rows to remove as pairs of first and last row
+            auto ranges = std::vector<std::pair<size_t, size_t>>{};
+            for (size_t i = 0; i < m_nodes.size(); ++i) {
+                if (nodes.count(m_nodes[i]) > 0u) {
+                    if (!ranges.empty() && ranges.back().second + 1u == i) {
+                        ranges.back().second = i;
+                    } else {
+                        ranges.emplace_back(i, i);
+                    }
+                }
+            }
+
+            if (ranges.size() > MaxRemovedRanges) {
+                beginResetModel();
+                auto issues = std::vector<Model::Issue*>{};
+                auto issueNodes = std::vector<const Model::Node*>{};
+                for (size_t i = 0; i < m_nodes.size(); ++i) {
+                    if (nodes.count(m_nodes[i]) == 0u) {
+                        issues.push_back(m_issues[i]);
+                        issueNodes.push_back(m_nodes[i]);
+                    }
+                }
+                m_issues = std::move(issues);
+                m_nodes = std::move(issueNodes);
+                endResetModel();
+            } else {
+                // remove back to front so that the rows of the remaining ranges don't change
+                for (auto it = std::rbegin(ranges); it != std::rend(ranges); ++it) {
+                    const auto [first, last] = *it;
+                    beginRemoveRows(QModelIndex(), static_cast<int>(first), static_cast<int>(last));
+                    const auto count = static_cast<std::ptrdiff_t>(last - first + 1u);
+                    const auto offset = static_cast<std::ptrdiff_t>(first);
+                    m_issues.erase(std::next(std::begin(m_issues), offset), std::next(std::begin(m_issues), offset + count));
+                    m_nodes.erase(std::next(std::begin(m_nodes), offset), std::next(std::begin(m_nodes), offset + count));
+                    endRemoveRows();
+                }
+            }
+        }
+
+        void IssueBrowserModel::addIssues(std::vector<Model::Issue*> issues) {
+            if (issues.empty()) {
+                return;
+            }
+
+            const auto cmp = [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); };
+            issues = kdl::vec_sort(std::move(issues), cmp);
+
+            if (m_issues.empty() || issues.back()->seqId() > m_issues.front()->seqId()) {
+                // Sequence IDs increase monotonically, so newly generated issues are usually newer than all issues in
+                // this model and can be inserted at the top.
+                beginInsertRows(QModelIndex(), 0, static_cast<int>(issues.size()) - 1);
+                m_nodes.insert(std::begin(m_nodes), issues.size(), nullptr);
+                std::transform(std::begin(issues), std::end(issues), std::begin(m_nodes), [](const auto* issue) -> const Model::Node* { return issue->node(); });
+                m_issues.insert(std::begin(m_issues), std::begin(issues), std::end(issues));
+                endInsertRows();
+            } else {
+                auto merged = std::vector<Model::Issue*>{};
+                merged.reserve(m_issues.size() + issues.size());
+                std::merge(std::begin(m_issues), std::end(m_issues), std::begin(issues), std::end(issues), std::back_inserter(merged), cmp);
+                setIssues(std::move(merged));
+            }
+        }
+
         const std::vector<Model::Issue*>& IssueBrowserModel::issues() {
             return m_issues;
         }
@@ -22,6 +22,7 @@
 #include "Model/IssueType.h"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include <QWidget>
@@ -34,6 +35,8 @@ namespace TrenchBroom {
     namespace Model {
         class Issue;
         class IssueQuickFix;
+        class Node;
+        class WorldNode;
     }
 
     namespace View {
@@ -49,6 +52,8 @@ namespace TrenchBroom {
             bool m_showHiddenIssues;
 
             bool m_valid;
+            bool m_reloadAll;
+            const Model::WorldNode* m_world;
 
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
@@ -60,10 +65,20 @@ namespace TrenchBroom {
             int hiddenGenerators() const;
             void setHiddenGenerators(int hiddenGenerators);
             void setShowHiddenIssues(bool show);
+            /**
+             * Collects the issues of all nodes again, e.g. because the document was loaded or the filters changed.
+             */
             void reload();
+            /**
+             * Updates only the issues of the nodes which changed since the last update.
+             */
+            void refresh();
             void deselectAll();
         private:
             void updateIssues();
+            void reloadIssues(Model::WorldNode& world);
+            void refreshIssues(const Model::WorldNode& world, const std::vector<Model::Node*>& removedNodes, const std::vector<Model::Node*>& validatedNodes);
+            bool showIssue(const Model::Issue* issue) const;
 
             std::vector<Model::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
             std::vector<Model::IssueQuickFix*> collectQuickFixes(const QList<QModelIndex>& indices) const;
@@ -87,17 +102,25 @@ namespace TrenchBroom {
         };
 
         /**
-         * Trivial QAbstractTableModel subclass, when the issues list changes,
-         * it just refreshes the entire list with beginResetModel()/endResetModel().
+         * QAbstractTableModel subclass which keeps the issues sorted by descending sequence ID, so that the newest
+         * issues are shown first. The issues can either be replaced entirely, or updated by removing the issues of
+         * some nodes and adding new issues.
          */
         class IssueBrowserModel : public QAbstractTableModel {
             Q_OBJECT
         private:
             std::vector<Model::Issue*> m_issues;
+            /**
+             * The node of every issue in m_issues. The issues of a node are deleted when the node's issues are
+             * invalidated, so they are removed by their nodes rather than by the issues themselves.
+             */
+            std::vector<const Model::Node*> m_nodes;
         public:
             explicit IssueBrowserModel(QObject* parent);
 
             void setIssues(std::vector<Model::Issue*> issues);
+            void removeIssues(const std::unordered_set<const Model::Node*>& nodes);
+            void addIssues(std::vector<Model::Issue*> issues);
             const std::vector<Model::Issue*>& issues();
         public: // QAbstractTableModel overrides
             int rowCount(const QModelIndex& parent) const override;
@@ -32,6 +32,7 @@
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
 #include "EL/ELExceptions.h"
+#include "IO/CompressedTextureCache.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/GameConfigParser.h"
@@ -774,7 +775,7 @@ namespace TrenchBroom {
 
         void MapDocument::selectTouching(const bool del) {
             const auto nodes = kdl::vec_filter(
-                Model::collectTouchingNodes(std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+                Model::collectTouchingNodes(m_world.get(), m_selectedNodes.brushes()),
                 [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
             Transaction transaction(this, "Select Touching");
@@ -787,7 +788,7 @@ namespace TrenchBroom {
 
         void MapDocument::selectInside(const bool del) {
             const auto nodes = kdl::vec_filter(
-                Model::collectContainedNodes(std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+                Model::collectContainedNodes(m_world.get(), m_selectedNodes.brushes()),
                 [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
             Transaction transaction(this, "Select Inside");
@@ -921,7 +922,7 @@ namespace TrenchBroom {
             deleteObjects();
 
             const auto nodesToSelect = kdl::vec_filter(
-                Model::collectContainedNodes(std::vector<Model::Node*>{world()}, tallBrushes), 
+                Model::collectContainedNodes(world(), tallBrushes), 
                 [&](const auto* node) { return editorContext().selectable(node); });
             kdl::vec_clear_and_delete(tallBrushes);
 
@@ -2393,6 +2394,15 @@ namespace TrenchBroom {
 
         void MapDocument::commitPendingAssets() {
             m_textureManager->commitChanges();
+
+            const auto textures = m_textureManager->takeTexturesWithChangedArrayLayers();
+            if (!textures.empty()) {
+                textureArrayLayersDidChangeNotifier(textures);
+            }
+        }
+
+        bool MapDocument::hasPendingAssets() const {
+            return m_textureManager->hasPendingChanges();
         }
 
         void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const {
@@ -2545,6 +2555,11 @@ namespace TrenchBroom {
         void MapDocument::loadTextures() {
             try {
                 const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
+                m_textureManager->setLazyLoading(pref(Preferences::LazyTextureLoading));
+                m_textureManager->setUseTextureArrays(pref(Preferences::TextureArrays));
+                m_textureManager->setCompressedTextureCache(pref(Preferences::TextureCompression)
+                    ? std::make_shared<IO::CompressedTextureCache>(IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache"))
+                    : nullptr);
                 m_game->loadTextureCollections(m_world->entity(), docDir, *m_textureManager, logger());
             } catch (const Exception& e) {
                 error(e.what());
@@ -175,6 +175,7 @@ namespace TrenchBroom {
             Notifier<> textureCollectionsDidChangeNotifier;
             
             Notifier<> textureUsageCountsDidChangeNotifier;
+            Notifier<const std::vector<const Assets::Texture*>&> textureArrayLayersDidChangeNotifier;
 
             Notifier<> entityDefinitionsWillChangeNotifier;
             Notifier<> entityDefinitionsDidChangeNotifier;
@@ -477,6 +478,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> doExecuteAndStore(std::unique_ptr<UndoableCommand>&& command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            bool hasPendingAssets() const;
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
             std::vector<Model::Node*> findNodesContaining(const vm::vec3& point) const;
@@ -27,6 +27,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/EditorContext.h"
@@ -37,6 +38,7 @@
 #include "Model/Issue.h"
 #include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
+#include "Model/Polyhedron.h"
 #include "Model/WorldNode.h"
 #include "View/CommandProcessor.h"
 #include "View/UndoableCommand.h"
@@ -231,12 +233,16 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
 
             std::vector<Model::Node*> addedNodes;
+            m_world->beginEntityNodeIndexBatch();
+            m_world->beginNodeTreeBatch();
             for (const auto& entry : nodes) {
                 Model::Node* parent = entry.first;
                 const std::vector<Model::Node*>& children = entry.second;
                 parent->addChildren(children);
                 addedNodes = kdl::vec_concat(std::move(addedNodes), children);
             }
+            m_world->endNodeTreeBatch();
+            m_world->endEntityNodeIndexBatch();
 
             setEntityDefinitions(addedNodes);
             setEntityModels(addedNodes);
@@ -253,6 +259,8 @@ namespace TrenchBroom {
             const std::vector<Model::Node*> allChildren = collectChildren(nodes);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyChildren(nodesWillBeRemovedNotifier, nodesWereRemovedNotifier, allChildren);
 
+            m_world->beginEntityNodeIndexBatch();
+            m_world->beginNodeTreeBatch();
             for (const auto& entry : nodes) {
                 Model::Node* parent = entry.first;
                 const std::vector<Model::Node*>& children = entry.second;
@@ -261,6 +269,8 @@ namespace TrenchBroom {
                 unsetTextures(children);
                 parent->removeChildren(std::begin(children), std::end(children));
             }
+            m_world->endNodeTreeBatch();
+            m_world->endEntityNodeIndexBatch();
 
             invalidateSelectionBounds();
         }
@@ -304,6 +314,8 @@ namespace TrenchBroom {
             Notifier<>::NotifyBeforeAndAfter notifyEntityDefinitions(notifyEntityDefinitionsChange, entityDefinitionsWillChangeNotifier, entityDefinitionsDidChangeNotifier);
             Notifier<>::NotifyBeforeAndAfter notifyMods(notifyModsChange, modsWillChangeNotifier, modsDidChangeNotifier);
 
+            m_world->beginEntityNodeIndexBatch();
+            m_world->beginNodeTreeBatch();
             for (auto& pair : nodesToSwap) {
                 auto* node = pair.first;
                 auto& contents = pair.second.get();
@@ -316,6 +328,8 @@ namespace TrenchBroom {
                     [&](Model::BrushNode* brushNode)   -> Model::NodeContents { return Model::NodeContents(brushNode->setBrush(std::get<Model::Brush>(std::move(contents)))); }
                 ));
             }
+            m_world->endNodeTreeBatch();
+            m_world->endEntityNodeIndexBatch();
 
             if (!notifyEntityDefinitionsChange && !notifyModsChange) {
                 setEntityDefinitions(nodes);
@@ -454,10 +468,17 @@ namespace TrenchBroom {
 
         void MapDocumentCommandFacade::documentWasNewed(MapDocument*) {
             m_commandProcessor->clear();
+            releaseUnusedBrushGeometryMemory();
         }
 
         void MapDocumentCommandFacade::documentWasLoaded(MapDocument*) {
             m_commandProcessor->clear();
+            releaseUnusedBrushGeometryMemory();
+        }
+
+        void MapDocumentCommandFacade::releaseUnusedBrushGeometryMemory() {
+            // the brushes of the previous world and of its undo history have been destroyed now
+            Model::BrushGeometry::releaseUnusedMemory();
         }
 
         bool MapDocumentCommandFacade::doCanUndoCommand() const {
@@ -104,6 +104,8 @@ namespace TrenchBroom {
             void bindObservers();
             void documentWasNewed(MapDocument* document);
             void documentWasLoaded(MapDocument* document);
+
+            void releaseUnusedBrushGeometryMemory();
         private: // implement MapDocument interface
             bool doCanUndoCommand() const override;
             bool doCanRedoCommand() const override;
@@ -158,6 +158,8 @@ namespace TrenchBroom {
             const auto& editorContext = document->editorContext();
             const auto axis = vm::find_abs_max_component(pickRay.direction);
 
+            // Hits are ordered by the size of the hit objects, so the first hit may lie anywhere along the ray, and no
+            // objects can be skipped when picking.
             auto pickResult = Model::PickResult::bySize(editorContext, axis);
             document->pick(pickRay, pickResult);
 
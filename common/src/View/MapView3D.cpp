@@ -30,6 +30,7 @@
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
 #include "Model/HitQuery.h"
 #include "Model/PickResult.h"
 #include "Model/PointFile.h"
@@ -193,6 +194,10 @@ namespace TrenchBroom {
         Model::PickResult MapView3D::doPick(const vm::ray3& pickRay) const {
             auto document = kdl::mem_lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
+
+            // This pick result is shared by all tools, which query it for the first hits of different kinds (e.g. the
+            // nearest selected brush, which may be occluded by unselected brushes), and drill selection needs every hit
+            // along the ray. Therefore we cannot use PickResult::nearestByDistance here.
             Model::PickResult pickResult = Model::PickResult::byDistance(editorContext);
 
             document->pick(pickRay, pickResult);
@@ -214,7 +219,10 @@ namespace TrenchBroom {
                 const auto pickRay = vm::ray3(m_camera->pickRay(clientCoords.x(), clientCoords.y()));
 
                 const auto& editorContext = document->editorContext();
-                auto pickResult = Model::PickResult::byDistance(editorContext);
+                auto pickResult = Model::PickResult::nearestByDistance(editorContext,
+                    std::make_unique<Model::HitFilterChain>(
+                        std::make_unique<Model::ContextHitFilter>(editorContext),
+                        std::make_unique<Model::TypedHitFilter>(Model::BrushNode::BrushHitType)));
 
                 document->pick(pickRay, pickResult);
                 const auto& hit = pickResult.query().pickable().type(Model::BrushNode::BrushHitType).occluded().first();
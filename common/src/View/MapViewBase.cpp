@@ -71,6 +71,7 @@
 #include <vecmath/util.h>
 
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <QtGlobal>
@@ -93,7 +94,8 @@ namespace TrenchBroom {
         m_renderer(renderer),
         m_compass(nullptr),
         m_portalFileRenderer(nullptr),
-        m_isCurrent(false) {
+        m_isCurrent(false),
+        m_lastDrawCallCount(0) {
             setToolBox(toolBox);
             bindObservers();
 
@@ -850,6 +852,13 @@ namespace TrenchBroom {
             renderFPS(renderContext, renderBatch);
 
             renderBatch.render(renderContext);
+            m_lastDrawCallCount = renderContext.drawCallCount();
+
+            // some textures are still being read or could not be uploaded within this frame's budget, so render again to
+            // upload the rest
+            if (document->hasPendingAssets()) {
+                update();
+            }
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
@@ -935,7 +944,7 @@ namespace TrenchBroom {
             if (pref(Preferences::ShowFPS)) {
                 Renderer::RenderService renderService(renderContext, renderBatch);
 
-                renderService.renderHeadsUp(m_currentFPS);
+                renderService.renderHeadsUp(m_currentFPS + " Draw calls: " + std::to_string(m_lastDrawCallCount));
             }
         }
 
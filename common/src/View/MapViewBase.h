@@ -95,6 +95,11 @@ namespace TrenchBroom {
              * MapViewActivationTracker instance.
              */
             bool m_isCurrent;
+
+            /**
+             * The number of draw calls issued to render the previous frame, shown along with the frame rate.
+             */
+            size_t m_lastDrawCallCount;
         private: // shortcuts
             std::vector<std::pair<QShortcut*, const Action*>> m_shortcuts;
         protected:
@@ -301,6 +301,10 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderTextures(layout, y, height);
             renderNames(layout, y, height);
+
+            if (doc->textureManager().hasPendingChanges()) {
+                update();
+            }
         }
 
         bool TextureBrowserView::doShouldRenderFocusIndicator() const {
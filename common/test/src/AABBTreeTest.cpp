@@ -20,10 +20,12 @@
 #include "AABBTree.h"
 
 #include <vecmath/vec.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 
 #include <set>
 #include <sstream>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -32,6 +34,7 @@ namespace TrenchBroom {
     using BOX = AABB::Box;
     using RAY = vm::ray<AABB::FloatType, AABB::Components>;
     using VEC = vm::vec<AABB::FloatType, AABB::Components>;
+    using PLANE = AABB::Plane;
 
 
     static void assertTree(const std::string& exp, const AABB& actual) {
@@ -49,6 +52,42 @@ namespace TrenchBroom {
         CHECK(actual == expected);
     }
 
+    static void assertIntersectors(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items) {
+        const std::set<AABB::DataType> expected(items);
+        std::set<AABB::DataType> actual;
+
+        tree.findIntersectors(box, std::inserter(actual, std::end(actual)));
+
+        CHECK(actual == expected);
+    }
+
+    static void assertIntersectors(const AABB& tree, const std::vector<PLANE>& planes, std::initializer_list<AABB::DataType> items) {
+        const std::set<AABB::DataType> expected(items);
+        std::set<AABB::DataType> actual;
+
+        tree.findIntersectors(planes, std::inserter(actual, std::end(actual)));
+
+        CHECK(actual == expected);
+    }
+
+    static void assertContainedBy(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items) {
+        const std::set<AABB::DataType> expected(items);
+        std::set<AABB::DataType> actual;
+
+        tree.findContainedBy(box, std::inserter(actual, std::end(actual)));
+
+        CHECK(actual == expected);
+    }
+
+    static void assertNotContainedBy(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items) {
+        const std::set<AABB::DataType> expected(items);
+        std::set<AABB::DataType> actual;
+
+        tree.findNotContainedBy(box, std::inserter(actual, std::end(actual)));
+
+        CHECK(actual == expected);
+    }
+
     static void assertTreeContains(const AABB& tree, const BOX& box, AABB::DataType data) {
         CHECK(tree.contains(data));
 
@@ -528,4 +567,186 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
 
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
+
+    TEST_CASE("AABBTreeTest.findBoxIntersectors", "[AABBTreeTest]") {
+        AABB tree;
+        assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), {});
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(-1.0, +4.0, -1.0), VEC(+1.0, +6.0, +1.0)), 3u);
+
+        assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), {});
+        assertIntersectors(tree, BOX(VEC(-3.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), { 1u });
+        assertIntersectors(tree, BOX(VEC(-2.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), { 1u, 2u });
+        assertIntersectors(tree, BOX(VEC(-8.0, -8.0, -8.0), VEC(+8.0, +8.0, +8.0)), { 1u, 2u, 3u });
+        assertIntersectors(tree, BOX(VEC( 0.0, +5.0,  0.0), VEC(+8.0, +8.0, +8.0)), { 3u });
+    }
+
+    TEST_CASE("AABBTreeTest.findContainedBy", "[AABBTreeTest]") {
+        AABB tree;
+        assertContainedBy(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), {});
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(-1.0, +4.0, -1.0), VEC(+1.0, +6.0, +1.0)), 3u);
+
+        assertContainedBy(tree, BOX(VEC(-3.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), {});
+        assertContainedBy(tree, BOX(VEC(-4.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), { 1u });
+        assertContainedBy(tree, BOX(VEC(-4.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), { 1u, 2u });
+        assertContainedBy(tree, BOX(VEC(-8.0, -8.0, -8.0), VEC(+8.0, +8.0, +8.0)), { 1u, 2u, 3u });
+    }
+
+    TEST_CASE("AABBTreeTest.findNotContainedBy", "[AABBTreeTest]") {
+        AABB tree;
+        assertNotContainedBy(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), {});
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(-1.0, +4.0, -1.0), VEC(+1.0, +6.0, +1.0)), 3u);
+
+        assertNotContainedBy(tree, BOX(VEC(-3.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), { 1u, 2u, 3u });
+        assertNotContainedBy(tree, BOX(VEC(-4.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), { 2u, 3u });
+        assertNotContainedBy(tree, BOX(VEC(-4.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), { 3u });
+        assertNotContainedBy(tree, BOX(VEC(-8.0, -8.0, -8.0), VEC(+8.0, +8.0, +8.0)), {});
+    }
+
+    TEST_CASE("AABBTreeTest.findVolumeIntersectors", "[AABBTreeTest]") {
+        AABB tree;
+
+        // the volume between the planes x = -3 and x = 3 with outward facing normals
+        const auto slab = std::vector<PLANE>{
+            PLANE(VEC(+3.0, 0.0, 0.0), VEC::pos_x()),
+            PLANE(VEC(-3.0, 0.0, 0.0), VEC::neg_x())
+        };
+        assertIntersectors(tree, slab, {});
+
+        tree.insert(BOX(VEC(-6.0, -1.0, -1.0), VEC(-4.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 3u);
+        tree.insert(BOX(VEC(+5.0, -1.0, -1.0), VEC(+6.0, +1.0, +1.0)), 4u);
+
+        assertIntersectors(tree, slab, { 2u, 3u });
+        assertIntersectors(tree, std::vector<PLANE>{}, { 1u, 2u, 3u, 4u });
+    }
+
+    TEST_CASE("AABBTreeTest.findIntersectorsByDistance", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(+6.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0)), 4u);
+        tree.insert(BOX(VEC(-2.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+4.0, -1.0, -1.0), VEC(+5.0, +1.0, +1.0)), 3u);
+        tree.insert(BOX(VEC(+1.0, -1.0, -1.0), VEC(+3.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+4.0, +2.0, -1.0), VEC(+5.0, +3.0, +1.0)), 5u);
+
+        const auto ray = RAY(VEC(0.0, 0.0, 0.0), VEC::pos_x());
+
+        SECTION("visits all intersectors in order of entry distance") {
+            auto actual = std::vector<std::pair<AABB::DataType, AABB::FloatType>>{};
+            tree.findIntersectorsByDistance(ray, [&](const AABB::DataType data, const AABB::FloatType distance) {
+                actual.emplace_back(data, distance);
+                return true;
+            });
+
+            CHECK(actual == std::vector<std::pair<AABB::DataType, AABB::FloatType>>{
+                { 1u, 0.0 }, { 2u, 1.0 }, { 3u, 4.0 }, { 4u, 6.0 }
+            });
+        }
+
+        SECTION("stops when the visitor returns false") {
+            auto actual = std::vector<AABB::DataType>{};
+            tree.findIntersectorsByDistance(ray, [&](const AABB::DataType data, const AABB::FloatType distance) {
+                if (distance > 2.0) {
+                    return false;
+                }
+                actual.push_back(data);
+                return true;
+            });
+
+            CHECK(actual == std::vector<AABB::DataType>{ 1u, 2u });
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        auto boxes = std::vector<BOX>{};
+        for (size_t x = 0u; x < 8u; ++x) {
+            for (size_t y = 0u; y < 8u; ++y) {
+                const auto min = VEC(static_cast<double>(x) * 4.0, static_cast<double>(y) * 4.0, 0.0);
+                boxes.emplace_back(min, min + VEC(2.0, 2.0, 2.0));
+            }
+        }
+
+        auto indices = std::vector<AABB::DataType>{};
+        for (size_t i = 0u; i < boxes.size(); ++i) {
+            indices.push_back(i);
+        }
+
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), 100u);
+        tree.clearAndBuild(indices, [&](const AABB::DataType i) { return boxes[i]; });
+
+        CHECK(tree.height() < 10u);
+        CHECK_FALSE(tree.contains(100u));
+        for (const auto i : indices) {
+            CHECK(tree.contains(i));
+        }
+
+        assertIntersectors(tree, RAY(VEC(1.0, 1.0, 1.0), VEC::pos_x()), { 0u, 8u, 16u, 24u, 32u, 40u, 48u, 56u });
+        assertIntersectors(tree, BOX(VEC(3.0, 3.0, 0.0), VEC(5.0, 5.0, 1.0)), { 9u });
+
+        SECTION("Duplicate data") {
+            indices.push_back(0u);
+            CHECK_THROWS_AS(tree.clearAndBuild(indices, [&](const AABB::DataType i) { return boxes[i]; }), NodeTreeException);
+            CHECK(tree.empty());
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.refit", "[AABBTreeTest]") {
+        auto boxes = std::vector<BOX>{
+            BOX(VEC(-6.0, -1.0, -1.0), VEC(-4.0, +1.0, +1.0)),
+            BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)),
+            BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)),
+            BOX(VEC(+5.0, -1.0, -1.0), VEC(+6.0, +1.0, +1.0))
+        };
+        const auto getBounds = [&](const AABB::DataType i) { return boxes[i]; };
+
+        AABB tree;
+        tree.clearAndBuild(std::vector<AABB::DataType>{ 0u, 1u, 2u, 3u }, getBounds);
+
+        SECTION("Moved boxes are found at their new position") {
+            boxes[0] = BOX(VEC(-1.0, +4.0, -1.0), VEC(+1.0, +6.0, +1.0));
+            boxes[3] = BOX(VEC(-1.0, -6.0, -1.0), VEC(+1.0, -4.0, +1.0));
+            tree.refit(std::vector<AABB::DataType>{ 0u, 3u }, getBounds);
+
+            CHECK(tree.bounds() == BOX(VEC(-1.0, -6.0, -1.0), VEC(+4.0, +6.0, +1.0)));
+            assertIntersectors(tree, RAY(VEC(0.0, -10.0, 0.0), VEC::pos_y()), { 0u, 1u, 3u });
+            assertIntersectors(tree, RAY(VEC(-10.0, 0.0, 0.0), VEC::pos_x()), { 1u, 2u });
+        }
+
+        SECTION("Refitting a tree that was queried before updates the query results") {
+            assertIntersectors(tree, RAY(VEC(0.0, -10.0, 0.0), VEC::pos_y()), { 1u });
+
+            boxes[0] = BOX(VEC(-1.0, +4.0, -1.0), VEC(+1.0, +6.0, +1.0));
+            tree.refit(std::vector<AABB::DataType>{ 0u }, getBounds);
+
+            assertIntersectors(tree, RAY(VEC(0.0, -10.0, 0.0), VEC::pos_y()), { 0u, 1u });
+            assertIntersectors(tree, RAY(VEC(-10.0, 0.0, 0.0), VEC::pos_x()), { 1u, 2u, 3u });
+            assertIntersectors(tree, BOX(VEC(-1.0, +5.0, 0.0), VEC(+1.0, +5.0, 0.0)), { 0u });
+        }
+
+        SECTION("Tree is rebuilt when its quality degrades") {
+            boxes[0] = BOX(VEC(+25.0, -1.0, -1.0), VEC(+26.0, +1.0, +1.0));
+            boxes[3] = BOX(VEC(-26.0, -1.0, -1.0), VEC(-24.0, +1.0, +1.0));
+            tree.refit(std::vector<AABB::DataType>{ 0u, 3u }, getBounds);
+
+            auto rebuilt = AABB();
+            rebuilt.clearAndBuild(std::vector<AABB::DataType>{ 0u, 1u, 2u, 3u }, getBounds);
+
+            CHECK(tree.sahCost() == rebuilt.sahCost());
+            assertIntersectors(tree, RAY(VEC(-30.0, 0.0, 0.0), VEC::pos_x()), { 0u, 1u, 2u, 3u });
+        }
+
+        SECTION("Unknown data") {
+            CHECK_THROWS_AS(tree.refit(std::vector<AABB::DataType>{ 4u }, getBounds), NodeTreeException);
+        }
+    }
 }
@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureBuffer.h"
+#include "Renderer/GL.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static TextureBuffer makeBuffer(const std::vector<unsigned char>& data) {
+            auto result = TextureBuffer(data.size());
+            std::copy(std::begin(data), std::end(data), result.data());
+            return result;
+        }
+
+        static std::vector<unsigned char> toVector(const TextureBuffer& buffer) {
+            return std::vector<unsigned char>(buffer.data(), buffer.data() + buffer.size());
+        }
+
+        TEST_CASE("TextureBufferTest.downsampleMip", "[TextureBufferTest]") {
+            SECTION("Averages blocks of 2x2 pixels") {
+                const auto buffer = makeBuffer({
+                     0,  0,  0, 255,    4,  8, 12, 255,   10, 10, 10, 255,   20, 20, 20, 255,
+                     8,  8,  8, 255,   12, 16, 20, 255,   30, 30, 30, 255,   40, 40, 40, 255,
+                });
+
+                const auto result = downsampleMip(buffer, vm::vec2s(4, 2), GL_RGBA);
+                CHECK(result.size() == 2u * 1u * 4u);
+                CHECK(toVector(result) == std::vector<unsigned char>({
+                     6,  8, 10, 255,   25, 25, 25, 255
+                }));
+            }
+
+            SECTION("Repeats the last column of odd widths") {
+                const auto buffer = makeBuffer({
+                    10, 20, 30,   50, 60, 70,   90, 90, 90,
+                });
+
+                const auto result = downsampleMip(buffer, vm::vec2s(3, 1), GL_RGB);
+                CHECK(toVector(result) == std::vector<unsigned char>({
+                    30, 40, 50
+                }));
+            }
+
+            SECTION("Downsamples 1x1 mipmaps to themselves") {
+                const auto buffer = makeBuffer({ 1, 2, 3, 4 });
+
+                const auto result = downsampleMip(buffer, vm::vec2s(1, 1), GL_BGRA);
+                CHECK(toVector(result) == std::vector<unsigned char>({ 1, 2, 3, 4 }));
+            }
+        }
+
+        TEST_CASE("TextureBufferTest.generateMips", "[TextureBufferTest]") {
+            auto buffers = TextureBufferList{};
+            buffers.push_back(makeBuffer({
+                 0,  0,  0,    4,  8, 12,   10, 10, 10,   20, 20, 20,
+                 8,  8,  8,   12, 16, 20,   30, 30, 30,   40, 40, 40,
+            }));
+
+            generateMips(buffers, 4u, 2u, GL_RGB);
+            REQUIRE(buffers.size() == 3u);
+            CHECK(toVector(buffers[1]) == std::vector<unsigned char>({
+                 6,  8, 10,   25, 25, 25
+            }));
+            CHECK(toVector(buffers[2]) == std::vector<unsigned char>({
+                16, 17, 18
+            }));
+
+            SECTION("Does not add mipmaps to complete lists") {
+                generateMips(buffers, 4u, 2u, GL_RGB);
+                CHECK(buffers.size() == 3u);
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCompression.h"
+#include "Renderer/GL.h"
+
+#include <vecmath/vec.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static TextureBuffer makeBuffer(const vm::vec2s& size, const std::vector<unsigned char>& pixel) {
+            auto result = TextureBuffer(size.x() * size.y() * pixel.size());
+            for (size_t i = 0u; i < result.size(); ++i) {
+                result.data()[i] = pixel[i % pixel.size()];
+            }
+            return result;
+        }
+
+        static std::vector<unsigned char> pixelAt(const TextureBuffer& buffer, const vm::vec2s& size, const size_t x, const size_t y) {
+            const auto* pixel = buffer.data() + (y * size.x() + x) * 4u;
+            return std::vector<unsigned char>(pixel, pixel + 4u);
+        }
+
+        TEST_CASE("TextureCompressionTest.mipBufferSize", "[TextureCompressionTest]") {
+            CHECK(mipBufferSize(vm::vec2s(8, 4), GL_RGBA) == 128u);
+            CHECK(mipBufferSize(vm::vec2s(8, 4), GL_COMPRESSED_RGB_S3TC_DXT1_EXT) == 16u);
+            CHECK(mipBufferSize(vm::vec2s(8, 4), GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) == 32u);
+            // partial blocks take up a whole block
+            CHECK(mipBufferSize(vm::vec2s(1, 1), GL_COMPRESSED_RGB_S3TC_DXT1_EXT) == 8u);
+            CHECK(mipBufferSize(vm::vec2s(5, 3), GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) == 32u);
+        }
+
+        TEST_CASE("TextureCompressionTest.compressMip", "[TextureCompressionTest]") {
+            SECTION("Solid colors are preserved") {
+                const auto size = vm::vec2s(5, 3);
+                const auto buffer = makeBuffer(size, { 0, 0, 255 });
+
+                const auto compressed = compressMip(buffer, size, GL_BGR, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+                CHECK(compressed.size() == mipBufferSize(size, GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+
+                const auto decompressed = decompressMip(compressed, size, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+                CHECK(decompressed.size() == size.x() * size.y() * 4u);
+                for (size_t y = 0u; y < size.y(); ++y) {
+                    for (size_t x = 0u; x < size.x(); ++x) {
+                        CHECK(pixelAt(decompressed, size, x, y) == std::vector<unsigned char>({ 255, 0, 0, 255 }));
+                    }
+                }
+            }
+
+            SECTION("BC3 preserves transparent pixels") {
+                const auto size = vm::vec2s(4, 4);
+                auto buffer = makeBuffer(size, { 0, 255, 0, 255 });
+                buffer.data()[3] = 0;
+
+                const auto compressed = compressMip(buffer, size, GL_RGBA, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+                const auto decompressed = decompressMip(compressed, size, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+                CHECK(pixelAt(decompressed, size, 0, 0)[3] == 0u);
+                CHECK(pixelAt(decompressed, size, 1, 0) == std::vector<unsigned char>({ 0, 255, 0, 255 }));
+            }
+
+            SECTION("Gradients are approximated") {
+                const auto size = vm::vec2s(4, 1);
+                auto buffer = TextureBuffer(4u * 4u);
+                for (size_t x = 0u; x < size.x(); ++x) {
+                    const auto value = static_cast<unsigned char>(x * 80u);
+                    buffer.data()[x * 4u + 0u] = value;
+                    buffer.data()[x * 4u + 1u] = 128u;
+                    buffer.data()[x * 4u + 2u] = static_cast<unsigned char>(255u - value);
+                    buffer.data()[x * 4u + 3u] = 255u;
+                }
+
+                const auto compressed = compressMip(buffer, size, GL_RGBA, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+                const auto decompressed = decompressMip(compressed, size, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+                for (size_t i = 0u; i < buffer.size(); ++i) {
+                    CHECK(std::abs(int(decompressed.data()[i]) - int(buffer.data()[i])) <= 24);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/CompressedTextureCache.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/PathQt.h"
+#include "IO/TestEnvironment.h"
+#include "Renderer/GL.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static Assets::Texture makeCompressedTexture() {
+            auto buffer = Assets::TextureBuffer(8u * 8u * 4u);
+            for (size_t i = 0u; i < buffer.size(); ++i) {
+                buffer.data()[i] = static_cast<unsigned char>(i);
+            }
+
+            auto texture = Assets::Texture("texture", 8u, 8u, Color(0.25f, 0.5f, 0.75f, 1.0f), std::move(buffer), GL_RGBA, Assets::TextureType::Opaque);
+            texture.compress();
+            return texture;
+        }
+
+        TEST_CASE("CompressedTextureCacheTest.makeKey", "[CompressedTextureCacheTest]") {
+            TestEnvironment env("compressed_texture_cache_test");
+            env.createFile(Path("image.png"), "some image data");
+            env.createFile(Path("other.png"), "some image data");
+
+            const auto fs = DiskFileSystem(env.dir());
+            const auto key = CompressedTextureCache::makeKey(fs, *fs.openFile(Path("image.png")));
+            CHECK(key == CompressedTextureCache::makeKey(fs, *fs.openFile(Path("image.png"))));
+            CHECK(key != CompressedTextureCache::makeKey(fs, *fs.openFile(Path("other.png"))));
+        }
+
+        TEST_CASE("CompressedTextureCacheTest.readAndWriteTexture", "[CompressedTextureCacheTest]") {
+            TestEnvironment env("compressed_texture_cache_test");
+            const auto cache = CompressedTextureCache(env.dir() + Path("cache"));
+
+            CHECK(cache.readTexture("key", "texture") == std::nullopt);
+
+            const auto texture = makeCompressedTexture();
+            REQUIRE(texture.compressed());
+            cache.writeTexture("key", texture);
+
+            const auto cachedTexture = cache.readTexture("key", "cached");
+            REQUIRE(cachedTexture.has_value());
+            CHECK(cachedTexture->name() == "cached");
+            CHECK(cachedTexture->width() == texture.width());
+            CHECK(cachedTexture->height() == texture.height());
+            CHECK(cachedTexture->format() == texture.format());
+            CHECK(cachedTexture->type() == texture.type());
+            CHECK(cachedTexture->averageColor() == texture.averageColor());
+
+            const auto& buffers = texture.buffersIfUnprepared();
+            const auto& cachedBuffers = cachedTexture->buffersIfUnprepared();
+            REQUIRE(cachedBuffers.size() == buffers.size());
+            for (size_t level = 0u; level < buffers.size(); ++level) {
+                REQUIRE(cachedBuffers[level].size() == buffers[level].size());
+                CHECK(std::equal(buffers[level].data(), buffers[level].data() + buffers[level].size(), cachedBuffers[level].data()));
+            }
+
+            CHECK(cache.readTexture("other key", "texture") == std::nullopt);
+        }
+
+        TEST_CASE("CompressedTextureCacheTest.trimRemovesLeastRecentlyUsedTextures", "[CompressedTextureCacheTest]") {
+            TestEnvironment env("compressed_texture_cache_test");
+            const auto directory = env.dir() + Path("cache");
+
+            const auto texture = makeCompressedTexture();
+            {
+                const auto cache = CompressedTextureCache(directory);
+                cache.writeTexture("a", texture);
+                cache.writeTexture("b", texture);
+                cache.writeTexture("c", texture);
+            }
+
+            const auto fileInfos = QDir(pathAsQString(directory)).entryInfoList(QDir::Files);
+            REQUIRE(fileInfos.size() == 3);
+
+            // make every file older than the files touched by reading them below
+            for (const auto& fileInfo : fileInfos) {
+                QFile file(fileInfo.absoluteFilePath());
+                REQUIRE(file.open(QIODevice::Append));
+                REQUIRE(file.setFileTime(QDateTime::currentDateTimeUtc().addSecs(-3600), QFileDevice::FileModificationTime));
+            }
+
+            size_t totalBytes = 0;
+            for (const auto& fileInfo : fileInfos) {
+                totalBytes += static_cast<size_t>(fileInfo.size());
+            }
+
+            {
+                const auto cache = CompressedTextureCache(directory);
+                CHECK(cache.readTexture("a", "a").has_value());
+                CHECK(cache.readTexture("c", "c").has_value());
+            }
+
+            // only the least recently used texture must be removed to fit into the maximum size
+            const auto cache = CompressedTextureCache(directory, totalBytes - 1u);
+            CHECK(cache.readTexture("a", "a").has_value());
+            CHECK(cache.readTexture("b", "b") == std::nullopt);
+            CHECK(cache.readTexture("c", "c").has_value());
+        }
+    }
+}
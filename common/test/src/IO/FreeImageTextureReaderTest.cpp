@@ -85,7 +85,8 @@ namespace TrenchBroom {
 
             CHECK(texture.width() == w);
             CHECK(texture.height() == h);
-            CHECK(texture.buffersIfUnprepared().size() == 1u);
+            // the missing mipmaps are computed when the texture is read
+            CHECK(texture.buffersIfUnprepared().size() == 7u);
             CHECK((GL_BGRA == texture.format() || GL_RGBA == texture.format()));
             CHECK(texture.type() == Assets::TextureType::Opaque);
 
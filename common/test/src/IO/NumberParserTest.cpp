@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/NumberParser.h"
+
+#include <kdl/string_utils.h>
+
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::optional<long> parseLong(const std::string& str) {
+            return parseLong(str.data(), str.data() + str.size());
+        }
+
+        static std::optional<double> parseDouble(const std::string& str) {
+            return parseDouble(str.data(), str.data() + str.size());
+        }
+
+        TEST_CASE("NumberParserTest.parseLong", "[NumberParserTest]") {
+            CHECK(parseLong("0") == 0l);
+            CHECK(parseLong("123") == 123l);
+            CHECK(parseLong("+123") == 123l);
+            CHECK(parseLong("-123") == -123l);
+            CHECK(parseLong("000123") == 123l);
+            CHECK(parseLong("2147483647") == 2147483647l);
+            CHECK(parseLong("-2147483648") == -2147483648l);
+
+            CHECK(parseLong("") == std::nullopt);
+            CHECK(parseLong("-") == std::nullopt);
+            CHECK(parseLong("abc") == std::nullopt);
+
+            // these are handled like kdl::str_to_long does
+            CHECK(parseLong("12abc") == 12l);
+            CHECK(parseLong(" 12") == 12l);
+            CHECK(parseLong("1.5") == 1l);
+        }
+
+        TEST_CASE("NumberParserTest.parseDouble", "[NumberParserTest]") {
+            CHECK(parseDouble("0") == 0.0);
+            CHECK(parseDouble("-64") == -64.0);
+            CHECK(parseDouble("+64") == 64.0);
+            CHECK(parseDouble("1.5") == 1.5);
+            CHECK(parseDouble("-.25") == -0.25);
+            CHECK(parseDouble("8.") == 8.0);
+            CHECK(parseDouble("1e3") == 1000.0);
+            CHECK(parseDouble("1.5e-2") == 0.015);
+            CHECK(parseDouble("0.1") == 0.1);
+            CHECK(parseDouble("505.37931034482756") == 505.37931034482756);
+
+            const auto negativeZero = parseDouble("-0");
+            REQUIRE(negativeZero.has_value());
+            CHECK(*negativeZero == 0.0);
+            CHECK(std::signbit(*negativeZero));
+
+            CHECK(parseDouble("") == std::nullopt);
+            CHECK(parseDouble(".") == std::nullopt);
+            CHECK(parseDouble("-") == std::nullopt);
+            CHECK(parseDouble("abc") == std::nullopt);
+
+            // these are handled like kdl::str_to_double does
+            CHECK(parseDouble("1e") == 1.0);
+            CHECK(parseDouble("12abc") == 12.0);
+            CHECK(parseDouble(" 12") == 12.0);
+        }
+
+        TEST_CASE("NumberParserTest.parseDoubleMatchesStrToDouble", "[NumberParserTest]") {
+            const auto strs = std::vector<std::string>{
+                "0.3", "-1320.0625", "0.000001", "123456789012345", "1234567890123456", "1e22", "1e23", "1e-22",
+                "0.30000000000000004", "-0.1234567890123456789", "3.14159265358979", "1E5", "4.9e-324", "1e400"
+            };
+
+            for (const auto& str : strs) {
+                CAPTURE(str);
+                CHECK(parseDouble(str) == kdl::str_to_double(str));
+            }
+        }
+    }
+}
@@ -182,5 +182,32 @@ namespace TrenchBroom {
         TEST_CASE("FileReaderTest.testSubReader", "[FileReaderTest]") {
             subReader(file()->reader());
         }
+
+        TEST_CASE("FileReaderTest.bufferMappedFile", "[FileReaderTest]") {
+            const auto mappedFile = std::dynamic_pointer_cast<MappedFile>(file());
+            REQUIRE(mappedFile != nullptr);
+            CHECK(mappedFile->size() == 10U);
+
+            // buffering a reader or a sub reader of a mapped file does not copy the file contents
+            const auto bufferedReader = mappedFile->reader().buffer();
+            CHECK(bufferedReader.begin() == mappedFile->begin());
+            CHECK(bufferedReader.end() == mappedFile->end());
+            CHECK(bufferedReader.stringView() == "abcdefghij");
+
+            const auto bufferedSubReader = mappedFile->reader().subReaderFromBegin(2U, 3U).buffer();
+            CHECK(bufferedSubReader.begin() == mappedFile->begin() + 2);
+            CHECK(bufferedSubReader.stringView() == "cde");
+        }
+
+        TEST_CASE("FileReaderTest.bufferedReaderOutlivesMappedFile", "[FileReaderTest]") {
+            auto mappedFile = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
+            auto bufferedReader = mappedFile->reader().buffer();
+            auto subReader = mappedFile->reader().subReaderFromBegin(2U, 3U);
+
+            // the readers keep the mapping alive after the file was released
+            mappedFile.reset();
+            CHECK(bufferedReader.stringView() == "abcdefghij");
+            CHECK(subReader.buffer().stringView() == "cde");
+        }
     }
 }
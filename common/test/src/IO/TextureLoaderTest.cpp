@@ -19,6 +19,7 @@
 
 #include "Logger.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
@@ -144,5 +145,44 @@ namespace TrenchBroom {
                 CHECK(texture->height() == height);
             }
         }
+
+        TEST_CASE("TextureLoaderTest.testLoadLazy", "[TextureLoaderTest]") {
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const std::vector<IO::Path> fileSearchPaths{ root };
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            const Model::TextureConfig textureConfig(
+                Model::TexturePackageConfig(
+                    Model::PackageFormatConfig("wad", "idmip")),
+                    Model::PackageFormatConfig("D", "idmip"),
+                    IO::Path("fixture/test/palette.lmp"),
+                    "wad",
+                    IO::Path(),
+                    {});
+
+            auto logger = NullLogger();
+            IO::TextureLoader textureLoader(fileSystem, fileSearchPaths, textureConfig, logger);
+            auto collection = textureLoader.loadTextureCollection(Path("fixture/test/IO/Wad/cr8_czg.wad"), true);
+
+            CHECK(collection.textureCount() == 21u);
+
+            auto* texture = collection.textureByName("cr8_czg_3");
+            REQUIRE(texture != nullptr);
+            CHECK(texture->lazy());
+            CHECK_FALSE(texture->loaded());
+            CHECK(texture->width() == 64u);
+            CHECK(texture->height() == 128u);
+            CHECK(texture->buffersIfUnprepared().empty());
+
+            texture->load();
+            CHECK(texture->loaded());
+            CHECK(texture->width() == 64u);
+            CHECK(texture->height() == 128u);
+            CHECK(texture->buffersIfUnprepared().size() == 4u);
+
+            texture->unload();
+            CHECK_FALSE(texture->loaded());
+            CHECK(texture->buffersIfUnprepared().empty());
+        }
     }
 }
@@ -17,6 +17,7 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/TestParserStatus.h"
@@ -34,6 +35,7 @@
 #include <vecmath/vec.h>
 
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -67,6 +69,36 @@ namespace TrenchBroom {
             checkFaceTexCoordSystem(faces[5], expectParallel);
         }
 
+        /**
+         * Creates a map with a worldspawn entity containing the given number of cuboid brushes, followed by a point
+         * entity. Each brush is preceded by a comment and takes 9 lines, so the opening brace of brush i is on line
+         * 4 + 9 * i. The given face line is added at the end of the last brush.
+         */
+        static std::string makeMapWithManyBrushes(const size_t brushCount, const std::string& lastFace) {
+            auto str = std::string("{\n\"classname\" \"worldspawn\"\n");
+            for (size_t i = 0u; i < brushCount; ++i) {
+                const auto x0 = std::to_string(static_cast<int>(i) * 256 - 64);
+                const auto x1 = std::to_string(static_cast<int>(i) * 256 - 63);
+                const auto x2 = std::to_string(static_cast<int>(i) * 256 + 64);
+                const auto x3 = std::to_string(static_cast<int>(i) * 256 + 65);
+                str += "// brush " + std::to_string(i) + "\n";
+                str += "{\n";
+                str += "( " + x0 + " -64 -16 ) ( " + x0 + " -63 -16 ) ( " + x0 + " -64 -15 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                str += "( " + x0 + " -64 -16 ) ( " + x0 + " -64 -15 ) ( " + x1 + " -64 -16 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                str += "( " + x0 + " -64 -16 ) ( " + x1 + " -64 -16 ) ( " + x0 + " -63 -16 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                str += "( " + x2 + " 64 16 ) ( " + x2 + " 65 16 ) ( " + x3 + " 64 16 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                str += "( " + x2 + " 64 16 ) ( " + x3 + " 64 16 ) ( " + x2 + " 64 17 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                str += "( " + x2 + " 64 16 ) ( " + x2 + " 64 17 ) ( " + x2 + " 65 16 ) tex" + std::to_string(i) + " 0 0 0 1 1\n";
+                if (i == brushCount - 1u) {
+                    str += lastFace + "\n";
+                }
+                str += "}\n";
+            }
+            str += "}\n";
+            str += "{\n\"classname\" \"info_player_start\"\n\"origin\" \"0 0 0\"\n}\n";
+            return str;
+        }
+
         TEST_CASE("WorldReaderTest.parseFailure_1424", "[WorldReaderTest]") {
             const std::string data(R"(
 {
@@ -1461,5 +1493,80 @@ common/caulk
                 CHECK(face.attributes().textureName() == Model::BrushFaceAttributes::NoTextureName);
             }
         }
+
+        TEST_CASE("WorldReaderTest.parseManyBrushes", "[WorldReaderTest]") {
+            const auto brushCount = size_t(1000);
+            const auto lastFaceLine = 4u + 9u * (brushCount - 1u) + 7u;
+            const auto data = makeMapWithManyBrushes(brushCount, "( 0 0 0 ) ( 0 0 0 ) ( 0 0 0 ) tex 0 0 0 1 1");
+            const vm::bbox3 worldBounds(8192.0 * 64.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+
+            auto world = reader.read(worldBounds, status);
+            REQUIRE(world != nullptr);
+            REQUIRE(world->childCount() == 1u);
+
+            Model::LayerNode* defaultLayer = dynamic_cast<Model::LayerNode*>(world->children().front());
+            REQUIRE(defaultLayer != nullptr);
+            REQUIRE(defaultLayer->childCount() == brushCount + 1u);
+
+            // the brushes are in file order and have the correct file positions
+            for (size_t i = 0u; i < brushCount; ++i) {
+                const auto* brushNode = dynamic_cast<const Model::BrushNode*>(defaultLayer->children()[i]);
+                REQUIRE(brushNode != nullptr);
+                CHECK(brushNode->lineNumber() == 4u + 9u * i);
+                CHECK(brushNode->brush().faces().front().attributes().textureName() == "tex" + std::to_string(i));
+            }
+            CHECK(dynamic_cast<const Model::EntityNode*>(defaultLayer->children().back()) != nullptr);
+
+            // the invalid face of the last brush is reported with its line number
+            const auto& errors = status.messages(LogLevel::Error);
+            REQUIRE(errors.size() == 1u);
+            CHECK(errors.front().find("(line " + std::to_string(lastFaceLine) + ")") != std::string::npos);
+        }
+
+        TEST_CASE("WorldReaderTest.parseManyBrushesWithEmptyBrush", "[WorldReaderTest]") {
+            const auto brushCount = size_t(1000);
+            const auto lastBrushLine = 4u + 9u * (brushCount - 1u);
+
+            // this face cuts away the entire last brush
+            const auto x = std::to_string(static_cast<int>(brushCount - 1u) * 256 - 74);
+            const auto data = makeMapWithManyBrushes(brushCount, "( " + x + " -64 -16 ) ( " + x + " -64 -15 ) ( " + x + " -63 -16 ) tex 0 0 0 1 1");
+            const vm::bbox3 worldBounds(8192.0 * 64.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+
+            auto world = reader.read(worldBounds, status);
+            REQUIRE(world != nullptr);
+
+            Model::LayerNode* defaultLayer = world->defaultLayer();
+            REQUIRE(defaultLayer->childCount() == brushCount);
+
+            // the brush that could not be built is skipped and reported with its line number
+            const auto& errors = status.messages(LogLevel::Error);
+            REQUIRE(errors.size() == 1u);
+            CHECK(errors.front().find("(line " + std::to_string(lastBrushLine) + ")") != std::string::npos);
+            CHECK(errors.front().find("Skipping brush") != std::string::npos);
+        }
+
+        TEST_CASE("WorldReaderTest.parseManyBrushesWithSyntaxError", "[WorldReaderTest]") {
+            const auto brushCount = size_t(1000);
+            const auto lastFaceLine = 4u + 9u * (brushCount - 1u) + 7u;
+            const auto data = makeMapWithManyBrushes(brushCount, "( 0 0 0 ) x");
+            const vm::bbox3 worldBounds(8192.0 * 64.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+
+            try {
+                reader.read(worldBounds, status);
+                FAIL();
+            } catch (const ParserException& e) {
+                const auto expected = "At line " + std::to_string(lastFaceLine) + ", column 11:";
+                CHECK(std::string(e.what()).substr(0u, expected.size()) == expected);
+            }
+        }
     }
 }
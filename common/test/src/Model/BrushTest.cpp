@@ -27,6 +27,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushGeometry.h"
 #include "Model/BrushBuilder.h"
@@ -504,6 +505,35 @@ namespace TrenchBroom {
             CHECK(brush1.expand(worldBounds, -64, true).is_error());
         }
 
+        TEST_CASE("BrushTest.hasMixedContentFlags", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+            Brush brush = builder.createCube(64.0, "texture").value();
+            CHECK_FALSE(brush.hasMixedContentFlags());
+
+            const auto setContentFlags = [&](const size_t faceIndex, const int contentFlags) {
+                auto attributes = brush.face(faceIndex).attributes();
+                attributes.setSurfaceContents(contentFlags);
+                brush.face(faceIndex).setAttributes(attributes);
+            };
+
+            for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                setContentFlags(i, 1);
+            }
+            CHECK_FALSE(brush.hasMixedContentFlags());
+
+            setContentFlags(0u, 3);
+            CHECK(brush.hasMixedContentFlags());
+
+            const Brush copy = brush;
+            CHECK(copy.hasMixedContentFlags());
+
+            setContentFlags(0u, 1);
+            CHECK_FALSE(brush.hasMixedContentFlags());
+            CHECK(copy.hasMixedContentFlags());
+        }
+
         TEST_CASE("BrushTest.moveVertex", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
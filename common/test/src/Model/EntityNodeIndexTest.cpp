@@ -156,6 +156,68 @@ namespace TrenchBroom {
             delete entity2;
         }
 
+        TEST_CASE("EntityNodeIndexTest.batch", "[EntityNodeIndexTest]") {
+            EntityNodeIndex index;
+
+            EntityNode* entity1 = new EntityNode({
+                {"test", "somevalue"}
+            });
+
+            EntityNode* entity2 = new EntityNode({
+                {"test", "somevalue"}
+            });
+
+            index.addEntityNode(entity1);
+
+            index.beginBatch();
+            index.addEntityNode(entity2);
+            index.removeEntityNode(entity1);
+            index.addEntityNode(entity1);
+
+            CHECK_THAT(findExactExact(index, "test", "somevalue"), Catch::UnorderedEquals(std::vector<EntityNodeBase*>{ entity1, entity2 }));
+
+            index.beginBatch();
+            entity2->setEntity(Entity({
+                {"test", "somevalue"},
+                {"other", "someothervalue"}
+            }));
+            index.addProperty(entity2, "other", "someothervalue");
+            index.endBatch();
+
+            CHECK(findExactExact(index, "other", "someothervalue") == std::vector<EntityNodeBase*>{ entity2 });
+
+            entity1->setEntity(Entity());
+            index.removeProperty(entity1, "test", "somevalue");
+            index.endBatch();
+
+            CHECK(findExactExact(index, "test", "somevalue") == std::vector<EntityNodeBase*>{ entity2 });
+            CHECK_THAT(index.allKeys(), Catch::UnorderedEquals(std::vector<std::string>{ "test", "other" }));
+
+            delete entity1;
+            delete entity2;
+        }
+
+        TEST_CASE("EntityNodeIndexTest.applyPendingUpdates", "[EntityNodeIndexTest]") {
+            EntityNodeIndex index;
+
+            EntityNode* entity = new EntityNode({
+                {"test", "somevalue"}
+            });
+
+            index.beginBatch();
+            index.addEntityNode(entity);
+            CHECK(index.hasPendingUpdates());
+
+            index.applyPendingUpdates();
+            CHECK_FALSE(index.hasPendingUpdates());
+            CHECK(findExactExact(index, "test", "somevalue") == std::vector<EntityNodeBase*>{ entity });
+
+            index.endBatch();
+            CHECK_FALSE(index.hasPendingUpdates());
+
+            delete entity;
+        }
+
         TEST_CASE("EntityNodeIndexTest.addNumberedEntityProperty", "[EntityNodeIndexTest]") {
             EntityNodeIndex index;
 
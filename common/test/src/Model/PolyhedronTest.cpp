@@ -22,6 +22,7 @@
 #include "Model/Polyhedron_BrushGeometryPayload.h"
 #include "Model/Polyhedron_DefaultPayload.h"
 #include "Model/Polyhedron_Instantiation.h"
+#include "Model/Polyhedron_Pool.h"
 
 #include <vecmath/plane.h>
 #include <vecmath/scalar.h>
@@ -29,8 +30,10 @@
 #include <vecmath/vec_io.h>
 
 #include <iterator>
+#include <thread>
 #include <tuple>
 #include <set>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -77,6 +80,63 @@ namespace TrenchBroom {
             return !lhs.intersects(rhs) && !rhs.intersects(lhs);
         }
 
+        TEST_CASE("PolyhedronTest.poolReusesSlotsFreedOnOtherThreads", "[PolyhedronTest]") {
+            // use a slot size that no polyhedron element has so that this test has a pool of its own
+            using Pool = Polyhedron_Pool<136u, 8u>;
+            // a multiple of the slab size so that the allocating thread has no unused slots left in its cache
+            constexpr auto SlotCount = 4096u;
+
+            auto slots = std::vector<void*>{};
+            std::thread([&]() {
+                for (size_t i = 0u; i < SlotCount; ++i) {
+                    slots.push_back(Pool::allocate());
+                }
+            }).join();
+
+            std::thread([&]() {
+                for (auto* slot : slots) {
+                    Pool::deallocate(slot);
+                }
+            }).join();
+
+            // both threads have ended, so all slots must have been returned to the shared free list
+            const auto freedSlots = std::set<void*>(std::begin(slots), std::end(slots));
+            auto reusedSlots = std::vector<void*>{};
+            for (size_t i = 0u; i < SlotCount; ++i) {
+                reusedSlots.push_back(Pool::allocate());
+            }
+
+            for (auto* slot : reusedSlots) {
+                CHECK(freedSlots.count(slot) == 1u);
+                Pool::deallocate(slot);
+            }
+        }
+
+        TEST_CASE("PolyhedronTest.poolReleasesFreeSlabs", "[PolyhedronTest]") {
+            // use a slot size that no polyhedron element has so that this test has a pool of its own
+            using Pool = Polyhedron_Pool<152u, 8u>;
+            constexpr auto SlotCount = 4096u;
+
+            auto slots = std::vector<void*>{};
+            for (size_t i = 0u; i < SlotCount; ++i) {
+                slots.push_back(Pool::allocate());
+            }
+            auto* usedSlot = Pool::allocate();
+            REQUIRE(Pool::slabCount() > 1u);
+
+            for (auto* slot : slots) {
+                Pool::deallocate(slot);
+            }
+
+            // only the slab of the slot that is still in use is kept
+            Pool::releaseFreeSlabs();
+            CHECK(Pool::slabCount() == 1u);
+
+            Pool::deallocate(usedSlot);
+            Pool::releaseFreeSlabs();
+            CHECK(Pool::slabCount() == 0u);
+        }
+
         TEST_CASE("PolyhedronTest.initWith4Points", "[PolyhedronTest]") {
             const vm::vec3d p1( 0.0, 0.0, 8.0);
             const vm::vec3d p2( 8.0, 0.0, 0.0);
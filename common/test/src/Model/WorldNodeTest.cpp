@@ -17,14 +17,34 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/EmptyGroupIssueGenerator.h"
 #include "Model/Entity.h"
+#include "Model/EntityNode.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/Issue.h"
 #include "Model/MapFormat.h"
+#include "Model/PickResult.h"
 #include "Model/WorldNode.h"
 
+#include <kdl/result.h>
+
+#include <vecmath/approx.h>
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <limits>
+#include <memory>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -127,5 +147,204 @@ namespace TrenchBroom {
             layerNode->addChild(groupNode);
             CHECK(groupNode->persistentId() == 2u);
         }
+   }
+
+        TEST_CASE("WorldNodeTest.pick", "[WorldNodeTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
+
+            const auto builder = BrushBuilder{worldNode.mapFormat(), worldBounds};
+            auto* brushNode1 = new BrushNode{builder.createCuboid(vm::bbox3{vm::vec3{ 16, -16, -16}, vm::vec3{ 48, 16, 16}}, "texture").value()};
+            auto* brushNode2 = new BrushNode{builder.createCuboid(vm::bbox3{vm::vec3{ 64, -16, -16}, vm::vec3{ 96, 16, 16}}, "texture").value()};
+            auto* brushNode3 = new BrushNode{builder.createCuboid(vm::bbox3{vm::vec3{112, -16, -16}, vm::vec3{144, 16, 16}}, "texture").value()};
+
+            worldNode.defaultLayer()->addChild(brushNode3);
+            worldNode.defaultLayer()->addChild(brushNode1);
+            worldNode.defaultLayer()->addChild(brushNode2);
+
+            const auto editorContext = EditorContext{};
+            const auto ray = vm::ray3{vm::vec3::zero(), vm::vec3::pos_x()};
+
+            SECTION("Picking all hits") {
+                auto pickResult = PickResult::byDistance(editorContext);
+                worldNode.pick(ray, pickResult);
+
+                CHECK(pickResult.size() == 3u);
+                CHECK(pickResult.maxDistance() == std::numeric_limits<FloatType>::max());
+            }
+
+            SECTION("Picking the nearest hit") {
+                auto pickResult = PickResult::nearestByDistance(editorContext, std::make_unique<TypedHitFilter>(BrushNode::BrushHitType));
+                worldNode.pick(ray, pickResult);
+
+                REQUIRE(pickResult.size() == 1u);
+                CHECK(hitToFaceHandle(pickResult.all().front())->node() == brushNode1);
+                CHECK(pickResult.maxDistance() == vm::approx(16.0));
+            }
+        }
+
+        TEST_CASE("WorldNodeTest.nodeTreeBatch", "[WorldNodeTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
+
+            const auto builder = BrushBuilder{worldNode.mapFormat(), worldBounds};
+            auto* brushNode1 = new BrushNode{builder.createCuboid(vm::bbox3{vm::vec3{ 16, -16, -16}, vm::vec3{ 48, 16, 16}}, "texture").value()};
+            auto* brushNode2 = new BrushNode{builder.createCuboid(vm::bbox3{vm::vec3{ 64, -16, -16}, vm::vec3{ 96, 16, 16}}, "texture").value()};
+            worldNode.defaultLayer()->addChildren({brushNode1, brushNode2});
+
+            const auto movedBounds = vm::bbox3{vm::vec3{-48, -16, -16}, vm::vec3{-16, 16, 16}};
+
+            worldNode.beginNodeTreeBatch();
+            brushNode1->setBrush(builder.createCuboid(movedBounds, "texture").value());
+            brushNode2->setBrush(builder.createCuboid(movedBounds.translate(vm::vec3{0, 64, 0}), "texture").value());
+
+            SECTION("Queries during a batch see the new bounds") {
+                CHECK(worldNode.findNodesIntersecting(movedBounds) == std::vector<Node*>{brushNode1});
+                worldNode.endNodeTreeBatch();
+                CHECK(worldNode.findNodesIntersecting(movedBounds) == std::vector<Node*>{brushNode1});
+            }
+
+            SECTION("Nodes removed during a batch are not refitted") {
+                worldNode.defaultLayer()->removeChild(brushNode2);
+                worldNode.endNodeTreeBatch();
+                CHECK(worldNode.findNodesIntersecting(movedBounds) == std::vector<Node*>{brushNode1});
+                delete brushNode2;
+            }
+
+            CHECK(worldNode.findNodesIntersecting(vm::bbox3{vm::vec3{16, -16, -16}, vm::vec3{96, 16, 16}}).empty());
+        }
+
+        TEST_CASE("WorldNodeTest.validateIssues", "[WorldNodeTest]") {
+            auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
+            worldNode.registerIssueGenerator(new EmptyGroupIssueGenerator{});
+
+            auto* layerNode = worldNode.defaultLayer();
+            auto* groupNode = new GroupNode{Group{"group"}};
+            layerNode->addChild(groupNode);
+
+            auto changes = worldNode.validateIssues();
+            CHECK(changes.removedNodes.empty());
+            CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, groupNode}));
+            CHECK(groupNode->issues(worldNode.registeredIssueGenerators()).size() == 1u);
+
+            changes = worldNode.validateIssues();
+            CHECK(changes.removedNodes.empty());
+            CHECK(changes.validatedNodes.empty());
+
+            SECTION("Adding a node validates the node and its ancestors") {
+                auto* entityNode = new EntityNode{Entity{}};
+                groupNode->addChild(entityNode);
+
+                changes = worldNode.validateIssues();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, groupNode, entityNode}));
+                CHECK(groupNode->issues(worldNode.registeredIssueGenerators()).empty());
+            }
+
+            SECTION("Removing a node reports the node and its descendants") {
+                auto* entityNode = new EntityNode{Entity{}};
+                groupNode->addChild(entityNode);
+                worldNode.validateIssues();
+
+                layerNode->removeChild(groupNode);
+
+                changes = worldNode.validateIssues();
+                CHECK_THAT(changes.removedNodes, Catch::UnorderedEquals(std::vector<Node*>{groupNode, entityNode}));
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode}));
+
+                delete groupNode;
+            }
+
+            SECTION("Adding a removed node again doesn't report it as removed") {
+                layerNode->removeChild(groupNode);
+                layerNode->addChild(groupNode);
+
+                changes = worldNode.validateIssues();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, groupNode}));
+                CHECK(groupNode->issues(worldNode.registeredIssueGenerators()).size() == 1u);
+
+                layerNode->removeChild(groupNode);
+
+                changes = worldNode.validateIssues();
+                CHECK(changes.removedNodes == std::vector<Node*>{groupNode});
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode}));
+
+                delete groupNode;
+            }
+
+            SECTION("Removing a node that was added since the last validation doesn't report it") {
+                auto* entityNode = new EntityNode{Entity{}};
+                groupNode->addChild(entityNode);
+                groupNode->removeChild(entityNode);
+                delete entityNode;
+
+                changes = worldNode.validateIssues();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, groupNode}));
+            }
+
+            SECTION("Registering an issue generator validates all nodes") {
+                worldNode.registerIssueGenerator(new EmptyGroupIssueGenerator{});
+
+                changes = worldNode.validateIssues();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.validatedNodes, Catch::UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, groupNode}));
+                CHECK(groupNode->issues(worldNode.registeredIssueGenerators()).size() == 2u);
+            }
+        }
+
+        TEST_CASE("WorldNodeTest.takeEntityLinkChanges", "[WorldNodeTest]") {
+            auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
+            auto* layerNode = worldNode.defaultLayer();
+
+            auto* sourceNode = new EntityNode{Entity({{"target", "door"}})};
+            auto* targetNode = new EntityNode{Entity({{"targetname", "door"}})};
+            auto* otherNode = new EntityNode{Entity{}};
+            layerNode->addChildren({sourceNode, targetNode, otherNode});
+
+            auto changes = worldNode.takeEntityLinkChanges();
+            CHECK(changes.removedNodes.empty());
+            CHECK_THAT(changes.changedNodes, Catch::UnorderedEquals(std::vector<EntityNodeBase*>{sourceNode, targetNode, otherNode}));
+            CHECK(sourceNode->linkTargets() == std::vector<EntityNodeBase*>{targetNode});
+
+            changes = worldNode.takeEntityLinkChanges();
+            CHECK(changes.removedNodes.empty());
+            CHECK(changes.changedNodes.empty());
+
+            SECTION("Changing a property reports the linked nodes") {
+                targetNode->setEntity(Entity({{"targetname", "gate"}}));
+
+                changes = worldNode.takeEntityLinkChanges();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.changedNodes, Catch::UnorderedEquals(std::vector<EntityNodeBase*>{sourceNode, targetNode}));
+                CHECK(sourceNode->linkTargets().empty());
+            }
+
+            SECTION("Removing a node reports the node as removed") {
+                layerNode->removeChild(targetNode);
+
+                changes = worldNode.takeEntityLinkChanges();
+                CHECK(changes.removedNodes == std::vector<EntityNodeBase*>{targetNode});
+                CHECK(changes.changedNodes == std::vector<EntityNodeBase*>{sourceNode});
+
+                layerNode->addChild(targetNode);
+
+                changes = worldNode.takeEntityLinkChanges();
+                CHECK(changes.removedNodes.empty());
+                CHECK_THAT(changes.changedNodes, Catch::UnorderedEquals(std::vector<EntityNodeBase*>{sourceNode, targetNode}));
+            }
+
+            SECTION("Removing a node that was added since the changes were taken doesn't report it") {
+                auto* newNode = new EntityNode{Entity({{"targetname", "gate"}})};
+                layerNode->addChild(newNode);
+                layerNode->removeChild(newNode);
+                delete newNode;
+
+                changes = worldNode.takeEntityLinkChanges();
+                CHECK(changes.removedNodes.empty());
+                CHECK(changes.changedNodes.empty());
+            }
+        }
     }
 }
@@ -18,8 +18,11 @@
  */
 
 #include "Renderer/Camera.h"
+#include "Renderer/OrthographicCamera.h"
 #include "Renderer/PerspectiveCamera.h"
 
+#include <vecmath/bbox.h>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -65,5 +68,34 @@ namespace TrenchBroom {
             CHECK_FALSE(vm::is_nan(c.right()));
             CHECK_FALSE(vm::is_nan(c.up()));
         }
+
+        TEST_CASE("CameraTest.perspectiveIntersectsFrustum", "[CameraTest]") {
+            const auto c = PerspectiveCamera(90.0f, 1.0f, 8000.0f, Camera::Viewport(0, 0, 800, 600), vm::vec3f::zero(), vm::vec3f::pos_x(), vm::vec3f::pos_z());
+
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, -10, -10), vm::vec3f(110, 10, 10))));
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(-10, -10, -10), vm::vec3f(10, 10, 10))));
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, -1000, -10), vm::vec3f(110, 1000, 10))));
+
+            // behind the camera
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(-110, -10, -10), vm::vec3f(-100, 10, 10))));
+            // far to the left, to the right, above and below the camera
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, 500, -10), vm::vec3f(110, 600, 10))));
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, -600, -10), vm::vec3f(110, -500, 10))));
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, -10, 500), vm::vec3f(110, 10, 600))));
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(100, -10, -600), vm::vec3f(110, 10, -500))));
+        }
+
+        TEST_CASE("CameraTest.orthographicIntersectsFrustum", "[CameraTest]") {
+            // looking down, the viewport is 800 units wide and 600 units high
+            const auto c = OrthographicCamera(1.0f, 8000.0f, Camera::Viewport(0, 0, 800, 600), vm::vec3f(0, 0, 1000), vm::vec3f::neg_z(), vm::vec3f::pos_y());
+
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(-10, -10, -10), vm::vec3f(10, 10, 10))));
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(390, 290, -10), vm::vec3f(410, 310, 10))));
+            // the orthographic frustum is not bounded in the view direction
+            CHECK(c.intersectsFrustum(vm::bbox3f(vm::vec3f(-10, -10, 5000), vm::vec3f(10, 10, 5010))));
+
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(410, -10, -10), vm::vec3f(420, 10, 10))));
+            CHECK_FALSE(c.intersectsFrustum(vm::bbox3f(vm::vec3f(-10, 310, -10), vm::vec3f(10, 320, 10))));
+        }
     }
 }
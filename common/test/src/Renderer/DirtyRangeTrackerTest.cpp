@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Renderer/BrushRendererArrays.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using Range = DirtyRangeTracker::Range;
+
+        TEST_CASE("DirtyRangeTrackerTest.constructor", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100);
+            CHECK(t.capacity() == 100u);
+            CHECK(t.clean());
+            CHECK(t.ranges() == std::vector<Range>{});
+            CHECK(t.dirtySize() == 0u);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirty", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(1000, 10);
+
+            t.markDirty(100, 10);
+            CHECK_FALSE(t.clean());
+            CHECK(t.ranges() == std::vector<Range>{{100, 10}});
+
+            // far away ranges are kept separate
+            t.markDirty(500, 20);
+            t.markDirty(0, 5);
+            CHECK(t.ranges() == std::vector<Range>{{0, 5}, {100, 10}, {500, 20}});
+            CHECK(t.dirtySize() == 35u);
+
+            // empty ranges are ignored
+            t.markDirty(300, 0);
+            CHECK(t.ranges() == std::vector<Range>{{0, 5}, {100, 10}, {500, 20}});
+
+            // nearby ranges are coalesced
+            t.markDirty(115, 5);
+            CHECK(t.ranges() == std::vector<Range>{{0, 5}, {100, 20}, {500, 20}});
+            t.markDirty(490, 5);
+            CHECK(t.ranges() == std::vector<Range>{{0, 5}, {100, 20}, {490, 30}});
+
+            // a range can join several ranges
+            t.markDirty(10, 485);
+            CHECK(t.ranges() == std::vector<Range>{{0, 520}});
+
+            t.clear();
+            CHECK(t.clean());
+            CHECK(t.capacity() == 1000u);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyWithoutMergeDistance", "[DirtyRangeTrackerTest]") {
+            // VboHolder uses no merge distance while its snapshot is dropped, because the elements between the
+            // written ranges are not valid then
+            DirtyRangeTracker t(1000);
+            t.setMergeDistance(0);
+            CHECK(t.mergeDistance() == 0u);
+
+            t.markDirty(100, 10);
+            t.markDirty(130, 10);
+            CHECK(t.ranges() == std::vector<Range>{{100, 10}, {130, 10}});
+            CHECK(t.dirtySize() == 20u);
+
+            // adjacent and overlapping ranges are still coalesced
+            t.markDirty(110, 5);
+            t.markDirty(135, 10);
+            CHECK(t.ranges() == std::vector<Range>{{100, 15}, {130, 15}});
+
+            // once the snapshot is complete again, nearby ranges are coalesced
+            t.setMergeDistance(DirtyRangeTracker::DefaultMergeDistance);
+            t.markDirty(200, 10);
+            CHECK(t.ranges() == std::vector<Range>{{100, 15}, {130, 80}});
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.expand", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100, 10);
+            t.markDirty(0, 10);
+
+            t.expand(200);
+            CHECK(t.capacity() == 200u);
+            CHECK(t.ranges() == std::vector<Range>{{0, 10}, {100, 100}});
+
+            CHECK_THROWS_AS(t.expand(200), std::invalid_argument);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyOutOfBounds", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100);
+            CHECK_THROWS_AS(t.markDirty(90, 11), std::invalid_argument);
+            CHECK_NOTHROW(t.markDirty(90, 10));
+        }
+    }
+}
@@ -66,6 +66,36 @@ namespace TrenchBroom {
             CHECK(document->selectedNodes().nodeCount() == 1u);
         }
 
+        TEST_CASE_METHOD(SelectionTest, "SelectionTest.selectTouchingGroupBetweenMembers") {
+            document->selectAllNodes();
+            document->deleteObjects();
+            assert(document->selectedNodes().nodeCount() == 0);
+
+            Model::LayerNode* layer = new Model::LayerNode(Model::Layer("Layer 1"));
+            document->addNode(layer, document->world());
+
+            Model::GroupNode* group = new Model::GroupNode(Model::Group("Unnamed"));
+            document->addNode(group, layer);
+
+            Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
+            Model::BrushNode* brush1 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(-64.0, -32.0, -32.0), vm::vec3(-32.0, +32.0, +32.0)), "texture").value());
+            Model::BrushNode* brush2 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(+32.0, -32.0, -32.0), vm::vec3(+64.0, +32.0, +32.0)), "texture").value());
+            document->addNode(brush1, group);
+            document->addNode(brush2, group);
+
+            // the selection brush only touches the group's bounds, but none of its members
+            const vm::bbox3 selectionBounds(vm::vec3(-16.0, -16.0, -48.0),
+                                        vm::vec3(+16.0, +16.0, +48.0));
+
+            Model::BrushNode* selectionBrush = new Model::BrushNode(builder.createCuboid(selectionBounds, "texture").value());
+            document->addNode(selectionBrush, layer);
+
+            document->select(selectionBrush);
+            document->selectTouching(true);
+
+            CHECK(document->selectedNodes().nodes() == std::vector<Model::Node*>{group});
+        }
+
         TEST_CASE_METHOD(SelectionTest, "SelectionTest.selectInsideWithGroup") {
             document->selectAllNodes();
             document->deleteObjects();
@@ -23,6 +23,7 @@
 
 #include <cassert>
 #include <exception>
+#include <iterator>
 #include <set>
 #include <string>
 #include <string_view>
@@ -252,15 +253,18 @@ namespace kdl {
             m_key(std::move(key)) {}
 
             /**
-             * Inserts the given value into this node's subtree. If this node's key is empty, then it is the root node.
+             * Inserts the given values into this node's subtree. If this node's key is empty, then it is the root node.
              *
              * Precondition: Unless this node is the root node, the given key must share a non-empty prefix with this
              * node's key.
              *
+             * @tparam I the type of the value iterators
              * @param key the key to insert
-             * @param value the value to insert
+             * @param first the beginning of the range of values to insert
+             * @param last the end of the range of values to insert
              */
-            void insert(const std::string_view key, const V& value) const {
+            template <typename I>
+            void insert(const std::string_view key, I first, I last) const {
                 /*
                  Possible cases for insertion:
                   index: 01234567 |   | #m_key: 6
@@ -292,11 +296,11 @@ namespace kdl {
                         // the remainder of key and insert there
                         const auto remainder = key.substr(mismatch);
                         const auto& child = *m_children.insert(node(std::string(remainder))).first;
-                        child.insert(remainder, value);
+                        child.insert(remainder, first, last);
                     } else { // mismatch == m_key.size()
                         // case 2: key and m_key have a common prefix, split this node and insert again
                         split_node(mismatch);
-                        insert(key, value);
+                        insert(key, first, last);
                     }
                 } else if (mismatch == key.size()) {
                     // cases 3, 4: key is a prefix of m_key, or key == m_key
@@ -304,19 +308,24 @@ namespace kdl {
                         // case 3: key is a prefix of m_key, split this node
                         split_node(mismatch);
                     }
-                    insert_value(value);
+                    for (; first != last; ++first) {
+                        insert_value(*first);
+                    }
                 }
             }
 
             /**
-             * Removes the given value from this node's subtree.
+             * Removes the given values from this node's subtree.
              *
+             * @tparam I the type of the value iterators
              * @param key the key to remove
-             * @param value the value to remove
-             * @return true if the given key and value were removed from this node's subtree
+             * @param first the beginning of the range of values to remove
+             * @param last the end of the range of values to remove
+             * @return the number of values that were removed from this node's subtree
              */
-            bool remove(const std::string_view key, const V& value) const {
-                bool result = false;
+            template <typename I>
+            std::size_t remove(const std::string_view key, I first, I last) const {
+                std::size_t result = 0u;
 
                 const std::size_t mismatch = kdl::cs::str_mismatch(key, m_key);
                 if (m_key.size() <= key.length() && mismatch == m_key.length()) {
@@ -327,13 +336,17 @@ namespace kdl {
                         const auto it = m_children.find(remainder);
                         assert(it != std::end(m_children));
 
-                        result = it->remove(remainder, value);
+                        result = it->remove(remainder, first, last);
                         if (!it->m_key.empty() && it->m_values.empty() && it->m_children.empty()) {
                             m_children.erase(it);
                         }
                     } else {
                         // m_key == key
-                        result = remove_value(value);
+                        for (; first != last; ++first) {
+                            if (remove_value(*first)) {
+                                ++result;
+                            }
+                        }
                     }
 
                     if (!m_key.empty() && m_values.empty() && m_children.size() == 1u) {
@@ -659,7 +672,23 @@ namespace kdl {
          * @param value the value to insert
          */
         void insert(const std::string_view key, const V& value) {
-            m_root.insert(key, value);
+            m_root.insert(key, &value, std::next(&value));
+        }
+
+        /**
+         * Inserts the given values under the given key. This is faster than inserting each value on its own because
+         * the node for the given key is only searched once.
+         *
+         * @tparam I the type of the value iterators
+         * @param key the key to insert
+         * @param first the beginning of the range of values to insert
+         * @param last the end of the range of values to insert
+         */
+        template <typename I>
+        void insert(const std::string_view key, I first, I last) {
+            if (first != last) {
+                m_root.insert(key, first, last);
+            }
         }
 
         /**
@@ -670,7 +699,22 @@ namespace kdl {
          * @return `true` if the given value was found under the given key, and `false` otherwise
          */
         bool remove(const std::string_view key, const V& value) {
-            return m_root.remove(key, value);
+            return m_root.remove(key, &value, std::next(&value)) > 0u;
+        }
+
+        /**
+         * Removes the given values using the given key. This is faster than removing each value on its own because
+         * the node for the given key is only searched once.
+         *
+         * @tparam I the type of the value iterators
+         * @param key the key to remove
+         * @param first the beginning of the range of values to remove
+         * @param last the end of the range of values to remove
+         * @return the number of values that were found under the given key and removed
+         */
+        template <typename I>
+        std::size_t remove(const std::string_view key, I first, I last) {
+            return first != last ? m_root.remove(key, first, last) : 0u;
         }
 
         /**
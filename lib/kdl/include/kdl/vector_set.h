@@ -170,7 +170,7 @@ namespace kdl {
          * @return a reference to this set
          */
         vector_set& operator=(std::vector<typename base::value_type> values) {
-            m_data = values;
+            m_data = std::move(values);
             detail::sort_unique(m_data, m_cmp);
             return *this;
         }
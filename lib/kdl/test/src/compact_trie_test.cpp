@@ -19,6 +19,8 @@
 #include "kdl/vector_utils.h"
 
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -104,6 +106,38 @@ namespace kdl {
         assertMatches(index, "*", {});
     }
 
+    TEST_CASE("compact_trie_test.insert_range", "[compact_trie_test]") {
+        const std::vector<std::string> values({ "value", "value2", "value" });
+
+        test_index index;
+        index.insert("key", "value3");
+        index.insert("key2", std::begin(values), std::end(values));
+        index.insert("ke", std::begin(values), std::next(std::begin(values)));
+        index.insert("test", std::end(values), std::end(values));
+
+        assertMatches(index, "key2", { "value", "value2", "value" });
+        assertMatches(index, "key", { "value3" });
+        assertMatches(index, "ke", { "value" });
+        assertMatches(index, "test*", {});
+        assertMatches(index, "*", { "value", "value", "value", "value2", "value3" });
+    }
+
+    TEST_CASE("compact_trie_test.remove_range", "[compact_trie_test]") {
+        const std::vector<std::string> values({ "value", "value2", "value" });
+
+        test_index index;
+        index.insert("andrew", std::begin(values), std::end(values));
+        index.insert("andreas", "value");
+
+        const std::vector<std::string> toRemove({ "value", "value3", "value2" });
+        CHECK(index.remove("andrew", std::begin(toRemove), std::end(toRemove)) == 2u);
+        assertMatches(index, "andrew", { "value" });
+        CHECK(index.remove("andrew", std::begin(toRemove), std::end(toRemove)) == 1u);
+        assertMatches(index, "andrew", {});
+        CHECK(index.remove("andreas", std::end(toRemove), std::end(toRemove)) == 0u);
+        assertMatches(index, "andre*", { "value" });
+    }
+
     TEST_CASE("compact_trie_test.find_matches_with_exact_pattern", "[compact_trie_test]") {
         test_index index;
         index.insert("key", "value");